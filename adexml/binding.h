@@ -0,0 +1,373 @@
+//=============================================================================
+//	FILE:					binding.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Declarative binding of record elements to C++ structures.
+//
+//			struct Point { int x; double y; std::u8string label; };
+//
+//			static constexpr auto point_binding = adexml::bind::record<Point>(u8"point",
+//				adexml::bind::attribute(u8"x", &Point::x),
+//				adexml::bind::attribute(u8"y", &Point::y),
+//				adexml::bind::element(u8"label", &Point::label) );
+//
+//			adexml::bind::Reader reader(point_binding, [](Point && p) -> std::error_code {...});
+//			adexml::Parser parser(reader.callback());
+//			reader.attach(parser);
+//
+//		Field names are dispatched through a perfect hash table that is built
+//		when the binding is constant evaluated. Bound attributes are converted
+//		directly from the parser's attribute buffer through the parser's
+//		attribute hook and never copied into Element::attributes. Bound child
+//		elements and record text are converted from Element::content in place.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_BINDING_H
+#define GUARD_ADE_XML_BINDING_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include "convert.h"
+#include "xml_parser.h"
+
+namespace adexml::bind
+{
+
+enum class FieldKind : std::uint8_t
+{
+	ATTRIBUTE,	// Attribute of the record element
+	ELEMENT,		// Text content of a direct child element
+	TEXT				// Text content of the record element itself
+};
+
+template<typename T, typename M>
+struct Field
+{
+	using object_type = T;
+
+	FieldKind						kind;
+	std::u8string_view	name;
+	M T::*							member;
+};
+
+template<typename T, typename M>	constexpr Field<T,M>	attribute(std::u8string_view name, M T::* member)	{return {FieldKind::ATTRIBUTE, name, member};}
+template<typename T, typename M>	constexpr Field<T,M>	element(std::u8string_view name, M T::* member)		{return {FieldKind::ELEMENT, name, member};}
+template<typename T, typename M>	constexpr Field<T,M>	text(M T::* member)																{return {FieldKind::TEXT, {}, member};}
+
+//=============================================================================
+//
+//	PERFECT HASH
+//
+//	FNV-1a over the field kind and name picks a bucket, and each bucket has a
+//	displacement, chosen at compile time, that moves its fields into free
+//	slots of a power of two table. Buckets are placed largest first, so each
+//	search only has to fit a couple of fields around those already placed
+//	and stays short however many fields the record has.
+//
+//=============================================================================
+
+constexpr std::uint32_t
+field_hash(FieldKind kind, std::u8string_view name, std::uint32_t seed)
+{
+	std::uint32_t hash = 2166136261U ^ seed;
+	hash = (hash ^ static_cast<std::uint8_t>(kind)) * 16777619U;
+	for(auto ch : name)
+		hash = (hash ^ static_cast<std::uint8_t>(ch)) * 16777619U;
+	return hash ^ (hash >> 15);
+}
+
+constexpr std::uint32_t
+displace_hash(std::uint32_t hash, std::uint32_t displacement)
+{
+	hash ^= displacement * 0x9E3779B9U;
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6BU;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35U;
+	return hash ^ (hash >> 16);
+}
+
+//-----------------------------------------------------------------------------
+//	Not constexpr, so reaching one of these while a binding is constant
+//	evaluated stops the compile with the function's name in the error. A
+//	binding built at run time throws instead.
+//-----------------------------------------------------------------------------
+[[noreturn]] inline void	error_duplicate_field_in_record()				{throw std::logic_error("adexml::bind: two fields of a record have the same kind and name");}
+[[noreturn]] inline void	error_no_perfect_hash_for_record()			{throw std::logic_error("adexml::bind: no perfect hash found for the record's fields");}
+
+template<std::size_t N>
+struct PerfectHash
+{
+	static constexpr std::size_t		TABLE_SIZE 				= std::bit_ceil(N * 2 + 1);
+	static constexpr std::size_t		BUCKETS 					= std::bit_ceil(N / 2 + 1);
+	static constexpr std::uint8_t		EMPTY 						= 0xFF;
+	static constexpr std::uint32_t	MAX_DISPLACEMENT 	= 0xFFFF;
+	static_assert(N < EMPTY, "adexml::bind: too many fields in one record");
+
+	std::array<std::uint8_t, TABLE_SIZE>		slots{};
+	std::array<std::uint16_t, BUCKETS>			displacements{};
+
+	constexpr
+	PerfectHash(const std::array<FieldKind, N> & kinds, const std::array<std::u8string_view, N> & names)
+	{
+		// Two fields with the same kind and name collide under every displacement.
+		for(std::size_t i = 0; i < N; ++i)
+			for(std::size_t j = i + 1; j < N; ++j)
+				if((kinds[i] == kinds[j]) && (names[i] == names[j]))
+					error_duplicate_field_in_record();
+
+		std::array<std::uint32_t, N>				hashes{};
+		std::array<std::size_t, BUCKETS>		sizes{};
+		for(std::size_t i = 0; i < N; ++i)
+		{
+			hashes[i] = field_hash(kinds[i], names[i], 0);
+			++sizes[hashes[i] & (BUCKETS - 1)];
+		}
+
+		slots.fill(EMPTY);
+		for(;;)
+		{
+			std::size_t bucket = 0;
+			for(std::size_t b = 1; b < BUCKETS; ++b)
+				if(sizes[b] > sizes[bucket])
+					bucket = b;
+			if(sizes[bucket] == 0)
+				break;
+			sizes[bucket] = 0;
+
+			for(std::uint32_t displacement = 0; ; ++displacement)
+			{
+				if(displacement > MAX_DISPLACEMENT)
+					error_no_perfect_hash_for_record();
+
+				bool b_placed = true;
+				for(std::size_t i = 0; (i < N) && b_placed; ++i)
+					if((hashes[i] & (BUCKETS - 1)) == bucket)
+					{
+						auto & slot = slots[displace_hash(hashes[i], displacement) & (TABLE_SIZE - 1)];
+						b_placed 		= (slot == EMPTY);
+						if(b_placed)
+							slot = static_cast<std::uint8_t>(i);
+					}
+
+				if(b_placed)
+				{
+					displacements[bucket] = static_cast<std::uint16_t>(displacement);
+					break;
+				}
+
+				// Take back the fields of this bucket that were placed.
+				for(std::size_t i = 0; i < N; ++i)
+					if((hashes[i] & (BUCKETS - 1)) == bucket)
+					{
+						auto & slot = slots[displace_hash(hashes[i], displacement) & (TABLE_SIZE - 1)];
+						if(slot == i)
+							slot = EMPTY;
+					}
+			}
+		}
+	}
+
+	constexpr std::uint8_t
+	find(FieldKind kind, std::u8string_view name) const
+	{
+		auto hash = field_hash(kind, name, 0);
+		return slots[displace_hash(hash, displacements[hash & (BUCKETS - 1)]) & (TABLE_SIZE - 1)];
+	}
+};
+
+//=============================================================================
+//
+//	RECORD
+//
+//=============================================================================
+
+template<typename T, typename... Fields>
+class Record
+{
+public:
+	using object_type = T;
+	static constexpr std::size_t	FIELD_COUNT = sizeof...(Fields);
+
+private:
+	std::u8string_view														m_name;
+	std::tuple<Fields...>													m_fields;
+	std::array<FieldKind, FIELD_COUNT>						m_kinds;
+	std::array<std::u8string_view, FIELD_COUNT>		m_names;
+	PerfectHash<FIELD_COUNT>											m_hash;
+
+public:
+	constexpr
+	Record(std::u8string_view name, Fields... fields)
+		: m_name(name)
+		, m_fields(fields...)
+		, m_kinds{fields.kind...}
+		, m_names{fields.name...}
+		, m_hash(m_kinds, m_names)
+	{}
+
+	constexpr std::u8string_view	name() const	{return m_name;}
+
+	//---------------------------------------------------------------------------
+	//	Returns std::nullopt when the record has no such field.
+	//---------------------------------------------------------------------------
+	std::optional<std::error_code>
+	assign(T & object, FieldKind kind, std::u8string_view name, std::u8string_view value) const
+	{
+		auto index = m_hash.find(kind, name);
+		if((index == PerfectHash<FIELD_COUNT>::EMPTY) || (m_kinds[index] != kind) || (m_names[index] != name))
+			return std::nullopt;
+		return assign(object, index, value, std::index_sequence_for<Fields...>{});
+	}
+
+private:
+	template<std::size_t... I>
+	std::error_code
+	assign(T & object, std::size_t index, std::u8string_view value, std::index_sequence<I...>) const
+	{
+		std::error_code ec;
+		(void)((index == I ? (ec = parse_value(value, object.*(std::get<I>(m_fields).member)), true) : false) || ...);
+		return ec;
+	}
+};
+
+template<typename T, typename... Fields>
+constexpr Record<T, Fields...>
+record(std::u8string_view name, Fields... fields)
+{
+	static_assert((std::is_same_v<typename Fields::object_type, T> && ...), "adexml::bind: field does not belong to the record type");
+	return Record<T, Fields...>(name, fields...);
+}
+
+//=============================================================================
+//
+//	READER
+//
+//	Drives a Record from Parser events. Each completed object is passed to
+//	the sink. A record element nested inside another record is not bound.
+//
+//=============================================================================
+
+template<typename R>
+class Reader
+{
+public:
+	using object_type 	= typename R::object_type;
+	using Sink 					= std::function<std::error_code (object_type && object)>;
+
+private:
+	const R &										m_record;
+	Sink												m_sink;
+	std::optional<object_type>	m_object;
+	std::size_t									m_depth = 0;
+
+public:
+	Reader(const R & record, Sink sink) : m_record(record), m_sink(std::move(sink)) {}
+
+	//---------------------------------------------------------------------------
+	//	attach() installs both the event callback and the attribute hook. The
+	//	reader must outlive the parser.
+	//---------------------------------------------------------------------------
+	void
+	attach(Parser & parser)
+	{
+		parser.set_callback(callback());
+		parser.set_attribute_hook([this](auto element_name, auto depth, auto name, auto value) {return on_attribute(element_name, depth, name, value);});
+	}
+
+	Parser::Callback	callback()	{return [this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);};}
+
+	std::expected<bool, std::error_code>
+	on_attribute(std::u8string_view element_name, std::size_t depth, std::u8string_view name, std::u8string_view value)
+	{
+		if(!m_object && (element_name == m_record.name()))
+			begin(depth);
+
+		if(!m_object || (depth != m_depth))
+			return false;
+
+		auto result = m_record.assign(*m_object, FieldKind::ATTRIBUTE, name, value);
+		if(!result)
+			return false;
+		if(*result)
+			return std::unexpected(*result);
+		return true;
+	}
+
+	std::error_code
+	on_event(Parser::Action action, const String &, const ElementStack & element_stack)
+	{
+		if(element_stack.empty())
+			return {};
+
+		const auto & 	element = element_stack.back();
+		const auto		depth 	= element_stack.size();
+
+		switch(action)
+		{
+			case Parser::ACTION_START_ELEMENT :
+				if(!m_object && (element.name == m_record.name()))
+					begin(depth);
+				if(element.b_closed)
+					return on_end(element, depth);
+				break;
+
+			case Parser::ACTION_END_ELEMENT :
+				return on_end(element, depth);
+
+			default :
+				break;
+		}
+		return {};
+	}
+
+private:
+	void
+	begin(std::size_t depth)
+	{
+		m_object.emplace();
+		m_depth = depth;
+	}
+
+	std::error_code
+	on_end(const Element & element, std::size_t depth)
+	{
+		if(!m_object)
+			return {};
+
+		if(depth == m_depth + 1)
+		{
+			if(auto result = m_record.assign(*m_object, FieldKind::ELEMENT, element.name, element.content); result && *result)
+				return *result;
+		}
+		else if(depth == m_depth)
+		{
+			if(auto result = m_record.assign(*m_object, FieldKind::TEXT, {}, element.content); result && *result)
+				return *result;
+
+			auto object = std::move(*m_object);
+			m_object.reset();
+			if(m_sink)
+				return m_sink(std::move(object));
+		}
+		return {};
+	}
+};
+
+} // namespace adexml::bind
+
+#endif // ! defined GUARD_ADE_XML_BINDING_H
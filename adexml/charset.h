@@ -0,0 +1,85 @@
+//=============================================================================
+//	FILE:					charset.h
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Single-byte character sets, each as a table from byte to Unicode code
+//		point. All of them agree with ASCII below 0x80.
+//
+//		Windows-1252 leaves 0x81, 0x8D, 0x8F, 0x90 and 0x9D undefined; like
+//		web browsers these map to the C1 control with the same value.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_CHARSET_H
+#define GUARD_ADE_XML_CHARSET_H
+
+#include <array>
+#include <cstdint>
+
+namespace adexml::charset
+{
+
+using Table = std::array<char32_t, 256>;
+
+constexpr Table
+make_iso_8859_1()
+{
+	Table table{};
+	for(std::uint32_t byte = 0; byte < 256; ++byte)
+		table[byte] = byte;
+	return table;
+}
+
+//-----------------------------------------------------------------------------
+//	ISO-8859-15 (Latin-9) replaces eight Latin-1 symbols, adding the euro sign
+//	and the French and Finnish letters missing from Latin-1.
+//-----------------------------------------------------------------------------
+constexpr Table
+make_iso_8859_15()
+{
+	Table table = make_iso_8859_1();
+	table[0xA4] = 0x20AC;
+	table[0xA6] = 0x0160;
+	table[0xA8] = 0x0161;
+	table[0xB4] = 0x017D;
+	table[0xB8] = 0x017E;
+	table[0xBC] = 0x0152;
+	table[0xBD] = 0x0153;
+	table[0xBE] = 0x0178;
+	return table;
+}
+
+//-----------------------------------------------------------------------------
+//	Windows-1252 is Latin-1 with printable characters in place of most of the
+//	C1 controls at 0x80-0x9F.
+//-----------------------------------------------------------------------------
+constexpr Table
+make_windows_1252()
+{
+	constexpr char32_t C1[32] =
+	{
+		0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+		0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+		0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+		0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+	};
+
+	Table table = make_iso_8859_1();
+	for(std::uint32_t byte = 0; byte < 32; ++byte)
+		table[0x80 + byte] = C1[byte];
+	return table;
+}
+
+inline constexpr Table	ISO_8859_1 		= make_iso_8859_1();
+inline constexpr Table	ISO_8859_15 	= make_iso_8859_15();
+inline constexpr Table	WINDOWS_1252 	= make_windows_1252();
+
+} // namespace adexml::charset
+
+#endif // ! defined GUARD_ADE_XML_CHARSET_H
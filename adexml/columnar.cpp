@@ -0,0 +1,391 @@
+//=============================================================================
+//	FILE:					columnar.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <array>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include "columnar.h"
+#include "convert.h"
+
+namespace adexml
+{
+
+//=============================================================================
+//
+//	COLUMN
+//
+//=============================================================================
+
+Column::Column(std::u8string name, ColumnType type)
+	: m_name(std::move(name))
+	, m_type(type)
+{
+	if(m_type == ColumnType::UTF8)
+		m_offsets.push_back(0);
+}
+
+void
+Column::push_validity(bool b_valid)
+{
+	if((m_length & 7) == 0)
+	{
+		m_validity.push_back(0);
+		if(m_type == ColumnType::BOOL)
+			m_bits.push_back(0);
+	}
+	if(b_valid)
+		m_validity.back() |= static_cast<std::uint8_t>(1U << (m_length & 7));
+	else
+		++m_null_count;
+}
+
+std::error_code
+Column::append(std::u8string_view text)
+{
+	switch(m_type)
+	{
+		case ColumnType::INT64 :
+		{
+			std::int64_t value = 0;
+			if(auto ec = parse_value(text, value))
+				return ec;
+			m_int64.push_back(value);
+			break;
+		}
+
+		case ColumnType::FLOAT64 :
+		{
+			double value = 0.0;
+			if(auto ec = parse_value(text, value))
+				return ec;
+			m_float64.push_back(value);
+			break;
+		}
+
+		case ColumnType::BOOL :
+		{
+			bool value = false;
+			if(auto ec = parse_value(text, value))
+				return ec;
+			push_validity(true);
+			if(value)
+				m_bits.back() |= static_cast<std::uint8_t>(1U << (m_length & 7));
+			++m_length;
+			return {};
+		}
+
+		case ColumnType::UTF8 :
+			if(m_bytes.size() + text.size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+				return adexml::Error::VALUE_OUT_OF_RANGE;
+			m_bytes.insert(m_bytes.end(), text.begin(), text.end());
+			m_offsets.push_back(static_cast<std::int32_t>(m_bytes.size()));
+			break;
+	}
+
+	push_validity(true);
+	++m_length;
+	return {};
+}
+
+void
+Column::append_null()
+{
+	push_validity(false);
+	switch(m_type)
+	{
+		case ColumnType::INT64 :		m_int64.push_back(0); break;
+		case ColumnType::FLOAT64 :	m_float64.push_back(0.0); break;
+		case ColumnType::BOOL :			break;
+		case ColumnType::UTF8 :			m_offsets.push_back(m_offsets.back()); break;
+	}
+	++m_length;
+}
+
+const char *
+Column::arrow_format() const
+{
+	switch(m_type)
+	{
+		case ColumnType::INT64 :		return "l";
+		case ColumnType::FLOAT64 :	return "g";
+		case ColumnType::BOOL :			return "b";
+		case ColumnType::UTF8 :			return "u";
+	}
+	return "n";
+}
+
+std::size_t
+Column::arrow_buffers(const void ** buffers) const
+{
+	// Arrow expects non-null data buffers even for empty arrays.
+	alignas(64) static const std::uint64_t empty[1] = {};
+
+	auto non_null = [](const void * ptr) -> const void * {return ptr ? ptr : empty;};
+
+	buffers[0] = m_null_count ? m_validity.data() : nullptr;
+	switch(m_type)
+	{
+		case ColumnType::INT64 :		buffers[1] = non_null(m_int64.data());		return 2;
+		case ColumnType::FLOAT64 :	buffers[1] = non_null(m_float64.data());	return 2;
+		case ColumnType::BOOL :			buffers[1] = non_null(m_bits.data());			return 2;
+		case ColumnType::UTF8 :			buffers[1] = m_offsets.data();
+																buffers[2] = non_null(m_bytes.data());		return 3;
+	}
+	return 1;
+}
+
+//=============================================================================
+//
+//	ARROW EXPORT
+//
+//	Every exported ArrowArray and ArrowSchema holds a reference to one shared
+//	block that owns the column buffers, so children that a consumer moves out
+//	of the struct remain valid after the parent is released.
+//
+//=============================================================================
+
+namespace
+{
+
+struct ArrowExport
+{
+	ColumnTable															table;
+	std::vector<std::string>								names;
+	std::vector<std::array<const void *,3>>	buffers;
+	const void *														struct_buffers[1] = {nullptr};
+	std::vector<ArrowArray>									arrays;
+	std::vector<ArrowArray *>								array_ptrs;
+	std::vector<ArrowSchema>								schemas;
+	std::vector<ArrowSchema *>							schema_ptrs;
+};
+
+using ArrowExportRef = std::shared_ptr<ArrowExport>;
+
+void
+release_array(ArrowArray * array)
+{
+	for(int64_t i = 0; i < array->n_children; ++i)
+		if(array->children[i]->release)
+			array->children[i]->release(array->children[i]);
+	delete static_cast<ArrowExportRef *>(array->private_data);
+	array->release = nullptr;
+}
+
+void
+release_schema(ArrowSchema * schema)
+{
+	for(int64_t i = 0; i < schema->n_children; ++i)
+		if(schema->children[i]->release)
+			schema->children[i]->release(schema->children[i]);
+	delete static_cast<ArrowExportRef *>(schema->private_data);
+	schema->release = nullptr;
+}
+
+} // namespace
+
+void
+export_to_arrow(ColumnTable && table, ArrowArray * out_array, ArrowSchema * out_schema)
+{
+	auto block 				= std::make_shared<ArrowExport>();
+	block->table 			= std::move(table);
+	const auto count 	= block->table.columns.size();
+
+	block->names.reserve(count);
+	block->buffers.resize(count);
+	block->arrays.resize(count);
+	block->schemas.resize(count);
+
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		const auto & column = block->table.columns[i];
+		block->names.emplace_back(column.name().begin(), column.name().end());
+
+		auto & array 				= block->arrays[i];
+		array								= {};
+		array.length 				= static_cast<int64_t>(column.size());
+		array.null_count		= static_cast<int64_t>(column.null_count());
+		array.n_buffers			= static_cast<int64_t>(column.arrow_buffers(block->buffers[i].data()));
+		array.buffers				= block->buffers[i].data();
+		array.release				= release_array;
+		array.private_data	= new ArrowExportRef(block);
+
+		auto & schema 			= block->schemas[i];
+		schema							= {};
+		schema.format				= column.arrow_format();
+		schema.name					= block->names.back().c_str();
+		schema.flags				= ARROW_FLAG_NULLABLE;
+		schema.release			= release_schema;
+		schema.private_data	= new ArrowExportRef(block);
+	}
+
+	for(auto & array : block->arrays)
+		block->array_ptrs.push_back(&array);
+	for(auto & schema : block->schemas)
+		block->schema_ptrs.push_back(&schema);
+
+	*out_array 							= {};
+	out_array->length 			= static_cast<int64_t>(block->table.rows);
+	out_array->n_buffers		= 1;
+	out_array->n_children		= static_cast<int64_t>(count);
+	out_array->buffers			= block->struct_buffers;
+	out_array->children			= block->array_ptrs.data();
+	out_array->release			= release_array;
+	out_array->private_data	= new ArrowExportRef(block);
+
+	*out_schema 							= {};
+	out_schema->format				= "+s";
+	out_schema->name					= "";
+	out_schema->n_children		= static_cast<int64_t>(count);
+	out_schema->children			= block->schema_ptrs.data();
+	out_schema->release				= release_schema;
+	out_schema->private_data	= new ArrowExportRef(std::move(block));
+}
+
+//=============================================================================
+//
+//	COLUMN EXTRACTOR
+//
+//=============================================================================
+
+ColumnExtractor::ColumnExtractor(std::u8string_view record_path, const std::vector<ColumnSpec> & schema)
+{
+	while(record_path.starts_with(u8"/"))
+		record_path.remove_prefix(1);
+	m_record_path = record_path;
+
+	for(std::size_t i = 0; i < schema.size(); ++i)
+	{
+		const auto &				spec = schema[i];
+		std::u8string_view	path = spec.path;
+		std::u8string				element_path = m_record_path;
+		std::u8string				attribute;
+
+		auto split = path.rfind(u8'@');
+		if(split != std::u8string_view::npos)
+		{
+			attribute = path.substr(split + 1);
+			path 			= path.substr(0, split);
+			if(path.ends_with(u8"/"))
+				path.remove_suffix(1);
+		}
+
+		if(!path.empty() && (path != u8".") && (path != u8"text()"))
+		{
+			element_path.push_back(u8'/');
+			element_path.append(path);
+		}
+
+		m_table.columns.emplace_back(spec.name, spec.type);
+		m_bindings[element_path].push_back({i, std::move(attribute)});
+	}
+}
+
+ColumnTable
+ColumnExtractor::take()
+{
+	ColumnTable table = std::move(m_table);
+	m_table.rows = 0;
+	m_table.columns.clear();
+	for(auto & column : table.columns)
+		m_table.columns.emplace_back(column.name(), column.type());
+	m_record_depth = 0;
+	return table;
+}
+
+std::error_code
+ColumnExtractor::on_event(Parser::Action action, const String & path, const ElementStack & element_stack)
+{
+	if(element_stack.empty())
+		return {};
+
+	const auto & element 	= element_stack.back();
+	const auto 	depth 		= element_stack.size();
+
+	switch(action)
+	{
+		case Parser::ACTION_START_ELEMENT :
+			if(auto ec = on_start(path, element, depth))
+				return ec;
+			if(element.b_closed)
+				return on_end(path, element, depth);
+			break;
+
+		case Parser::ACTION_END_ELEMENT :
+			return on_end(path, element, depth);
+
+		default :
+			break;
+	}
+	return {};
+}
+
+std::error_code
+ColumnExtractor::on_start(const String & path, const Element & element, std::size_t depth)
+{
+	if(m_record_depth == 0)
+	{
+		if(std::u8string_view(path) != m_record_path)
+			return {};
+		m_record_depth = depth;
+		m_row_filled.assign(m_table.columns.size(), false);
+	}
+
+	auto ifind = m_bindings.find(std::u8string_view(path));
+	if(ifind == m_bindings.end())
+		return {};
+
+	for(auto & binding : ifind->second)
+		if(!binding.attribute.empty())
+		{
+			auto iattr = element.attributes.find(binding.attribute);
+			if(iattr != element.attributes.end())
+				if(auto ec = fill(binding.column, iattr->second))
+					return ec;
+		}
+
+	return {};
+}
+
+std::error_code
+ColumnExtractor::on_end(const String & path, const Element & element, std::size_t depth)
+{
+	if(m_record_depth == 0)
+		return {};
+
+	auto ifind = m_bindings.find(std::u8string_view(path));
+	if(ifind != m_bindings.end())
+		for(auto & binding : ifind->second)
+			if(binding.attribute.empty())
+				if(auto ec = fill(binding.column, element.content))
+					return ec;
+
+	if(depth == m_record_depth)
+	{
+		for(std::size_t i = 0; i < m_row_filled.size(); ++i)
+			if(!m_row_filled[i])
+				m_table.columns[i].append_null();
+		++m_table.rows;
+		m_record_depth = 0;
+	}
+
+	return {};
+}
+
+std::error_code
+ColumnExtractor::fill(std::size_t column, std::u8string_view text)
+{
+	if(m_row_filled[column])
+		return {};
+	m_row_filled[column] = true;
+	return m_table.columns[column].append(text);
+}
+
+} // namespace adexml
@@ -0,0 +1,195 @@
+//=============================================================================
+//	FILE:					columnar.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Extraction of repeated records straight into typed column buffers.
+//
+//		A column's path is relative to the record element:
+//			"@id"					attribute of the record element
+//			"."						text of the record element
+//			"name"				text of a child element
+//			"name/@lang"	attribute of a child element
+//
+//		Buffers use the Arrow columnar layout: bit-packed validity bitmaps
+//		(LSB first), fixed width values, bit-packed booleans and strings as
+//		int32 offsets plus UTF-8 bytes. export_to_arrow() hands them out
+//		through the Arrow C data interface without depending on Arrow.
+//		https://arrow.apache.org/docs/format/CDataInterface.html
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_COLUMNAR_H
+#define GUARD_ADE_XML_COLUMNAR_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "xml_parser.h"
+
+//-----------------------------------------------------------------------------
+//	Arrow C data interface. These definitions are ABI stable and guarded as
+//	the Arrow specification requires so that they can coexist with Arrow's
+//	own headers.
+//-----------------------------------------------------------------------------
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+	const char *					format;
+	const char *					name;
+	const char *					metadata;
+	int64_t								flags;
+	int64_t								n_children;
+	struct ArrowSchema **	children;
+	struct ArrowSchema *	dictionary;
+	void									(*release)(struct ArrowSchema *);
+	void *								private_data;
+};
+
+struct ArrowArray
+{
+	int64_t								length;
+	int64_t								null_count;
+	int64_t								offset;
+	int64_t								n_buffers;
+	int64_t								n_children;
+	const void **					buffers;
+	struct ArrowArray **	children;
+	struct ArrowArray *		dictionary;
+	void									(*release)(struct ArrowArray *);
+	void *								private_data;
+};
+
+#endif // ! defined ARROW_C_DATA_INTERFACE
+
+namespace adexml
+{
+
+enum class ColumnType
+{
+	INT64,
+	FLOAT64,
+	BOOL,
+	UTF8
+};
+
+struct ColumnSpec
+{
+	std::u8string		name;
+	std::u8string		path;
+	ColumnType			type;
+};
+
+//=============================================================================
+//
+//	COLUMN
+//
+//=============================================================================
+
+class Column
+{
+private:
+	std::u8string							m_name;
+	ColumnType								m_type;
+	std::size_t								m_length 			= 0;
+	std::size_t								m_null_count	= 0;
+	std::vector<std::uint8_t>	m_validity;
+	std::vector<std::int64_t>	m_int64;
+	std::vector<double>				m_float64;
+	std::vector<std::uint8_t>	m_bits;
+	std::vector<std::int32_t>	m_offsets;
+	std::vector<char8_t>			m_bytes;
+
+public:
+	Column(std::u8string name, ColumnType type);
+
+	const std::u8string &					name() const				{return m_name;}
+	ColumnType										type() const				{return m_type;}
+	std::size_t										size() const				{return m_length;}
+	std::size_t										null_count() const	{return m_null_count;}
+
+	bool													is_valid(std::size_t row) const	{return (m_validity[row >> 3] >> (row & 7)) & 1;}
+	std::span<const std::int64_t>	int64_values() const						{return m_int64;}
+	std::span<const double>				float64_values() const					{return m_float64;}
+	bool													bool_value(std::size_t row) const	{return (m_bits[row >> 3] >> (row & 7)) & 1;}
+	std::u8string_view						string_value(std::size_t row) const	{return {m_bytes.data() + m_offsets[row], static_cast<std::size_t>(m_offsets[row+1] - m_offsets[row])};}
+
+	std::error_code								append(std::u8string_view text);
+	void													append_null();
+
+	//---------------------------------------------------------------------------
+	//	Arrow buffer pointers for this column, in C data interface order.
+	//---------------------------------------------------------------------------
+	std::size_t										arrow_buffers(const void ** buffers) const;
+	const char *									arrow_format() const;
+
+private:
+	void													push_validity(bool b_valid);
+};
+
+struct ColumnTable
+{
+	std::vector<Column>		columns;
+	std::size_t						rows = 0;
+};
+
+//-----------------------------------------------------------------------------
+//	Moves the table into an Arrow struct array (one child per column). The
+//	exported arrays keep the buffers alive until the last of them is released.
+//-----------------------------------------------------------------------------
+void	export_to_arrow(ColumnTable && table, ArrowArray * out_array, ArrowSchema * out_schema);
+
+//=============================================================================
+//
+//	COLUMN EXTRACTOR
+//
+//=============================================================================
+
+class ColumnExtractor
+{
+private:
+	struct Binding
+	{
+		std::size_t				column;
+		std::u8string			attribute;		// Empty to take the element text
+	};
+
+	std::u8string																						m_record_path;
+	ColumnTable																							m_table;
+	std::unordered_map<std::u8string, std::vector<Binding>, StringHash, StringEqual>	m_bindings;		// Keyed by full element path
+	std::vector<bool>																				m_row_filled;
+	std::size_t																							m_record_depth = 0;
+
+public:
+	ColumnExtractor(std::u8string_view record_path, const std::vector<ColumnSpec> & schema);
+
+	std::error_code			on_event(Parser::Action action, const String & path, const ElementStack & element_stack);
+	Parser::Callback		callback()				{return [this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);};}
+
+	const ColumnTable &	table() const			{return m_table;}
+	ColumnTable					take();
+
+private:
+	std::error_code			on_start(const String & path, const Element & element, std::size_t depth);
+	std::error_code			on_end(const String & path, const Element & element, std::size_t depth);
+	std::error_code			fill(std::size_t column, std::u8string_view text);
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_COLUMNAR_H
@@ -0,0 +1,137 @@
+//=============================================================================
+//	FILE:					convert.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Conversion of attribute and content text to typed values without
+//		allocating. Numbers are converted with std::from_chars and must use the
+//		whole of the (whitespace trimmed) text.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_CONVERT_H
+#define GUARD_ADE_XML_CONVERT_H
+
+#include <charconv>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "errors.h"
+
+namespace adexml
+{
+
+template<typename T>	struct is_optional 										: std::false_type {};
+template<typename T>	struct is_optional<std::optional<T>>	: std::true_type {};
+
+template<typename T>	struct is_u8string 																														: std::false_type {};
+template<typename A>	struct is_u8string<std::basic_string<char8_t, std::char_traits<char8_t>, A>>	: std::true_type {};
+
+constexpr std::u8string_view
+trim(std::u8string_view text)
+{
+	constexpr std::u8string_view whitespace = u8" \t\r\n";
+	auto first = text.find_first_not_of(whitespace);
+	if(first == std::u8string_view::npos)
+		return {};
+	return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+}
+
+template<typename T>
+std::error_code
+parse_value(std::u8string_view text, T & out)
+{
+	if constexpr (is_optional<T>::value)
+	{
+		typename T::value_type value{};
+		if(auto ec = parse_value(text, value))
+			return ec;
+		out = std::move(value);
+		return {};
+	}
+	else if constexpr (is_u8string<T>::value)
+	{
+		out.assign(text);
+		return {};
+	}
+	else if constexpr (std::is_same_v<T, std::string>)
+	{
+		out.assign(reinterpret_cast<const char *>(text.data()), text.size());
+		return {};
+	}
+	else if constexpr (std::is_same_v<T, bool>)
+	{
+		text = trim(text);
+		if(text == u8"true" || text == u8"1")				out = true;
+		else if(text == u8"false" || text == u8"0")	out = false;
+		else return adexml::Error::VALUE_CONVERSION_ERROR;
+		return {};
+	}
+	else if constexpr (std::is_enum_v<T>)
+	{
+		std::underlying_type_t<T> value{};
+		if(auto ec = parse_value(text, value))
+			return ec;
+		out = static_cast<T>(value);
+		return {};
+	}
+	else if constexpr (std::is_arithmetic_v<T>)
+	{
+		text = trim(text);
+		auto first 	= reinterpret_cast<const char *>(text.data());
+		auto last		= first + text.size();
+
+		// from_chars does not accept a leading '+', XML Schema numbers do. The
+		// sign must be followed by the number itself, not another sign.
+		if((first != last) && (*first == '+'))
+		{
+			++first;
+			const bool b_number = (first != last)
+												&& (((*first >= '0') && (*first <= '9'))
+														|| (std::is_floating_point_v<T> && (*first == '.')));
+			if(!b_number)
+				return adexml::Error::VALUE_CONVERSION_ERROR;
+		}
+
+		auto [ptr, ec] = std::from_chars(first, last, out);
+		if(ec == std::errc::result_out_of_range)
+			return adexml::Error::VALUE_OUT_OF_RANGE;
+		if((ec != std::errc{}) || (ptr != last) || (first == last))
+			return adexml::Error::VALUE_CONVERSION_ERROR;
+		return {};
+	}
+	else
+	{
+		static_assert(!sizeof(T), "adexml::parse_value: unsupported type");
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	Enumerations by name, e.g. {{u8"red", Colour::RED}, {u8"green", Colour::GREEN}}
+//-----------------------------------------------------------------------------
+template<typename E>
+std::error_code
+parse_enum(std::u8string_view text, std::span<const std::pair<std::u8string_view, E>> names, E & out)
+{
+	text = trim(text);
+	for(auto & [name, value] : names)
+		if(name == text)
+		{
+			out = value;
+			return {};
+		}
+	return adexml::Error::VALUE_CONVERSION_ERROR;
+}
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_CONVERT_H
@@ -0,0 +1,423 @@
+//=============================================================================
+//	FILE:					dtd.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include "dtd.h"
+
+namespace adexml
+{
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+//	Minimal cursor over the text of a declaration.
+//-----------------------------------------------------------------------------
+class DeclarationReader
+{
+private:
+	std::u8string_view	m_text;
+	std::size_t					m_pos = 0;
+
+public:
+	explicit DeclarationReader(std::u8string_view text) : m_text(text) {}
+
+	bool				at_end() const													{return m_pos >= m_text.size();}
+	char8_t			peek() const														{return at_end() ? 0 : m_text[m_pos];}
+	bool				accept(std::u8string_view token)				{if(!m_text.substr(m_pos).starts_with(token)) return false; m_pos += token.size(); return true;}
+
+	static bool	is_space(char8_t ch)										{return (ch == SPACE) || (ch == CHARACTER_TABULATION) || (ch == LINE_FEED) || (ch == CARRIAGE_RETURN);}
+
+	bool
+	skip_space()
+	{
+		auto start = m_pos;
+		while(!at_end() && is_space(m_text[m_pos]))
+			++m_pos;
+		return m_pos > start;
+	}
+
+	std::u8string_view
+	name()
+	{
+		auto start = m_pos;
+		if(!at_end() && is_entity_name_start_char(m_text[m_pos]))
+			while(!at_end() && is_entity_name_char(m_text[m_pos]))
+				++m_pos;
+		return m_text.substr(start, m_pos - start);
+	}
+
+	std::u8string_view
+	name_token()
+	{
+		auto start = m_pos;
+		while(!at_end() && is_entity_name_char(m_text[m_pos]))
+			++m_pos;
+		return m_text.substr(start, m_pos - start);
+	}
+
+	// Read a quoted literal. Returns false if there is no complete literal.
+	bool
+	literal(std::u8string_view & value)
+	{
+		auto quote = peek();
+		if((quote != QUOTATION_MARK) && (quote != APOSTROPHE))
+			return false;
+
+		auto end = m_text.find(quote, m_pos + 1);
+		if(end == m_text.npos)
+			return false;
+
+		value = m_text.substr(m_pos + 1, end - m_pos - 1);
+		m_pos = end + 1;
+		return true;
+	}
+
+	// Skip past the next occurrence of 'terminator'.
+	bool
+	skip_past(std::u8string_view terminator)
+	{
+		auto end = m_text.find(terminator, m_pos);
+		if(end == m_text.npos)
+			return false;
+		m_pos = end + terminator.size();
+		return true;
+	}
+
+	// Read up to the next 'terminator', which is consumed but not returned.
+	bool
+	until(char8_t terminator, std::u8string_view & text)
+	{
+		auto end = m_text.find(terminator, m_pos);
+		if(end == m_text.npos)
+			return false;
+		text 	= m_text.substr(m_pos, end - m_pos);
+		m_pos = end + 1;
+		return true;
+	}
+
+	// Skip the rest of a markup declaration, honouring quoted literals.
+	bool
+	skip_declaration()
+	{
+		while(!at_end())
+		{
+			auto ch = m_text[m_pos];
+			if((ch == QUOTATION_MARK) || (ch == APOSTROPHE))
+			{
+				std::u8string_view ignored;
+				if(!literal(ignored))
+					return false;
+			}
+			else
+			{
+				++m_pos;
+				if(ch == GREATER_THAN_SIGN)
+					return true;
+			}
+		}
+		return false;
+	}
+};
+
+std::error_code	syntax_error()	{return adexml::Error::DTD_SYNTAX_ERROR;}
+
+//-----------------------------------------------------------------------------
+//	ExternalID ::= 'SYSTEM' S SystemLiteral | 'PUBLIC' S PubidLiteral S SystemLiteral
+//-----------------------------------------------------------------------------
+std::error_code
+parse_external_id(DeclarationReader & reader, std::u8string_view & public_id, std::u8string_view & system_id)
+{
+	if(reader.accept(u8"SYSTEM"))
+	{
+		if(!reader.skip_space() || !reader.literal(system_id))
+			return syntax_error();
+	}
+	else if(reader.accept(u8"PUBLIC"))
+	{
+		if(!reader.skip_space() || !reader.literal(public_id) || !reader.skip_space() || !reader.literal(system_id))
+			return syntax_error();
+	}
+	else
+		return syntax_error();
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	<!ENTITY S Name S EntityDef S? '>' | <!ENTITY S '%' S Name S PEDef S? '>'
+//-----------------------------------------------------------------------------
+std::error_code
+parse_entity(DeclarationReader & reader, Doctype & doctype)
+{
+	if(!reader.skip_space())
+		return syntax_error();
+
+	bool b_parameter = reader.accept(u8"%");
+	if(b_parameter && !reader.skip_space())
+		return syntax_error();
+
+	auto name = reader.name();
+	if(name.empty() || !reader.skip_space())
+		return syntax_error();
+
+	std::u8string_view value;
+	bool b_internal = reader.literal(value);
+	if(!b_internal)
+	{
+		std::u8string_view public_id, system_id;
+		if(auto ec = parse_external_id(reader, public_id, system_id))
+			return ec;
+
+		if(reader.skip_space() && reader.accept(u8"NDATA"))
+			if(!reader.skip_space() || reader.name().empty())
+				return syntax_error();
+	}
+
+	reader.skip_space();
+	if(!reader.accept(u8">"))
+		return syntax_error();
+
+	if(b_internal && !b_parameter)
+		doctype.entities.declare(name, value);
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	<!ELEMENT S Name S contentspec S? '>'
+//-----------------------------------------------------------------------------
+std::error_code
+parse_element(DeclarationReader & reader, Doctype & doctype)
+{
+	if(!reader.skip_space())
+		return syntax_error();
+
+	auto name = reader.name();
+	std::u8string_view content;
+	if(name.empty() || !reader.skip_space() || !reader.until(GREATER_THAN_SIGN, content))
+		return syntax_error();
+
+	while(!content.empty() && DeclarationReader::is_space(content.back()))
+		content.remove_suffix(1);
+	if(content.empty())
+		return syntax_error();
+
+	auto resource = doctype.resource();
+	doctype.elements.push_back({String(name, resource), String(content, resource)});
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	Enumeration ::= '(' S? Nmtoken (S? '|' S? Nmtoken)* S? ')'
+//-----------------------------------------------------------------------------
+std::error_code
+parse_enumeration(DeclarationReader & reader, std::pmr::vector<String> & values)
+{
+	if(!reader.accept(u8"("))
+		return syntax_error();
+
+	do
+	{
+		reader.skip_space();
+		auto token = reader.name_token();
+		if(token.empty())
+			return syntax_error();
+		values.emplace_back(token);
+		reader.skip_space();
+	}
+	while(reader.accept(u8"|"));
+
+	return reader.accept(u8")") ? std::error_code{} : syntax_error();
+}
+
+//-----------------------------------------------------------------------------
+//	<!ATTLIST S Name (S Name S AttType S DefaultDecl)* S? '>'
+//-----------------------------------------------------------------------------
+std::error_code
+parse_attlist(DeclarationReader & reader, Doctype & doctype)
+{
+	static constexpr std::pair<std::u8string_view, AttributeType>	TYPES[] =
+	{
+		{u8"CDATA",			AttributeType::CDATA},
+		{u8"ID",				AttributeType::ID},
+		{u8"IDREF",			AttributeType::IDREF},
+		{u8"IDREFS",		AttributeType::IDREFS},
+		{u8"ENTITY",		AttributeType::ENTITY},
+		{u8"ENTITIES",	AttributeType::ENTITIES},
+		{u8"NMTOKEN",		AttributeType::NMTOKEN},
+		{u8"NMTOKENS",	AttributeType::NMTOKENS},
+		{u8"NOTATION",	AttributeType::NOTATION}
+	};
+
+	auto resource = doctype.resource();
+	if(!reader.skip_space())
+		return syntax_error();
+
+	auto element = reader.name();
+	if(element.empty())
+		return syntax_error();
+
+	for(;;)
+	{
+		reader.skip_space();
+		if(reader.accept(u8">"))
+			return {};
+
+		AttributeDecl decl{String(element, resource), String(reader.name(), resource), std::pmr::vector<String>(resource), String(resource)};
+		if(decl.name.empty() || !reader.skip_space())
+			return syntax_error();
+
+		if(reader.peek() == u8'(')
+			decl.type = AttributeType::ENUMERATION;
+		else
+		{
+			auto type = reader.name();
+			auto it 	= std::ranges::find(TYPES, type, &std::pair<std::u8string_view, AttributeType>::first);
+			if(it == std::end(TYPES))
+				return syntax_error();
+			decl.type = it->second;
+			if((decl.type == AttributeType::NOTATION) && !reader.skip_space())
+				return syntax_error();
+		}
+
+		if((decl.type == AttributeType::ENUMERATION) || (decl.type == AttributeType::NOTATION))
+			if(auto ec = parse_enumeration(reader, decl.values))
+				return ec;
+
+		if(!reader.skip_space())
+			return syntax_error();
+
+		std::u8string_view value;
+		if(reader.accept(u8"#REQUIRED"))
+			decl.presence = AttributeDefault::REQUIRED;
+		else if(reader.accept(u8"#IMPLIED"))
+			decl.presence = AttributeDefault::IMPLIED;
+		else
+		{
+			decl.presence = AttributeDefault::VALUE;
+			if(reader.accept(u8"#FIXED"))
+			{
+				decl.presence = AttributeDefault::FIXED;
+				if(!reader.skip_space())
+					return syntax_error();
+			}
+			if(!reader.literal(value))
+				return syntax_error();
+			decl.value.assign(value);
+		}
+
+		doctype.attributes.push_back(std::move(decl));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	intSubset ::= (markupdecl | PEReference | S)*
+//	The internal subset ends with ']'; a stand-alone list of declarations ends
+//	with the text.
+//-----------------------------------------------------------------------------
+std::error_code
+parse_subset(DeclarationReader & reader, Doctype & doctype, bool b_bracketed)
+{
+	for(;;)
+	{
+		reader.skip_space();
+		if(reader.at_end())
+			return b_bracketed ? syntax_error() : std::error_code{};
+
+		if(b_bracketed && reader.accept(u8"]"))
+			return {};
+
+		if(reader.accept(u8"<!--"))
+		{
+			if(!reader.skip_past(u8"-->"))
+				return syntax_error();
+		}
+		else if(reader.accept(u8"<?"))
+		{
+			if(!reader.skip_past(u8"?>"))
+				return syntax_error();
+		}
+		else if(reader.accept(u8"<!ENTITY"))
+		{
+			if(auto ec = parse_entity(reader, doctype))
+				return ec;
+		}
+		else if(reader.accept(u8"<!ELEMENT"))
+		{
+			if(auto ec = parse_element(reader, doctype))
+				return ec;
+		}
+		else if(reader.accept(u8"<!ATTLIST"))
+		{
+			if(auto ec = parse_attlist(reader, doctype))
+				return ec;
+		}
+		else if(reader.accept(u8"<!NOTATION"))
+		{
+			if(!reader.skip_declaration())
+				return syntax_error();
+		}
+		else if(reader.accept(u8"%"))
+		{
+			if(reader.name().empty() || !reader.accept(u8";"))
+				return syntax_error();
+		}
+		else
+			return syntax_error();
+	}
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+//	doctypedecl ::= '<!DOCTYPE' S Name (S ExternalID)? S? ('[' intSubset ']' S?)? '>'
+//-----------------------------------------------------------------------------
+std::error_code
+parse_doctype(std::u8string_view declaration, Doctype & doctype)
+{
+	DeclarationReader reader(declaration);
+
+	if(!reader.skip_space())
+		return syntax_error();
+
+	auto name = reader.name();
+	if(name.empty())
+		return syntax_error();
+	doctype.name.assign(name);
+
+	if(reader.skip_space() && ((reader.peek() == LATIN_CAPITAL_LETTER_S) || (reader.peek() == LATIN_CAPITAL_LETTER_P)))
+	{
+		std::u8string_view public_id, system_id;
+		if(auto ec = parse_external_id(reader, public_id, system_id))
+			return ec;
+		doctype.public_id.assign(public_id);
+		doctype.system_id.assign(system_id);
+		reader.skip_space();
+	}
+
+	if(reader.accept(u8"["))
+	{
+		if(auto ec = parse_subset(reader, doctype, true))
+			return ec;
+		reader.skip_space();
+	}
+
+	return reader.at_end() ? std::error_code{} : syntax_error();
+}
+
+std::error_code
+parse_declarations(std::u8string_view declarations, Doctype & doctype)
+{
+	DeclarationReader reader(declarations);
+	return parse_subset(reader, doctype, false);
+}
+
+} // namespace adexml
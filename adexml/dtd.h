@@ -0,0 +1,115 @@
+//=============================================================================
+//	FILE:					dtd.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Document type declarations.
+//		https://www.w3.org/TR/REC-xml/#sec-prolog-dtd
+//
+//		Only the internal subset is read; external identifiers are recorded but
+//		never fetched. Internal general entities are stored in an EntityTable.
+//		Parameter entities are recognised but not expanded, and external
+//		general entities are not declared, so referencing one reports
+//		UNKNOWN_ENTITY. Element and attribute-list declarations are kept for
+//		Schema (schema.h) to compile; content models are stored as text.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_DTD_H
+#define GUARD_ADE_XML_DTD_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include <string_view>
+#include <system_error>
+#include "entity.h"
+#include "strings.h"
+
+namespace adexml
+{
+
+enum class AttributeType : std::uint8_t
+{
+	CDATA,
+	ID,
+	IDREF,
+	IDREFS,
+	ENTITY,
+	ENTITIES,
+	NMTOKEN,
+	NMTOKENS,
+	NOTATION,
+	ENUMERATION
+};
+
+enum class AttributeDefault : std::uint8_t
+{
+	IMPLIED,
+	REQUIRED,
+	FIXED,
+	VALUE
+};
+
+//-----------------------------------------------------------------------------
+//	<!ELEMENT name content>, where content is "EMPTY", "ANY" or a
+//	parenthesised model such as "(title, (para | list)*)".
+//-----------------------------------------------------------------------------
+struct ElementDecl
+{
+	String							name;
+	String							content;
+};
+
+//-----------------------------------------------------------------------------
+//	One attribute definition from an <!ATTLIST ...>. 'values' holds the
+//	allowed values of NOTATION and enumerated types and 'value' the default
+//	for FIXED and VALUE.
+//-----------------------------------------------------------------------------
+struct AttributeDecl
+{
+	String							element;
+	String							name;
+	std::pmr::vector<String>	values;
+	String							value;
+	AttributeType				type 			= AttributeType::CDATA;
+	AttributeDefault		presence 	= AttributeDefault::IMPLIED;
+};
+
+struct Doctype
+{
+	String										name;
+	String										public_id;
+	String										system_id;
+	EntityTable								entities;
+	std::pmr::vector<ElementDecl>			elements;
+	std::pmr::vector<AttributeDecl>		attributes;
+
+	explicit Doctype(std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+		: name(resource), public_id(resource), system_id(resource), entities(resource), elements(resource), attributes(resource) {}
+
+	std::pmr::memory_resource *	resource() const	{return name.get_allocator().resource();}
+
+	void	clear()		{name.clear(); public_id.clear(); system_id.clear(); entities.clear(); elements.clear(); attributes.clear();}
+};
+
+//-----------------------------------------------------------------------------
+//	Parse the text of a <!DOCTYPE ...> declaration, from after the DOCTYPE
+//	keyword up to (not including) the closing '>', into 'doctype'.
+//-----------------------------------------------------------------------------
+std::error_code		parse_doctype(std::u8string_view declaration, Doctype & doctype);
+
+//-----------------------------------------------------------------------------
+//	Parse a sequence of markup declarations, such as the contents of an
+//	external .dtd file, into 'doctype'.
+//-----------------------------------------------------------------------------
+std::error_code		parse_declarations(std::u8string_view declarations, Doctype & doctype);
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_DTD_H
@@ -15,7 +15,18 @@
 #ifndef GUARD_ADE_XML_ENTITY_H
 #define GUARD_ADE_XML_ENTITY_H
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include "errors.h"
+#include "strings.h"
+#include "unicode.h"
 
 namespace adexml
 {
@@ -120,10 +131,286 @@ enum
 };
 
 
+class Parser;
+
+//=============================================================================
+//
+//	CHARACTER REFERENCES
+//
+//=============================================================================
+
+constexpr bool
+is_xml_char(char32_t ch)
+{
+	return 	(ch == CHARACTER_TABULATION) || (ch == LINE_FEED) || (ch == CARRIAGE_RETURN) ||
+					((ch >= 0x20) && (ch <= 0xD7FF)) ||
+					((ch >= 0xE000) && (ch <= 0xFFFD)) ||
+					((ch >= 0x10000) && (ch <= 0x10FFFF));
+}
+
+//-----------------------------------------------------------------------------
+//	Decode the body of a character reference, "#123" or "#x7B", without the
+//	surrounding '&' and ';'. Returns nothing if the digits are malformed or do
+//	not name a legal XML character.
+//-----------------------------------------------------------------------------
+constexpr std::optional<char32_t>
+decode_char_reference(std::u8string_view body)
+{
+	if((body.size() < 2) || (body[0] != NUMBER_SIGN))
+		return std::nullopt;
+
+	const bool	b_hex = (body[1] == LATIN_SMALL_LETTER_X);
+	auto				digits = body.substr(b_hex ? 2 : 1);
+	if(digits.empty())
+		return std::nullopt;
+
+	std::uint32_t code = 0;
+	for(auto ch : digits)
+	{
+		std::uint32_t digit;
+		if((ch >= DIGIT_ZERO) && (ch <= DIGIT_NINE))														digit = ch - DIGIT_ZERO;
+		else if(b_hex && (ch >= LATIN_SMALL_LETTER_A) && (ch <= LATIN_SMALL_LETTER_F))		digit = ch - LATIN_SMALL_LETTER_A + 10;
+		else if(b_hex && (ch >= LATIN_CAPITAL_LETTER_A) && (ch <= LATIN_CAPITAL_LETTER_F))	digit = ch - LATIN_CAPITAL_LETTER_A + 10;
+		else
+			return std::nullopt;
+
+		code = code * (b_hex ? 16 : 10) + digit;
+		if(code > 0x10FFFF)
+			return std::nullopt;
+	}
+
+	if(!is_xml_char(code))
+		return std::nullopt;
+	return static_cast<char32_t>(code);
+}
+
+//-----------------------------------------------------------------------------
+//	The five entities every XML processor must recognise.
+//-----------------------------------------------------------------------------
+constexpr std::optional<char32_t>
+predefined_entity(std::u8string_view name)
+{
+	if(name == u8"amp")		return AMPERSAND;
+	if(name == u8"lt")		return LESS_THAN_SIGN;
+	if(name == u8"gt")		return GREATER_THAN_SIGN;
+	if(name == u8"quot")	return QUOTATION_MARK;
+	if(name == u8"apos")	return APOSTROPHE;
+	return std::nullopt;
+}
+
+//-----------------------------------------------------------------------------
+//	Element and attribute names (NameStartChar and NameChar in the XML
+//	specification).
+//-----------------------------------------------------------------------------
+constexpr bool
+is_xml_name_start_char(char32_t ch)
+{
+	return 	(ch == COLON) || (ch == LOW_LINE) ||
+					((ch >= LATIN_CAPITAL_LETTER_A) && (ch <= LATIN_CAPITAL_LETTER_Z)) ||
+					((ch >= LATIN_SMALL_LETTER_A) && (ch <= LATIN_SMALL_LETTER_Z)) ||
+					((ch >= 0xC0) && (ch <= 0xD6)) ||
+					((ch >= 0xD8) && (ch <= 0xF6)) ||
+					((ch >= 0xF8) && (ch <= 0x02FF)) ||
+					((ch >= 0x0370) && (ch <= 0x037D)) ||
+					((ch >= 0x037F) && (ch <= 0x1FFF)) ||
+					((ch >= 0x200C) && (ch <= 0x200D)) ||
+					((ch >= 0x2070) && (ch <= 0x218F)) ||
+					((ch >= 0x2C00) && (ch <= 0x2FEF)) ||
+					((ch >= 0x3001) && (ch <= 0xD7FF)) ||
+					((ch >= 0xF900) && (ch <= 0xFDCF)) ||
+					((ch >= 0xFDF0) && (ch <= 0xFFFD)) ||
+					((ch >= 0x10000) && (ch <= 0xEFFFF));
+}
+
+constexpr bool
+is_xml_name_char(char32_t ch)
+{
+	return 	is_xml_name_start_char(ch) ||
+					(ch == HYPHEN_MINUS) || (ch == FULL_STOP) ||
+					((ch >= DIGIT_ZERO) && (ch <= DIGIT_NINE)) || (ch == 0xB7) ||
+					((ch >= 0x0300) && (ch <= 0x036F)) ||
+					((ch >= 0x203F) && (ch <= 0x2040));
+}
+
+constexpr bool	is_entity_name_start_char(char32_t ch)	{return ((ch|0x20) >= LATIN_SMALL_LETTER_A && (ch|0x20) <= LATIN_SMALL_LETTER_Z) || (ch == LOW_LINE) || (ch == COLON) || (ch >= 0x80);}
+constexpr bool	is_entity_name_char(char32_t ch)				{return is_entity_name_start_char(ch) || ((ch >= DIGIT_ZERO) && (ch <= DIGIT_NINE)) || (ch == HYPHEN_MINUS) || (ch == FULL_STOP);}
+
+//=============================================================================
+//
+//	ENTITY TABLE
+//
+//	General entities declared in a document's internal DTD subset. Each entity
+//	keeps its literal value until it is first referenced, at which point the
+//	references inside it are expanded (recursively) and the UTF-8 result is
+//	cached, so every later reference is a single append. Replacement text is
+//	treated as character data; markup inside an entity is not parsed.
+//
+//=============================================================================
+
+class EntityTable
+{
+private:
+	friend class Parser;		// Checkpoints
+
+	enum class Expansion : std::uint8_t
+	{
+		LITERAL,
+		EXPANDING,
+		EXPANDED
+	};
+
+	struct Entity
+	{
+		String				text;
+		Expansion			expansion = Expansion::LITERAL;
+	};
+
+	std::pmr::unordered_map<String, Entity, StringHash, StringEqual>	m_entities;
+	std::uint64_t																											m_expansions_left				= UINT64_MAX;
+	std::uint64_t																											m_expansion_bytes_left	= UINT64_MAX;
+
+public:
+	explicit EntityTable(std::pmr::memory_resource * resource = std::pmr::get_default_resource()) : m_entities(resource) {}
+
+	std::pmr::memory_resource *		resource() const	{return m_entities.get_allocator().resource();}
+	std::size_t										size() const			{return m_entities.size();}
+	bool													empty() const			{return m_entities.empty();}
+	bool													contains(std::u8string_view name) const	{return m_entities.find(name) != m_entities.end();}
+	void													clear()						{m_entities.clear();}
+
+	//---------------------------------------------------------------------------
+	//	Declare an entity with its literal value. As in XML, the first
+	//	declaration of a name is binding and later ones are ignored (returns
+	//	false).
+	//---------------------------------------------------------------------------
+	bool
+	declare(std::u8string_view name, std::u8string_view value)
+	{
+		if(contains(name))
+			return false;
+		auto [it, b_inserted] = m_entities.try_emplace(String(name, resource()));
+		it->second.text.assign(value);
+		return true;
+	}
+
+	//---------------------------------------------------------------------------
+	//	Bound the references that expand_reference() resolves, and the total
+	//	number of bytes they produce, until the next call.
+	//---------------------------------------------------------------------------
+	void
+	set_budget(std::uint64_t max_expansions, std::uint64_t max_expansion_bytes)
+	{
+		m_expansions_left				= max_expansions;
+		m_expansion_bytes_left	= max_expansion_bytes;
+	}
+
+	//---------------------------------------------------------------------------
+	//	Resolve a reference to 'name' in a document and charge it to the budget,
+	//	returning ENTITY_LIMIT_EXCEEDED once that is spent.
+	//---------------------------------------------------------------------------
+	std::expected<std::u8string_view, std::error_code>
+	expand_reference(std::u8string_view name)
+	{
+		if(m_expansions_left == 0)
+			return std::unexpected(make_error_code(adexml::Error::ENTITY_LIMIT_EXCEEDED));
+		--m_expansions_left;
+
+		auto text = resolve(name, m_expansion_bytes_left);
+		if(text)
+			m_expansion_bytes_left -= text->size();
+		return text;
+	}
+
+	//---------------------------------------------------------------------------
+	//	Return the fully expanded replacement text of 'name'. Expansion stops
+	//	with ENTITY_LIMIT_EXCEEDED as soon as the text would exceed max_bytes,
+	//	which bounds the work done for exponential (billion laughs) definitions.
+	//	A failed expansion is not cached.
+	//---------------------------------------------------------------------------
+	std::expected<std::u8string_view, std::error_code>
+	resolve(std::u8string_view name, std::uint64_t max_bytes)
+	{
+		auto it = m_entities.find(name);
+		if(it == m_entities.end())
+			return std::unexpected(make_error_code(adexml::Error::UNKNOWN_ENTITY));
+
+		auto & entity = it->second;
+		switch(entity.expansion)
+		{
+			case Expansion::EXPANDED :	break;
+			case Expansion::EXPANDING :	return std::unexpected(make_error_code(adexml::Error::RECURSIVE_ENTITY));
+			case Expansion::LITERAL :
+				{
+					entity.expansion = Expansion::EXPANDING;
+					String expanded(resource());
+					if(auto ec = expand(entity.text, expanded, max_bytes))
+					{
+						entity.expansion = Expansion::LITERAL;
+						return std::unexpected(ec);
+					}
+					entity.text 			= std::move(expanded);
+					entity.expansion 	= Expansion::EXPANDED;
+				}
+				break;
+		}
+
+		if(entity.text.size() > max_bytes)
+			return std::unexpected(make_error_code(adexml::Error::ENTITY_LIMIT_EXCEEDED));
+		return entity.text;
+	}
+
+private:
+	std::error_code
+	expand(std::u8string_view literal, String & out, std::uint64_t max_bytes)
+	{
+		while(!literal.empty())
+		{
+			auto amp = literal.find(AMPERSAND);
+			out.append(literal.substr(0, amp));
+			if(amp == literal.npos)
+				break;
+
+			auto semicolon = literal.find(SEMICOLON, amp);
+			if(semicolon == literal.npos)
+				return make_error_code(adexml::Error::INVALID_ENTITY_CHARACTER);
+
+			auto reference = literal.substr(amp + 1, semicolon - amp - 1);
+			if(auto code = (reference.starts_with(NUMBER_SIGN) ? decode_char_reference(reference) : predefined_entity(reference)))
+				adexml::unicode::u32_to_u8(*code, out);
+			else if(reference.starts_with(NUMBER_SIGN))
+				return make_error_code(adexml::Error::INVALID_ENTITY_CHARACTER);
+			else
+			{
+				auto text = resolve(reference, max_bytes - std::min<std::uint64_t>(out.size(), max_bytes));
+				if(!text)
+					return text.error();
+				out.append(*text);
+			}
+
+			if(out.size() > max_bytes)
+				return make_error_code(adexml::Error::ENTITY_LIMIT_EXCEEDED);
+			literal.remove_prefix(semicolon + 1);
+		}
+
+		return (out.size() > max_bytes) ? make_error_code(adexml::Error::ENTITY_LIMIT_EXCEEDED) : std::error_code{};
+	}
+};
+
+//=============================================================================
+//
+//	ENTITY PARSER
+//
+//	Decodes references in character data one character at a time, appending
+//	the decoded text to a UTF-8 string.
+//
+//=============================================================================
+
 class EntityParser
 {
 private:
-	enum State
+	friend class Parser;		// Checkpoints
+
+	enum State : std::uint8_t
 	{
 		STATE_IDLE,
 		STATE_START,
@@ -131,15 +418,40 @@ private:
 		STATE_NAME
 	};
 
-	std::string			m_name;
-	char32_t				m_code 	= 0;
-	State						m_state = STATE_IDLE;
+	static constexpr std::size_t	MAX_NUMERIC_LENGTH = 10;		// "#x" and eight digits
+
+	EntityTable *		m_table 		= nullptr;
+	std::uint32_t		m_max_name 	= UINT32_MAX;
+	State						m_state 		= STATE_IDLE;
 
 public:
 	void		reset() {m_state = STATE_IDLE;}
+	bool		is_idle() const	{return m_state == STATE_IDLE;}
 
+	//---------------------------------------------------------------------------
+	//	Bound the length of entity names before NAME_LIMIT_EXCEEDED is returned.
+	//	Only checked when a reference is being parsed so plain text is
+	//	unaffected.
+	//---------------------------------------------------------------------------
+	void		set_max_name(std::uint32_t max_name)	{m_max_name = max_name;}
+
+	//---------------------------------------------------------------------------
+	//	Declared entities are looked up in 'table' (if any) after the
+	//	predefined ones, and are charged to its budget.
+	//---------------------------------------------------------------------------
+	void		set_table(EntityTable * table)	{m_table = table;}
+
+	//---------------------------------------------------------------------------
+	//	'name' holds the reference being parsed. It is the caller's so that an
+	//	idle parser keeps no buffer, and must be left alone until is_idle().
+	//
+	//	The caller bounds 'out' a character at a time. A declared entity can
+	//	append much more at once, so its replacement text is checked against
+	//	'max_out' first and 'out_error' returned if it would not fit.
+	//---------------------------------------------------------------------------
+	template<typename STRING, typename NAME>
 	std::error_code
-	parse(char32_t ch, std::function<void(char32_t)> callback)
+	parse(char32_t ch, STRING & out, NAME & name, std::uint64_t max_out, adexml::Error out_error)
 	{
 		switch(m_state)
 		{
@@ -149,22 +461,22 @@ public:
 				if(ch == AMPERSAND)
 					m_state = STATE_START;
 				else
-					callback(ch);
+					adexml::unicode::u32_to_u8(ch, out);
 				break;
 
 			//-------------------------------
 			case STATE_START :
 			//-------------------------------
+				name.clear();
 				if(ch == NUMBER_SIGN)
 				{
 					m_state = STATE_NUMERIC;
-					m_code = 0;
+					name.push_back(NUMBER_SIGN);
 				}
-				else if(isalpha(ch))
+				else if(is_entity_name_start_char(ch))
 				{
 					m_state = STATE_NAME;
-					m_name.clear();
-					m_name.push_back(ch);
+					adexml::unicode::u32_to_u8(ch, name);
 				}
 				else
 				{
@@ -176,18 +488,21 @@ public:
 			//-------------------------------
 			case STATE_NUMERIC :
 			//-------------------------------
+				m_state = STATE_IDLE;
 				if(ch == SEMICOLON)
 				{
-					m_state = STATE_IDLE;
-					callback(m_code);
+					auto code = decode_char_reference(name);
+					if(!code)
+						return make_error_code(adexml::Error::INVALID_ENTITY_CHARACTER);
+					adexml::unicode::u32_to_u8(*code, out);
 				}
-				if(isxdigit(ch))
-					m_code = (m_code << 4) | ((ch <= '9') ? ch - '0' : (toupper(ch)-'A')+10);
-				else
+				else if((name.size() < MAX_NUMERIC_LENGTH) && (ch < 0x80) && (std::isxdigit(static_cast<int>(ch)) || (ch == LATIN_SMALL_LETTER_X)))
 				{
-					m_state = STATE_IDLE;
-					return make_error_code(adexml::Error::INVALID_ENTITY_CHARACTER);
+					name.push_back(static_cast<char8_t>(ch));
+					m_state = STATE_NUMERIC;
 				}
+				else
+					return make_error_code(adexml::Error::INVALID_ENTITY_CHARACTER);
 				break;
 			
 			//-------------------------------
@@ -196,15 +511,17 @@ public:
 				if(ch == SEMICOLON)
 				{
 					m_state = STATE_IDLE;
-					if(m_name == "amp")				callback(AMPERSAND); 
-					else if(m_name == "apos")	callback(APOSTROPHE);
-					else if(m_name == "quot")	callback(QUOTATION_MARK);
-					else if(m_name == "lt")		callback(LESS_THAN_SIGN);
-					else if(m_name == "gt")		callback(GREATER_THAN_SIGN);
-					else return make_error_code(adexml::Error::UNKNOWN_ENTITY);
+					return expand_name(out, name, max_out, out_error);
+				}
+				else if(is_entity_name_char(ch))
+				{
+					if(name.size() >= m_max_name)
+					{
+						m_state = STATE_IDLE;
+						return make_error_code(adexml::Error::NAME_LIMIT_EXCEEDED);
+					}
+					adexml::unicode::u32_to_u8(ch, name);
 				}
-				else if(isalnum(ch))
-					m_name.push_back(ch);
 				else
 				{
 					m_state = STATE_IDLE;
@@ -220,6 +537,29 @@ public:
 		return {};
 	}
 
+private:
+	template<typename STRING>
+	std::error_code
+	expand_name(STRING & out, std::u8string_view name, std::uint64_t max_out, adexml::Error out_error)
+	{
+		if(auto code = predefined_entity(name))
+		{
+			adexml::unicode::u32_to_u8(*code, out);
+			return {};
+		}
+
+		if(!m_table)
+			return make_error_code(adexml::Error::UNKNOWN_ENTITY);
+
+		auto text = m_table->expand_reference(name);
+		if(!text)
+			return text.error();
+		if(text->size() > max_out - std::min<std::uint64_t>(out.size(), max_out))
+			return make_error_code(out_error);
+
+		out.append(*text);
+		return {};
+	}
 };
 
 } // namespace adexml
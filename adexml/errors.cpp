@@ -42,6 +42,35 @@ AdeXMLErrorCategory::message(int ev) const
 		case 	adexml::Error::ELEMENT_TAG_MISMATCH :						return "Element Tag Mismatch";
 		case	adexml::Error::INVALID_ENTITY_CHARACTER :				return "Invalid Entity Character";
 		case 	adexml::Error::UNKNOWN_ENTITY :									return "Unknown Entity";
+		case 	adexml::Error::INCOMPLETE_DOCUMENT :						return "Incomplete Document";
+		case 	adexml::Error::QUERY_SYNTAX_ERROR :							return "Syntax Error in Query";
+		case 	adexml::Error::VALUE_CONVERSION_ERROR :					return "Value Conversion Error";
+		case 	adexml::Error::VALUE_OUT_OF_RANGE :							return "Value Out of Range";
+		case 	adexml::Error::ATTRIBUTE_NOT_FOUND :						return "Attribute Not Found";
+		case 	adexml::Error::OUT_OF_MEMORY :									return "Out of Memory";
+		case 	adexml::Error::DEPTH_LIMIT_EXCEEDED :						return "Element Depth Limit Exceeded";
+		case 	adexml::Error::ATTRIBUTE_LIMIT_EXCEEDED :				return "Attribute Count Limit Exceeded";
+		case 	adexml::Error::NAME_LIMIT_EXCEEDED :						return "Name Length Limit Exceeded";
+		case 	adexml::Error::ATTRIBUTE_VALUE_LIMIT_EXCEEDED :	return "Attribute Value Size Limit Exceeded";
+		case 	adexml::Error::CONTENT_LIMIT_EXCEEDED :					return "Content Size Limit Exceeded";
+		case 	adexml::Error::DOCUMENT_LIMIT_EXCEEDED :				return "Document Size Limit Exceeded";
+		case 	adexml::Error::ENTITY_LIMIT_EXCEEDED :					return "Entity Expansion Limit Exceeded";
+		case 	adexml::Error::RECURSIVE_ENTITY :								return "Recursive Entity Reference";
+		case 	adexml::Error::INVALID_MARKUP_DECLARATION :			return "Invalid Markup Declaration";
+		case 	adexml::Error::DTD_SYNTAX_ERROR :								return "Syntax Error in DTD";
+		case 	adexml::Error::DTD_LIMIT_EXCEEDED :							return "DTD Size Limit Exceeded";
+		case 	adexml::Error::UNDECLARED_ELEMENT :							return "Undeclared Element";
+		case 	adexml::Error::INVALID_CONTENT :								return "Element Content Not Allowed by Content Model";
+		case 	adexml::Error::UNDECLARED_ATTRIBUTE :						return "Undeclared Attribute";
+		case 	adexml::Error::INVALID_ATTRIBUTE_VALUE :				return "Invalid Attribute Value";
+		case 	adexml::Error::MISSING_ATTRIBUTE :							return "Required Attribute Missing";
+		case 	adexml::Error::DUPLICATE_ID :										return "Duplicate ID";
+		case 	adexml::Error::PAUSED :													return "Parser Paused";
+		case 	adexml::Error::INVALID_CHECKPOINT :							return "Invalid or Incompatible Checkpoint";
+		case 	adexml::Error::INVALID_INDEX :									return "Invalid or Incompatible Index File";
+		case 	adexml::Error::CODEC_UNAVAILABLE :							return "Compression Codec Not Available";
+		case 	adexml::Error::DECOMPRESSION_ERROR :						return "Corrupt or Truncated Compressed Input";
+		case 	adexml::Error::INVALID_TAPE :										return "Invalid or Incompatible Event Tape";
 	}
 	return "(Unknown Error!)";
 }
@@ -28,7 +28,36 @@ enum class Error
 	ATTRIBUTE_DUPLICATE_NAME,
 	ELEMENT_TAG_MISMATCH,
 	INVALID_ENTITY_CHARACTER,
-	UNKNOWN_ENTITY
+	UNKNOWN_ENTITY,
+	INCOMPLETE_DOCUMENT,
+	QUERY_SYNTAX_ERROR,
+	VALUE_CONVERSION_ERROR,
+	VALUE_OUT_OF_RANGE,
+	ATTRIBUTE_NOT_FOUND,
+	OUT_OF_MEMORY,
+	DEPTH_LIMIT_EXCEEDED,
+	ATTRIBUTE_LIMIT_EXCEEDED,
+	NAME_LIMIT_EXCEEDED,
+	ATTRIBUTE_VALUE_LIMIT_EXCEEDED,
+	CONTENT_LIMIT_EXCEEDED,
+	DOCUMENT_LIMIT_EXCEEDED,
+	ENTITY_LIMIT_EXCEEDED,
+	RECURSIVE_ENTITY,
+	INVALID_MARKUP_DECLARATION,
+	DTD_SYNTAX_ERROR,
+	DTD_LIMIT_EXCEEDED,
+	UNDECLARED_ELEMENT,
+	INVALID_CONTENT,
+	UNDECLARED_ATTRIBUTE,
+	INVALID_ATTRIBUTE_VALUE,
+	MISSING_ATTRIBUTE,
+	DUPLICATE_ID,
+	PAUSED,
+	INVALID_CHECKPOINT,
+	INVALID_INDEX,
+	CODEC_UNAVAILABLE,
+	DECOMPRESSION_ERROR,
+	INVALID_TAPE
 };
 
 std::error_code make_error_code(adexml::Error);
@@ -0,0 +1,182 @@
+//=============================================================================
+//	FILE:					fanout.cpp
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "fanout.h"
+
+namespace adexml
+{
+
+//-----------------------------------------------------------------------------
+//	One consumer: its ring of batches and its thread. The parser thread owns
+//	"tail" and the consumer thread owns "head"; each slot belongs to whichever
+//	side the two counters say it does. A null batch ends the consumer.
+//-----------------------------------------------------------------------------
+struct FanOut::Consumer
+{
+	using Batch = std::shared_ptr<const Tape>;
+
+	Parser::Callback						callback;
+	Backpressure								backpressure;
+	TapePlayer									player;
+	std::vector<Batch>					slots;
+
+	alignas(64) std::atomic<std::uint64_t>	head {0};		// Next slot to read
+	alignas(64) std::atomic<std::uint64_t>	tail {0};		// Next slot to write
+
+	// Written by the consumer thread, read after it is joined.
+	ConsumerResult							result;
+	std::uint64_t								dropped = 0;		// Written by the parser thread
+	std::thread									thread;
+
+	Consumer(Parser::Callback cb, const ConsumerOptions & options)
+		: callback(std::move(cb))
+		, backpressure(options.backpressure)
+		, player(options.resource)
+		, slots(std::max<std::size_t>(1, options.queue_batches))
+	{}
+
+	bool
+	try_push(Batch & batch)
+	{
+		auto position = tail.load(std::memory_order_relaxed);
+		if(position - head.load(std::memory_order_acquire) == slots.size())
+			return false;
+
+		slots[position % slots.size()] = std::move(batch);
+		tail.store(position + 1, std::memory_order_release);
+		tail.notify_one();
+		return true;
+	}
+
+	void
+	push_wait(Batch batch)
+	{
+		while(!try_push(batch))
+		{
+			auto position = head.load(std::memory_order_acquire);
+			if(tail.load(std::memory_order_relaxed) - position == slots.size())
+				head.wait(position, std::memory_order_acquire);
+		}
+	}
+
+	Batch
+	pop_wait()
+	{
+		auto position = head.load(std::memory_order_relaxed);
+		while(tail.load(std::memory_order_acquire) == position)
+			tail.wait(position, std::memory_order_acquire);
+
+		auto batch = std::move(slots[position % slots.size()]);
+		head.store(position + 1, std::memory_order_release);
+		head.notify_one();
+		return batch;
+	}
+
+	void
+	run()
+	{
+		while(auto batch = pop_wait())
+		{
+			// After an error keep draining so that a blocked parser is released.
+			if(result.error)
+				continue;
+			result.error = player.play(*batch, callback);
+			if(!result.error)
+				result.delivered_events += batch->event_count();
+		}
+	}
+};
+
+FanOut::FanOut(const FanOutOptions & options)
+	: m_options(options)
+{
+}
+
+FanOut::~FanOut()
+{
+	finish();
+}
+
+std::size_t
+FanOut::add_consumer(Parser::Callback callback, const ConsumerOptions & options)
+{
+	auto & consumer = m_consumers.emplace_back(std::make_unique<Consumer>(std::move(callback), options));
+	if(m_b_finished)
+		consumer->result.error = make_error_code(Error::INVALID_STATE);
+	else
+		consumer->thread = std::thread([c = consumer.get()] {c->run();});
+	return m_consumers.size() - 1;
+}
+
+std::error_code
+FanOut::on_event(Parser::Action action, const String & path, const ElementStack & element_stack)
+{
+	if(m_b_finished)
+		return make_error_code(Error::INVALID_STATE);
+
+	if(auto ec = m_recorder.on_event(action, path, element_stack))
+		return ec;
+
+	// Publish at the end of each document as well as when the batch is full,
+	// so consumers are not left waiting on a quiet stream.
+	bool b_document_end = 	element_stack.size() == 1 &&
+													(action == Parser::ACTION_END_ELEMENT || (action == Parser::ACTION_START_ELEMENT && element_stack.back().b_closed));
+
+	if(b_document_end || m_recorder.event_count() >= m_options.batch_events)
+		flush();
+
+	return {};
+}
+
+void
+FanOut::flush()
+{
+	if(m_recorder.event_count() == 0)
+		return;
+
+	auto batch = std::make_shared<const Tape>(m_recorder.take());
+	for(auto & consumer : m_consumers)
+	{
+		auto shared = batch;
+		if(consumer->backpressure == Backpressure::BLOCK)
+			consumer->push_wait(std::move(shared));
+		else if(!consumer->try_push(shared))
+			consumer->dropped += batch->event_count();
+	}
+}
+
+std::vector<ConsumerResult>
+FanOut::finish()
+{
+	std::vector<ConsumerResult> results;
+
+	if(!m_b_finished)
+	{
+		flush();
+		for(auto & consumer : m_consumers)
+			consumer->push_wait(nullptr);
+		for(auto & consumer : m_consumers)
+			consumer->thread.join();
+		m_b_finished = true;
+	}
+
+	results.reserve(m_consumers.size());
+	for(auto & consumer : m_consumers)
+	{
+		results.push_back(consumer->result);
+		results.back().dropped_events = consumer->dropped;
+	}
+	return results;
+}
+
+} // namespace adexml
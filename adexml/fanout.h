@@ -0,0 +1,120 @@
+//=============================================================================
+//	FILE:					fanout.h
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Delivers the events of one parse to several independent consumers,
+//		each on its own thread.
+//
+//			adexml::FanOut	fanout;
+//			fanout.add_consumer(indexer.callback());
+//			fanout.add_consumer(statistics.callback(), {.backpressure = adexml::Backpressure::DROP});
+//			adexml::Parser	parser(fanout.callback());
+//			... write the document ...
+//			auto results = fanout.finish();
+//
+//		The parser thread records events into a tape (see tape.h). Every
+//		batch_events events, and at the end of each document, the tape is
+//		published to every consumer as one immutable, shared batch, so the
+//		strings are copied once however many consumers there are. Each
+//		consumer has a lock-free single producer, single consumer ring of
+//		batches and replays them to its callback with its own TapePlayer.
+//
+//		When a consumer's ring is full the parser either waits for it
+//		(BLOCK) or drops the batch for that consumer alone (DROP). Batches
+//		carry the elements open when they began, so a consumer that misses
+//		a batch resumes with the correct stack and path.
+//
+//		A consumer whose callback returns an error stops receiving events;
+//		the others carry on. The FanOut itself, including add_consumer(),
+//		must only be used from the parser's thread.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_FANOUT_H
+#define GUARD_ADE_XML_FANOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <system_error>
+#include <vector>
+#include "tape.h"
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+enum class Backpressure
+{
+	BLOCK,		// The parser waits for the consumer
+	DROP			// The consumer misses the batch
+};
+
+struct ConsumerOptions
+{
+	std::size_t									queue_batches = 16;				// Batches the consumer may fall behind by
+	Backpressure								backpressure 	= Backpressure::BLOCK;
+	std::pmr::memory_resource *	resource 			= std::pmr::get_default_resource();	// Used for the consumer's element stack
+};
+
+struct FanOutOptions
+{
+	std::size_t			batch_events 	= 512;		// Publish a batch once it holds this many events
+};
+
+struct ConsumerResult
+{
+	std::error_code		error;									// The first error the consumer's callback returned
+	std::uint64_t			delivered_events 	= 0;
+	std::uint64_t			dropped_events 		= 0;
+};
+
+class FanOut
+{
+private:
+	struct Consumer;
+
+	FanOutOptions														m_options;
+	TapeRecorder														m_recorder;
+	std::vector<std::unique_ptr<Consumer>>	m_consumers;
+	bool																		m_b_finished = false;
+
+public:
+	explicit FanOut(const FanOutOptions & options = {});
+	~FanOut();
+	FanOut(const FanOut &) = delete;
+	FanOut & operator=(const FanOut &) = delete;
+
+	//---------------------------------------------------------------------------
+	//	Start a consumer thread. A consumer added part way through a parse
+	//	receives the batches published from then on.
+	//---------------------------------------------------------------------------
+	std::size_t					add_consumer(Parser::Callback callback, const ConsumerOptions & options = {});
+	std::size_t					consumer_count() const	{return m_consumers.size();}
+
+	Parser::Callback		callback()		{return [this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);};}
+	std::error_code			on_event(Parser::Action action, const String & path, const ElementStack & element_stack);
+
+	//---------------------------------------------------------------------------
+	//	Publish the events recorded since the last batch.
+	//---------------------------------------------------------------------------
+	void								flush();
+
+	//---------------------------------------------------------------------------
+	//	Publish any remaining events, wait for every consumer to finish and
+	//	return one result per consumer, in the order they were added. Called
+	//	by the destructor if necessary.
+	//---------------------------------------------------------------------------
+	std::vector<ConsumerResult>	finish();
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_FANOUT_H
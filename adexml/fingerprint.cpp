@@ -0,0 +1,69 @@
+//=============================================================================
+//	FILE:					fingerprint.cpp
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include "fingerprint.h"
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+namespace
+{
+	constexpr std::u8string_view	SPACES = u8" \t\r\n";
+}
+
+std::uint64_t
+fingerprint_element(const Element & element, std::uint64_t children)
+{
+	Fingerprint fingerprint;
+	fingerprint.update(static_cast<std::uint64_t>(element.type));
+	fingerprint.update_string(element.name_space);
+	fingerprint.update_string(element.name);
+
+	// Attributes are summed so that their order does not matter.
+	std::uint64_t attributes = 0;
+	for(auto & [name, value] : element.attributes)
+	{
+		Fingerprint attribute;
+		attribute.update_string(name);
+		attribute.update_string(value);
+		attributes += attribute.value();
+	}
+	fingerprint.update(attributes);
+	fingerprint.update(static_cast<std::uint64_t>(element.attributes.size()));
+
+	// Text with whitespace runs collapsed to one space and trimmed.
+	std::u8string_view 	text = element.content;
+	std::uint64_t				text_bytes = 0;
+	for(std::size_t pos = 0;;)
+	{
+		pos = text.find_first_not_of(SPACES, pos);
+		if(pos == text.npos)
+			break;
+
+		auto end = std::min(text.find_first_of(SPACES, pos), text.size());
+
+		if(text_bytes)
+		{
+			fingerprint.update(std::u8string_view(u8" "));
+			++text_bytes;
+		}
+		fingerprint.update(text.substr(pos, end - pos));
+		text_bytes += end - pos;
+		pos = end;
+	}
+	fingerprint.update(text_bytes);
+
+	fingerprint.update(children);
+	return fingerprint.value();
+}
+
+} // namespace adexml
@@ -0,0 +1,148 @@
+//=============================================================================
+//	FILE:					fingerprint.h
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		64-bit content fingerprints of element subtrees, for detecting which
+//		records changed between two snapshots of a document.
+//
+//		An element's fingerprint covers its type, namespace prefix, name,
+//		attributes (independent of their order), text with runs of
+//		whitespace collapsed to a single space and trimmed, and the
+//		fingerprints of its children in order. Comments, processing
+//		instructions and the offsets of elements are not included, so
+//		reformatting a document leaves fingerprints unchanged.
+//
+//		The hash is a fast non-cryptographic one; it detects accidental
+//		change, not deliberate collisions. Input is read as little-endian
+//		words, so fingerprints are the same on every platform.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_FINGERPRINT_H
+#define GUARD_ADE_XML_FINGERPRINT_H
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace adexml
+{
+
+struct Element;
+
+class Fingerprint
+{
+private:
+	static constexpr std::uint64_t	PRIME_1 = 0x9E3779B185EBCA87ULL;
+	static constexpr std::uint64_t	PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+
+	std::uint64_t		m_state;
+	std::uint64_t		m_length 	= 0;
+	std::uint64_t		m_tail 		= 0;			// Bytes not yet making a whole word
+	unsigned				m_tail_bytes = 0;
+
+	void		round(std::uint64_t word)			{m_state = std::rotl(m_state ^ (word * PRIME_2), 31) * PRIME_1;}
+
+	static std::uint64_t
+	load(const char8_t * bytes)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, bytes, sizeof(word));
+		if constexpr (std::endian::native == std::endian::big)
+			word = std::byteswap(word);
+		return word;
+	}
+
+public:
+	explicit Fingerprint(std::uint64_t seed = 0) : m_state(seed ^ PRIME_1) {}
+
+	static constexpr std::uint64_t
+	mix(std::uint64_t value)
+	{
+		value ^= value >> 33;
+		value *= 0xFF51AFD7ED558CCDULL;
+		value ^= value >> 33;
+		value *= 0xC4CEB9FE1A85EC53ULL;
+		value ^= value >> 33;
+		return value;
+	}
+
+	void
+	update(std::u8string_view bytes)
+	{
+		m_length += bytes.size();
+
+		while(m_tail_bytes && !bytes.empty())
+		{
+			m_tail |= static_cast<std::uint64_t>(bytes.front()) << (8 * m_tail_bytes);
+			bytes.remove_prefix(1);
+			if(++m_tail_bytes == 8)
+			{
+				round(m_tail);
+				m_tail 				= 0;
+				m_tail_bytes 	= 0;
+			}
+		}
+
+		for(; bytes.size() >= 8; bytes.remove_prefix(8))
+			round(load(bytes.data()));
+
+		for(auto byte : bytes)
+			m_tail |= static_cast<std::uint64_t>(byte) << (8 * m_tail_bytes++);
+	}
+
+	void
+	update(std::uint64_t value)
+	{
+		if(m_tail_bytes == 0)
+		{
+			m_length += 8;
+			round(value);
+			return;
+		}
+
+		char8_t bytes[8];
+		for(auto & byte : bytes)
+		{
+			byte 		= static_cast<char8_t>(value);
+			value >>= 8;
+		}
+		update({bytes, 8});
+	}
+
+	void		update_string(std::u8string_view text)	{update(static_cast<std::uint64_t>(text.size())); update(text);}
+
+	std::uint64_t
+	value() const
+	{
+		auto state = m_tail_bytes ? std::rotl(m_state ^ (m_tail * PRIME_2), 31) * PRIME_1 : m_state;
+		return mix(state ^ m_length);
+	}
+};
+
+//-----------------------------------------------------------------------------
+//	Fold a child's fingerprint into the running value for its parent's
+//	children, which starts at 0. The order of children matters.
+//-----------------------------------------------------------------------------
+constexpr std::uint64_t
+combine_fingerprints(std::uint64_t children, std::uint64_t child)
+{
+	return Fingerprint::mix(std::rotl(children, 23) ^ child ^ 0x165667B19E3779F9ULL);
+}
+
+//-----------------------------------------------------------------------------
+//	The fingerprint of a complete element given the combined fingerprint of
+//	its children.
+//-----------------------------------------------------------------------------
+std::uint64_t		fingerprint_element(const Element & element, std::uint64_t children);
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_FINGERPRINT_H
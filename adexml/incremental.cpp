@@ -0,0 +1,392 @@
+//=============================================================================
+//	FILE:					incremental.cpp
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include "incremental.h"
+
+namespace adexml
+{
+
+IncrementalDocument::IncrementalDocument()
+	: m_parser([this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);})
+{
+}
+
+//-----------------------------------------------------------------------------
+//	Collect the elements of the fragment being parsed into m_fragment.
+//-----------------------------------------------------------------------------
+std::error_code
+IncrementalDocument::on_event(Parser::Action action, const String &, const ElementStack & element_stack)
+{
+	if(element_stack.empty())
+		return {};
+
+	const auto & element 	= element_stack.back();
+	const auto end 				= m_fragment_base + m_parser.offset() + 1;
+
+	if(action == Parser::ACTION_START_ELEMENT)
+	{
+		auto index 		= static_cast<NodeId>(m_fragment.size());
+		auto & node 	= m_fragment.emplace_back();
+		node.name_space.assign(element.name_space);
+		node.name.assign(element.name);
+		node.begin 		= m_fragment_base + element.offset;
+
+		node.attributes.reserve(element.attributes.size());
+		for(auto & [name, value] : element.attributes)
+			node.attributes.emplace_back(name, value);
+		std::sort(node.attributes.begin(), node.attributes.end());
+
+		if(m_fragment_stack.empty())
+			++m_fragment_roots;
+		else
+		{
+			node.parent = m_fragment_stack.back();
+			m_fragment[node.parent].children.push_back(index);
+		}
+
+		if(element.b_closed)
+			m_fragment[index].length = end - m_fragment[index].begin;
+		else
+			m_fragment_stack.push_back(index);
+	}
+	else if(action == Parser::ACTION_END_ELEMENT && !m_fragment_stack.empty())
+	{
+		auto & node = m_fragment[m_fragment_stack.back()];
+		node.content.assign(element.content);
+		node.length = end - node.begin;
+		m_fragment_stack.pop_back();
+	}
+
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	Parse m_text[begin, end) into m_fragment. A fragment must be exactly one
+//	element spanning the whole range.
+//-----------------------------------------------------------------------------
+std::error_code
+IncrementalDocument::parse(std::uint64_t begin, std::uint64_t end, bool b_document)
+{
+	m_parser.reset();
+	m_fragment.clear();
+	m_fragment_stack.clear();
+	m_fragment_roots 	= 0;
+	m_fragment_base		= begin;
+
+	try
+	{
+		if(!b_document && !m_entities.empty())
+			m_parser.entities() = m_entities;
+
+		auto ec = m_parser.write(std::span<const char8_t>(m_text.data() + begin, end - begin));
+		if(!ec)
+			ec = m_parser.finish();
+		if(ec)
+			return ec;
+	}
+	catch(const std::bad_alloc &)
+	{
+		return make_error_code(Error::OUT_OF_MEMORY);
+	}
+
+	if(m_fragment_roots == 0)
+		return make_error_code(Error::INCOMPLETE_DOCUMENT);
+	if(!b_document && (m_fragment_roots != 1 || m_fragment[0].begin != begin || m_fragment[0].length != end - begin))
+		return make_error_code(Error::FAILED);
+	return {};
+}
+
+IncrementalDocument::NodeId
+IncrementalDocument::allocate()
+{
+	if(m_free.empty())
+	{
+		m_nodes.emplace_back();
+		return static_cast<NodeId>(m_nodes.size() - 1);
+	}
+
+	auto id = m_free.back();
+	m_free.pop_back();
+	return id;
+}
+
+//-----------------------------------------------------------------------------
+//	Released ids are only returned to the free list once the edit is complete
+//	so that an id never appears as both removed and added.
+//-----------------------------------------------------------------------------
+void
+IncrementalDocument::release(NodeId id, EditResult & result)
+{
+	for(auto child : m_nodes[id].children)
+		release(child, result);
+
+	m_nodes[id] = {};
+	result.removed.push_back(id);
+}
+
+IncrementalDocument::NodeId
+IncrementalDocument::add(std::size_t fragment, NodeId parent, std::uint64_t parent_begin, EditResult & result)
+{
+	auto id 			= allocate();
+	auto & source = m_fragment[fragment];
+
+	{
+		auto & node 			= m_nodes[id];
+		node.name_space 	= std::move(source.name_space);
+		node.name 				= std::move(source.name);
+		node.attributes 	= std::move(source.attributes);
+		node.content 			= std::move(source.content);
+		node.begin 				= source.begin - parent_begin;
+		node.length 			= source.length;
+		node.parent 			= parent;
+		node.children.clear();
+	}
+
+	result.added.push_back(id);
+
+	for(auto child : source.children)
+	{
+		auto child_id = add(child, id, source.begin, result);
+		m_nodes[id].children.push_back(child_id);		// add() may have reallocated m_nodes
+	}
+
+	return id;
+}
+
+//-----------------------------------------------------------------------------
+//	Update node 'id', which began at 'old_begin' in the old text, from
+//	m_fragment[fragment]. Children outside the edited span are unchanged;
+//	those inside keep their ids while they have the same name in the same
+//	position.
+//-----------------------------------------------------------------------------
+void
+IncrementalDocument::merge(NodeId id, std::size_t fragment, std::uint64_t old_begin, std::uint64_t parent_begin, const Span & span, EditResult & result)
+{
+	auto & source 			= m_fragment[fragment];
+	bool b_changed 			= false;
+	std::vector<NodeId>	old_children;
+
+	{
+		auto & node = m_nodes[id];
+		b_changed = 	node.name_space != source.name_space || node.name != source.name ||
+									node.attributes != source.attributes || node.content != source.content ||
+									node.children.size() != source.children.size();
+
+		node.name_space 	= std::move(source.name_space);
+		node.name 				= std::move(source.name);
+		node.attributes 	= std::move(source.attributes);
+		node.content 			= std::move(source.content);
+		node.begin 				= source.begin - parent_begin;
+		node.length 			= source.length;
+		old_children 			= std::move(node.children);
+	}
+
+	auto old_child_begin = [&](std::size_t i) {return old_begin + m_nodes[old_children[i]].begin;};
+	auto new_child 			 = [&](std::size_t i) -> const Node & {return m_fragment[source.children[i]];};
+
+	// Leading children that end before the edit, at the same offsets.
+	std::size_t head 	= 0;
+	std::size_t count = std::min(old_children.size(), source.children.size());
+	while(head < count && old_child_begin(head) == new_child(head).begin && new_child(head).begin + new_child(head).length <= span.begin &&
+				old_child_begin(head) + m_nodes[old_children[head]].length <= span.begin)
+		++head;
+
+	// Trailing children that start after the edit, moved by the same amount.
+	std::size_t tail = 0;
+	while(tail < count - head)
+	{
+		auto old_index = old_children.size() - 1 - tail;
+		auto new_index = source.children.size() - 1 - tail;
+		if(old_child_begin(old_index) < span.old_end || new_child(new_index).begin < span.new_end ||
+			 old_child_begin(old_index) - span.old_end != new_child(new_index).begin - span.new_end)
+			break;
+		++tail;
+	}
+
+	std::vector<NodeId> children(old_children.begin(), old_children.begin() + head);
+	children.reserve(source.children.size());
+
+	for(std::size_t i = head; i < source.children.size() - tail; ++i)
+	{
+		auto & child 	= new_child(i);
+		bool b_match 	= 	i < old_children.size() - tail && m_nodes[old_children[i]].name == child.name &&
+											m_nodes[old_children[i]].name_space == child.name_space;
+
+		if(b_match)
+		{
+			merge(old_children[i], source.children[i], old_child_begin(i), source.begin, span, result);
+			children.push_back(old_children[i]);
+			continue;
+		}
+
+		if(i < old_children.size() - tail)
+			release(old_children[i], result);
+		children.push_back(add(source.children[i], id, source.begin, result));
+		b_changed = true;
+	}
+
+	for(std::size_t i = source.children.size() - tail; i < old_children.size() - tail; ++i)
+		release(old_children[i], result);
+
+	for(std::size_t i = old_children.size() - tail; i < old_children.size(); ++i)
+	{
+		m_nodes[old_children[i]].begin = new_child(source.children.size() - old_children.size() + i).begin - source.begin;
+		children.push_back(old_children[i]);
+	}
+
+	m_nodes[id].children = std::move(children);
+
+	if(b_changed)
+		result.changed.push_back(id);
+}
+
+std::uint64_t
+IncrementalDocument::begin(NodeId id) const
+{
+	std::uint64_t offset = 0;
+	for(; id != NO_NODE; id = m_nodes[id].parent)
+		offset += m_nodes[id].begin;
+	return offset;
+}
+
+//-----------------------------------------------------------------------------
+//	The deepest element that contains [begin, end) without touching its first
+//	or last byte, or NO_NODE.
+//-----------------------------------------------------------------------------
+IncrementalDocument::NodeId
+IncrementalDocument::enclosing(std::uint64_t begin, std::uint64_t end) const
+{
+	auto contains = [&](NodeId id, std::uint64_t node_begin)
+		{
+			return node_begin < begin && end < node_begin + m_nodes[id].length;
+		};
+
+	if(m_root == NO_NODE || !contains(m_root, m_nodes[m_root].begin))
+		return NO_NODE;
+
+	auto id 				= m_root;
+	auto id_begin 	= m_nodes[m_root].begin;
+
+	for(;;)
+	{
+		// Children are in document order, so the candidate is the last one
+		// that starts before the edit.
+		auto & children = m_nodes[id].children;
+		auto it = std::partition_point(children.begin(), children.end(), [&](NodeId child) {return id_begin + m_nodes[child].begin < begin;});
+		if(it == children.begin())
+			return id;
+
+		auto child 				= *std::prev(it);
+		auto child_begin 	= id_begin + m_nodes[child].begin;
+		if(!contains(child, child_begin))
+			return id;
+
+		id 				= child;
+		id_begin 	= child_begin;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	Apply a change of 'delta' bytes inside node 'id' to its ancestors and to
+//	the siblings that follow it and them.
+//-----------------------------------------------------------------------------
+void
+IncrementalDocument::shift(NodeId id, std::int64_t delta)
+{
+	for(auto parent = m_nodes[id].parent; parent != NO_NODE; id = parent, parent = m_nodes[parent].parent)
+	{
+		auto & node 		= m_nodes[parent];
+		node.length 	 += delta;
+
+		auto position 	= m_nodes[id].begin;
+		auto it 				= std::upper_bound(node.children.begin(), node.children.end(), position, [&](std::uint64_t value, NodeId child) {return value < m_nodes[child].begin;});
+		for(; it != node.children.end(); ++it)
+			m_nodes[*it].begin += delta;
+	}
+}
+
+std::error_code
+IncrementalDocument::load(std::u8string text)
+{
+	m_text = std::move(text);
+	m_nodes.clear();
+	m_free.clear();
+	m_root 		= NO_NODE;
+	m_b_valid = false;
+	m_entities.clear();
+
+	return edit({.offset = 0, .removed = 0, .inserted = {}}).error;
+}
+
+IncrementalDocument::EditResult
+IncrementalDocument::edit(const Edit & edit)
+{
+	EditResult result;
+
+	if(edit.offset > m_text.size() || edit.removed > m_text.size() - edit.offset)
+	{
+		result.error = std::make_error_code(std::errc::invalid_argument);
+		return result;
+	}
+
+	// Find the element to reparse in the tree as it was before the edit.
+	auto target = m_b_valid ? enclosing(edit.offset, edit.offset + edit.removed) : NO_NODE;
+	auto delta 	= static_cast<std::int64_t>(edit.inserted.size()) - static_cast<std::int64_t>(edit.removed);
+
+	// A stale tree has no offsets to trust, and an edit before the root may
+	// change entity declarations, so in those cases nothing is outside the
+	// span and every element is compared.
+	Span span {edit.offset, edit.offset + edit.removed, edit.offset + edit.inserted.size()};
+	if(!m_b_valid || edit.offset < m_nodes[m_root].begin)
+		span = {0, UINT64_MAX, UINT64_MAX};
+
+	m_text.replace(edit.offset, edit.removed, edit.inserted);
+
+	for(; target != NO_NODE; target = m_nodes[target].parent)
+	{
+		auto begin 	= this->begin(target);
+		auto end 		= begin + m_nodes[target].length + delta;
+		if(parse(begin, end, false))
+			continue;
+
+		auto parent = m_nodes[target].parent;
+		merge(target, 0, begin, parent == NO_NODE ? 0 : this->begin(parent), span, result);
+		shift(target, delta);
+		result.reparsed 			= target;
+		result.reparsed_bytes = end - begin;
+		break;
+	}
+
+	if(target == NO_NODE)
+	{
+		if(auto ec = parse(0, m_text.size(), true))
+		{
+			m_b_valid 		= false;
+			result.error 	= ec;
+			return result;
+		}
+
+		if(m_root == NO_NODE)
+			m_root = add(0, NO_NODE, 0, result);
+		else
+			merge(m_root, 0, m_nodes[m_root].begin, 0, span, result);
+
+		m_entities 						= m_parser.entities();
+		m_b_valid 						= true;
+		result.reparsed 			= m_root;
+		result.reparsed_bytes = m_text.size();
+	}
+
+	m_free.insert(m_free.end(), result.removed.begin(), result.removed.end());
+	return result;
+}
+
+} // namespace adexml
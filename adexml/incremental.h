@@ -0,0 +1,168 @@
+//=============================================================================
+//	FILE:					incremental.h
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		A document kept as text plus an element tree that is brought up to
+//		date after each edit by reparsing only the smallest element the edit
+//		lies inside.
+//
+//			adexml::IncrementalDocument	document;
+//			document.load(text);
+//			auto result = document.edit({.offset = 120, .removed = 3, .inserted = u8"new"});
+//			for(auto id : result.changed) ...
+//
+//		Between tags the parser's state is fully described by the open
+//		elements, which the tree already holds, and the entity declarations,
+//		which are kept from the last full parse. An element can therefore be
+//		reparsed on its own as a fragment without saving checkpoints at
+//		element boundaries.
+//
+//		An edit is confined to an element when it lies strictly inside it,
+//		not touching the '<' that begins it or the '>' that ends it. The
+//		element is reparsed; if the result is not a single complete element
+//		spanning the same text (the edit added a tag, or broke one) its
+//		parent is tried, and so on up to a full parse. Edits outside the
+//		root element, for example to the DOCTYPE, also reparse in full.
+//
+//		Children that lie wholly before or after the edit are the same
+//		elements as before and are kept as they are, only their offsets
+//		moving. The rest of the new subtree is matched against the old one
+//		child by child, by position and name, so unchanged elements keep
+//		their ids. The result lists the nodes whose name, attributes, text
+//		or children changed, and the nodes added and removed.
+//
+//		Node offsets are stored relative to the parent, so after an edit
+//		only the edited element, its ancestors and the siblings that follow
+//		them are updated. Cost is proportional to the size of the reparsed
+//		element plus depth and trailing siblings, not the document.
+//
+//		If an edit leaves the document malformed the text is still updated,
+//		the error is returned and the tree keeps its previous contents (with
+//		stale offsets) until an edit makes the document well formed again.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_INCREMENTAL_H
+#define GUARD_ADE_XML_INCREMENTAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "entity.h"
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+class IncrementalDocument
+{
+public:
+	using NodeId = std::uint32_t;
+	static constexpr NodeId	NO_NODE = static_cast<NodeId>(-1);
+
+	struct Node
+	{
+		std::u8string																			name_space;
+		std::u8string																			name;
+		std::vector<std::pair<std::u8string, std::u8string>>	attributes;				// Sorted by name
+		std::u8string																			content;
+		std::uint64_t																			begin 	= 0;			// Offset of '<' from the parent's, or in the text for the root
+		std::uint64_t																			length 	= 0;			// Bytes up to and including the final '>'
+		NodeId																						parent 	= NO_NODE;
+		std::vector<NodeId>																children;
+	};
+
+	struct Edit
+	{
+		std::uint64_t				offset 	= 0;
+		std::uint64_t				removed	= 0;
+		std::u8string_view	inserted;
+	};
+
+	struct EditResult
+	{
+		std::error_code				error;
+		NodeId								reparsed 				= NO_NODE;		// Root of the reparsed subtree
+		std::uint64_t					reparsed_bytes	= 0;
+		std::vector<NodeId>		changed;
+		std::vector<NodeId>		added;
+		std::vector<NodeId>		removed;
+	};
+
+private:
+	//---------------------------------------------------------------------------
+	//	The edited range, as [begin, old_end) in the old text and [begin,
+	//	new_end) in the new.
+	//---------------------------------------------------------------------------
+	struct Span
+	{
+		std::uint64_t		begin 	= 0;
+		std::uint64_t		old_end = 0;
+		std::uint64_t		new_end = 0;
+	};
+
+	std::u8string					m_text;
+	std::vector<Node>			m_nodes;							// Indexed by NodeId; freed slots are reused
+	std::vector<NodeId>		m_free;
+	NodeId								m_root 		= NO_NODE;
+	bool									m_b_valid = false;		// The tree matches the text
+	EntityTable						m_entities;						// Declared by the DOCTYPE at the last full parse
+	Parser								m_parser;
+
+	// The fragment being parsed, with offsets in the text.
+	std::vector<Node>			m_fragment;
+	std::vector<NodeId>		m_fragment_stack;
+	std::size_t						m_fragment_roots 	= 0;
+	std::uint64_t					m_fragment_base		= 0;
+
+	std::error_code				on_event(Parser::Action action, const String & path, const ElementStack & element_stack);
+	std::error_code				parse(std::uint64_t begin, std::uint64_t end, bool b_document);
+	NodeId								allocate();
+	void									release(NodeId id, EditResult & result);
+	NodeId								add(std::size_t fragment, NodeId parent, std::uint64_t parent_begin, EditResult & result);
+	void									merge(NodeId id, std::size_t fragment, std::uint64_t old_begin, std::uint64_t parent_begin, const Span & span, EditResult & result);
+	NodeId								enclosing(std::uint64_t begin, std::uint64_t end) const;
+	void									shift(NodeId id, std::int64_t delta);
+
+public:
+	IncrementalDocument();
+	IncrementalDocument(const IncrementalDocument &) = delete;
+	IncrementalDocument & operator=(const IncrementalDocument &) = delete;
+
+	//---------------------------------------------------------------------------
+	//	Replace the text and parse it in full.
+	//---------------------------------------------------------------------------
+	std::error_code				load(std::u8string text);
+
+	//---------------------------------------------------------------------------
+	//	Apply an edit to the text and bring the tree up to date.
+	//---------------------------------------------------------------------------
+	EditResult						edit(const Edit & edit);
+
+	std::u8string_view		text() const					{return m_text;}
+	bool									is_valid() const			{return m_b_valid;}
+	NodeId								root() const					{return m_root;}
+	const Node &					node(NodeId id) const	{return m_nodes[id];}
+	std::size_t						node_count() const		{return m_nodes.size() - m_free.size();}
+
+	//---------------------------------------------------------------------------
+	//	Offsets in the text of a node's '<' and of the byte after its '>'.
+	//	O(depth).
+	//---------------------------------------------------------------------------
+	std::uint64_t					begin(NodeId id) const;
+	std::uint64_t					end(NodeId id) const	{return begin(id) + m_nodes[id].length;}
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_INCREMENTAL_H
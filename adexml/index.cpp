@@ -0,0 +1,379 @@
+//=============================================================================
+//	FILE:					index.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		File layout. All integers are little endian.
+//
+//			header		magic "ADEXMLIX", u32 version, u32 spec count,
+//								u64 entry count, u64 key pool size
+//			specs			per spec: u32 path length, path, u32 key length, key
+//			entries		ENTRY_SIZE bytes each, sorted by spec, key and begin:
+//								u64 begin, u64 end, u64 key offset, u32 key length,
+//								u16 spec, u16 depth
+//			keys			key pool
+//=============================================================================
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "index.h"
+
+namespace adexml
+{
+
+namespace
+{
+
+constexpr std::uint8_t		INDEX_MAGIC[8]	= {'A','D','E','X','M','L','I','X'};
+constexpr std::uint32_t		INDEX_VERSION		= 1;
+constexpr std::size_t			HEADER_SIZE			= 32;
+constexpr std::size_t			ENTRY_SIZE			= 32;
+constexpr std::size_t			MAX_SPECS				= 0xFFFF;
+
+template<typename T>
+void
+store(std::vector<std::byte> & out, T value)
+{
+	for(std::size_t i = 0; i < sizeof(T); ++i)
+		out.push_back(static_cast<std::byte>(static_cast<std::uint64_t>(value) >> (i * 8)));
+}
+
+template<typename T>
+T
+load(const std::byte * in)
+{
+	std::uint64_t value = 0;
+	for(std::size_t i = 0; i < sizeof(T); ++i)
+		value |= static_cast<std::uint64_t>(in[i]) << (i * 8);
+	return static_cast<T>(value);
+}
+
+void
+store_string(std::vector<std::byte> & out, std::u8string_view text)
+{
+	store<std::uint32_t>(out, static_cast<std::uint32_t>(text.size()));
+	for(auto ch : text)
+		out.push_back(static_cast<std::byte>(ch));
+}
+
+std::u8string_view
+as_string(const std::byte * data, std::size_t size)
+{
+	return {reinterpret_cast<const char8_t *>(data), size};
+}
+
+} // namespace
+
+
+//=============================================================================
+//
+//	INDEX BUILDER
+//
+//=============================================================================
+
+IndexBuilder::IndexBuilder(std::vector<IndexSpec> specs)
+	: m_specs(std::move(specs))
+{
+	m_specs.resize(std::min(m_specs.size(), MAX_SPECS));
+	for(std::size_t i = 0; i < m_specs.size(); ++i)
+		m_paths.emplace(m_specs[i].path, static_cast<std::uint16_t>(i));
+}
+
+void
+IndexBuilder::attach(Parser & parser)
+{
+	m_parser = &parser;
+	parser.set_callback([this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);});
+}
+
+void
+IndexBuilder::clear()
+{
+	m_keys.clear();
+	m_entries.clear();
+	m_open.clear();
+}
+
+std::error_code
+IndexBuilder::on_event(Parser::Action action, const String & path, const ElementStack & element_stack)
+{
+	if(element_stack.empty() || m_parser == nullptr)
+		return {};
+
+	const auto & element 	= element_stack.back();
+	const auto 	 depth		= element_stack.size();
+
+	switch(action)
+	{
+		case Parser::ACTION_START_ELEMENT :
+		{
+			auto it_spec = m_paths.find(std::u8string_view(path));
+			if(it_spec == m_paths.end())
+				break;
+
+			auto spec 		= it_spec->second;
+			auto it_key 	= element.attributes.find(std::u8string_view(m_specs[spec].key));
+			if(it_key == element.attributes.end())
+				break;
+
+			m_entries.push_back({	element.offset, 0, m_keys.size(), static_cast<std::uint32_t>(it_key->second.size()),
+														spec, static_cast<std::uint16_t>(std::min<std::size_t>(depth, 0xFFFF)) });
+			m_keys.append(it_key->second);
+
+			if(element.b_closed)
+				m_entries.back().end = m_parser->offset() + 1;
+			else
+				m_open.push_back(m_entries.size() - 1);
+			break;
+		}
+
+		case Parser::ACTION_END_ELEMENT :
+			// Indexed elements may nest, so only the innermost open entry
+			// can be closed, and only by its own end tag.
+			if(!m_open.empty() && m_entries[m_open.back()].begin == element.offset)
+			{
+				m_entries[m_open.back()].end = m_parser->offset() + 1;
+				m_open.pop_back();
+			}
+			break;
+
+		default :
+			break;
+	}
+	return {};
+}
+
+std::error_code
+IndexBuilder::save(const std::filesystem::path & file)
+{
+	if(!m_open.empty())
+		return make_error_code(Error::INCOMPLETE_DOCUMENT);
+
+	auto key = [this](const Entry & entry) {return std::u8string_view(m_keys).substr(entry.key_offset, entry.key_length);};
+	std::ranges::stable_sort(m_entries, [&](const Entry & a, const Entry & b)
+		{
+			if(a.spec != b.spec)
+				return a.spec < b.spec;
+			return key(a) < key(b);
+		});
+
+	std::vector<std::byte> out;
+	out.reserve(HEADER_SIZE + m_entries.size() * ENTRY_SIZE + m_keys.size());
+
+	for(auto ch : INDEX_MAGIC)
+		out.push_back(static_cast<std::byte>(ch));
+	store<std::uint32_t>(out, INDEX_VERSION);
+	store<std::uint32_t>(out, static_cast<std::uint32_t>(m_specs.size()));
+	store<std::uint64_t>(out, m_entries.size());
+	store<std::uint64_t>(out, m_keys.size());
+
+	for(const auto & spec : m_specs)
+	{
+		store_string(out, spec.path);
+		store_string(out, spec.key);
+	}
+
+	for(const auto & entry : m_entries)
+	{
+		store<std::uint64_t>(out, entry.begin);
+		store<std::uint64_t>(out, entry.end);
+		store<std::uint64_t>(out, entry.key_offset);
+		store<std::uint32_t>(out, entry.key_length);
+		store<std::uint16_t>(out, entry.spec);
+		store<std::uint16_t>(out, entry.depth);
+	}
+
+	for(auto ch : m_keys)
+		out.push_back(static_cast<std::byte>(ch));
+
+	std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+	if(!stream)
+		return std::make_error_code(std::errc::io_error);
+	stream.write(reinterpret_cast<const char *>(out.data()), static_cast<std::streamsize>(out.size()));
+	if(!stream)
+		return std::make_error_code(std::errc::io_error);
+	return {};
+}
+
+
+//=============================================================================
+//
+//	ELEMENT INDEX
+//
+//=============================================================================
+
+std::expected<ElementIndex, std::error_code>
+ElementIndex::open(const std::filesystem::path & file)
+{
+	std::error_code ec;
+	auto 						size = std::filesystem::file_size(file, ec);
+	if(ec)
+		return std::unexpected(ec);
+
+	ElementIndex index;
+	index.m_data.resize(size);
+
+	std::ifstream stream(file, std::ios::binary);
+	if(!stream || !stream.read(reinterpret_cast<char *>(index.m_data.data()), static_cast<std::streamsize>(size)))
+		return std::unexpected(std::make_error_code(std::errc::io_error));
+
+	const auto invalid 	= std::unexpected(make_error_code(Error::INVALID_INDEX));
+	const auto * data 	= index.m_data.data();
+
+	if(size < HEADER_SIZE || std::memcmp(data, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || load<std::uint32_t>(data + 8) != INDEX_VERSION)
+		return invalid;
+
+	auto spec_count 	= load<std::uint32_t>(data + 12);
+	auto entry_count	= load<std::uint64_t>(data + 16);
+	auto keys_size		= load<std::uint64_t>(data + 24);
+
+	std::size_t pos = HEADER_SIZE;
+	auto read_string = [&](std::u8string & out)
+		{
+			if(size - pos < 4)
+				return false;
+			auto length = load<std::uint32_t>(data + pos);
+			pos += 4;
+			if(size - pos < length)
+				return false;
+			out.assign(as_string(data + pos, length));
+			pos += length;
+			return true;
+		};
+
+	index.m_specs.resize(spec_count);
+	for(auto & spec : index.m_specs)
+		if(!read_string(spec.path) || !read_string(spec.key))
+			return invalid;
+
+	if(entry_count > (size - pos) / ENTRY_SIZE || keys_size != size - pos - entry_count * ENTRY_SIZE)
+		return invalid;
+
+	index.m_entries_offset 	= pos;
+	index.m_entry_count			= entry_count;
+	index.m_keys_offset			= pos + entry_count * ENTRY_SIZE;
+
+	for(std::size_t i = 0; i < entry_count; ++i)
+	{
+		auto record = data + index.m_entries_offset + i * ENTRY_SIZE;
+		auto key_offset = load<std::uint64_t>(record + 16);
+		auto key_length	= load<std::uint32_t>(record + 24);
+		if(	key_offset > keys_size || key_length > keys_size - key_offset ||
+				load<std::uint16_t>(record + 28) >= spec_count || load<std::uint64_t>(record + 8) < load<std::uint64_t>(record) )
+			return invalid;
+	}
+
+	return index;
+}
+
+std::u8string_view
+ElementIndex::key(std::size_t entry) const
+{
+	auto record = m_data.data() + m_entries_offset + entry * ENTRY_SIZE;
+	return as_string(m_data.data() + m_keys_offset + load<std::uint64_t>(record + 16), load<std::uint32_t>(record + 24));
+}
+
+std::uint16_t
+ElementIndex::spec(std::size_t entry) const
+{
+	return load<std::uint16_t>(m_data.data() + m_entries_offset + entry * ENTRY_SIZE + 28);
+}
+
+IndexEntry
+ElementIndex::entry(std::size_t entry) const
+{
+	auto record = m_data.data() + m_entries_offset + entry * ENTRY_SIZE;
+	return {load<std::uint64_t>(record), load<std::uint64_t>(record + 8), load<std::uint16_t>(record + 30)};
+}
+
+std::pair<std::size_t, std::size_t>
+ElementIndex::equal_range(std::u8string_view path, std::u8string_view key_value) const
+{
+	auto it_spec = std::ranges::find(m_specs, path, [](const IndexSpec & spec) {return std::u8string_view(spec.path);});
+	if(it_spec == m_specs.end())
+		return {0, 0};
+	auto spec_index = static_cast<std::uint16_t>(it_spec - m_specs.begin());
+
+	// Entries are ordered by (spec, key); find the first not less than the
+	// target and the first greater than it.
+	auto bound = [&](bool b_upper)
+		{
+			std::size_t low = 0, high = m_entry_count;
+			while(low < high)
+			{
+				auto mid 		= low + (high - low) / 2;
+				auto s			= spec(mid);
+				bool b_less	= s < spec_index || (s == spec_index && (b_upper ? key(mid) <= key_value : key(mid) < key_value));
+				if(b_less)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			return low;
+		};
+
+	return {bound(false), bound(true)};
+}
+
+std::optional<IndexEntry>
+ElementIndex::find(std::u8string_view path, std::u8string_view key_value) const
+{
+	auto [first, last] = equal_range(path, key_value);
+	if(first == last)
+		return std::nullopt;
+	return entry(first);
+}
+
+std::vector<IndexEntry>
+ElementIndex::find_all(std::u8string_view path, std::u8string_view key_value) const
+{
+	auto [first, last] = equal_range(path, key_value);
+	std::vector<IndexEntry> entries;
+	entries.reserve(last - first);
+	for(auto i = first; i < last; ++i)
+		entries.push_back(entry(i));
+	return entries;
+}
+
+
+//=============================================================================
+//
+//	RECORD ACCESS
+//
+//=============================================================================
+
+std::expected<std::vector<char8_t>, std::error_code>
+read_record(const std::filesystem::path & file, const IndexEntry & entry)
+{
+	std::ifstream stream(file, std::ios::binary);
+	if(!stream)
+		return std::unexpected(std::make_error_code(std::errc::io_error));
+
+	std::vector<char8_t> bytes(entry.size());
+	if(	!stream.seekg(static_cast<std::streamoff>(entry.begin)) ||
+			!stream.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size())) )
+		return std::unexpected(std::make_error_code(std::errc::io_error));
+
+	return bytes;
+}
+
+std::error_code
+parse_record(const std::filesystem::path & file, const IndexEntry & entry, Parser & parser)
+{
+	auto bytes = read_record(file, entry);
+	if(!bytes)
+		return bytes.error();
+
+	parser.reset();
+	if(auto ec = parser.write(std::span<const char8_t>(bytes->data(), bytes->size())))
+		return ec;
+	return parser.finish();
+}
+
+} // namespace adexml
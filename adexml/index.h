@@ -0,0 +1,160 @@
+//=============================================================================
+//	FILE:					index.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Persistent element offset index for random access into large files.
+//
+//			adexml::IndexBuilder builder({{u8"export/customer", u8"id"}});
+//			adexml::Parser parser(nullptr);
+//			builder.attach(parser);
+//			... write the whole file to the parser ...
+//			builder.save("export.xml.idx");
+//
+//			auto index 	= adexml::ElementIndex::open("export.xml.idx");
+//			auto entry 	= index->find(u8"export/customer", u8"C1234");
+//			adexml::parse_record("export.xml", *entry, record_parser);
+//
+//		The index file holds a fixed-width record per element, sorted by path
+//		and key, followed by a pool of the key strings. Lookups are a binary
+//		search over the records. A record's byte range covers the element from
+//		the '<' of its start tag to the '>' of its end tag, so it can be parsed
+//		on its own. Entities declared in the file's DOCTYPE are not known to
+//		the record parser unless they are declared on it through entities().
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_INDEX_H
+#define GUARD_ADE_XML_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+//-----------------------------------------------------------------------------
+//	Index every element at 'path' (in Parser path form, "a/b/c") by the value
+//	of its 'key' attribute. Elements without the attribute are not indexed.
+//-----------------------------------------------------------------------------
+struct IndexSpec
+{
+	std::u8string		path;
+	std::u8string		key;
+};
+
+struct IndexEntry
+{
+	std::uint64_t		begin	= 0;		// Offset of the start tag's '<'
+	std::uint64_t		end		= 0;		// One past the end tag's '>'
+	std::uint32_t		depth	= 0;		// 1 for the document element
+
+	std::uint64_t		size() const	{return end - begin;}
+};
+
+//=============================================================================
+//
+//	INDEX BUILDER
+//
+//=============================================================================
+
+class IndexBuilder
+{
+private:
+	struct Entry
+	{
+		std::uint64_t		begin;
+		std::uint64_t		end;
+		std::uint64_t		key_offset;
+		std::uint32_t		key_length;
+		std::uint16_t		spec;
+		std::uint16_t		depth;
+	};
+
+	std::vector<IndexSpec>																							m_specs;
+	std::unordered_map<std::u8string, std::uint16_t, StringHash, StringEqual>	m_paths;
+	std::u8string									m_keys;					// Pool of key values
+	std::vector<Entry>						m_entries;
+	std::vector<std::size_t>			m_open;					// Entries whose end tag has not been seen
+	const Parser *								m_parser = nullptr;
+
+public:
+	explicit IndexBuilder(std::vector<IndexSpec> specs);
+
+	//---------------------------------------------------------------------------
+	//	attach() installs the builder as the parser's callback; element ranges
+	//	are taken from the parser's input offsets. The builder must outlive the
+	//	parser.
+	//---------------------------------------------------------------------------
+	void							attach(Parser & parser);
+	std::error_code		on_event(Parser::Action action, const String & path, const ElementStack & element_stack);
+
+	std::size_t				size() const		{return m_entries.size();}
+	void							clear();
+
+	//---------------------------------------------------------------------------
+	//	Sort the entries and write the index file.
+	//---------------------------------------------------------------------------
+	std::error_code		save(const std::filesystem::path & file);
+};
+
+//=============================================================================
+//
+//	ELEMENT INDEX
+//
+//=============================================================================
+
+class ElementIndex
+{
+private:
+	std::vector<std::byte>				m_data;
+	std::vector<IndexSpec>				m_specs;
+	std::size_t										m_entries_offset 	= 0;
+	std::size_t										m_entry_count			= 0;
+	std::size_t										m_keys_offset			= 0;
+
+	ElementIndex() = default;
+
+	std::u8string_view		key(std::size_t entry) const;
+	std::uint16_t					spec(std::size_t entry) const;
+	IndexEntry						entry(std::size_t entry) const;
+	std::pair<std::size_t, std::size_t>	equal_range(std::u8string_view path, std::u8string_view key) const;
+
+public:
+	static std::expected<ElementIndex, std::error_code>	open(const std::filesystem::path & file);
+
+	const std::vector<IndexSpec> &	specs() const		{return m_specs;}
+	std::size_t											size() const		{return m_entry_count;}
+
+	//---------------------------------------------------------------------------
+	//	find() returns the first element (in document order) with the key;
+	//	find_all() returns every element with it.
+	//---------------------------------------------------------------------------
+	std::optional<IndexEntry>				find(std::u8string_view path, std::u8string_view key) const;
+	std::vector<IndexEntry>					find_all(std::u8string_view path, std::u8string_view key) const;
+};
+
+//-----------------------------------------------------------------------------
+//	Read the bytes of an indexed element from 'file', or reset 'parser' and
+//	parse them as a complete document.
+//-----------------------------------------------------------------------------
+std::expected<std::vector<char8_t>, std::error_code>	read_record(const std::filesystem::path & file, const IndexEntry & entry);
+std::error_code																				parse_record(const std::filesystem::path & file, const IndexEntry & entry, Parser & parser);
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_INDEX_H
@@ -0,0 +1,335 @@
+//=============================================================================
+//	FILE:					json.cpp
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <array>
+#include "json.h"
+
+namespace adexml
+{
+
+namespace
+{
+	//---------------------------------------------------------------------------
+	//	The character to write after '\' for each byte, or 0 to copy the byte.
+	//	'u' is written as \u00XX.
+	//---------------------------------------------------------------------------
+	constexpr std::array<char8_t, 256>	JSON_ESCAPE = []
+		{
+			std::array<char8_t, 256> table {};
+			for(std::size_t i = 0; i < 0x20; ++i)
+				table[i] = u8'u';
+			table[u8'\b'] = u8'b';
+			table[u8'\f'] = u8'f';
+			table[u8'\n'] = u8'n';
+			table[u8'\r'] = u8'r';
+			table[u8'\t'] = u8't';
+			table[u8'"']	= u8'"';
+			table[u8'\\'] = u8'\\';
+			return table;
+		}();
+
+	std::u8string_view
+	trim_text(std::u8string_view text)
+	{
+		auto end = text.find_last_not_of(u8" \t\r\n");
+		return end == std::u8string_view::npos ? std::u8string_view{} : text.substr(0, end + 1);
+	}
+}
+
+void
+append_json_escaped(std::u8string & out, std::u8string_view text)
+{
+	static constexpr char8_t HEX[] = u8"0123456789abcdef";
+
+	auto pos = text.data();
+	auto end = pos + text.size();
+
+	while(pos < end)
+	{
+		// Copy the run of bytes that need no escaping in one go.
+		auto run = pos;
+		while(run < end && !JSON_ESCAPE[*run])
+			++run;
+		out.append(pos, run);
+		if(run == end)
+			break;
+
+		auto escape = JSON_ESCAPE[*run];
+		out.push_back(u8'\\');
+		out.push_back(escape);
+		if(escape == u8'u')
+		{
+			out.append(u8"00");
+			out.push_back(HEX[*run >> 4]);
+			out.push_back(HEX[*run & 0x0F]);
+		}
+		pos = run + 1;
+	}
+}
+
+//=============================================================================
+//
+//	CONVERTER
+//
+//=============================================================================
+
+JsonConverter::JsonConverter(JsonOptions options, Sink sink)
+	: m_options(std::move(options))
+	, m_sink(std::move(sink))
+	, m_array_paths(m_options.array_paths.begin(), m_options.array_paths.end())
+{
+}
+
+void
+JsonConverter::clear()
+{
+	m_buffer.clear();
+	m_depth 				= 0;
+	m_record_depth 	= 0;
+	m_lines 				= 0;
+}
+
+JsonConverter::Level &
+JsonConverter::push_level()
+{
+	if(m_depth == m_levels.size())
+		m_levels.emplace_back();
+
+	auto & level = m_levels[m_depth++];
+	level.last_child.clear();
+	level.value_position 	= NO_POSITION;
+	level.b_object 				= false;
+	level.b_members 			= false;
+	level.b_array 				= false;
+	return level;
+}
+
+void
+JsonConverter::open_object(Level & level)
+{
+	if(!level.b_object)
+	{
+		m_buffer.push_back(u8'{');
+		level.b_object = true;
+	}
+}
+
+void
+JsonConverter::append_key(std::u8string_view prefix, std::u8string_view name)
+{
+	m_buffer.push_back(u8'"');
+	append_json_escaped(m_buffer, prefix);
+	append_json_escaped(m_buffer, name);
+	m_buffer.append(u8"\":");
+}
+
+void
+JsonConverter::append_string(std::u8string_view text)
+{
+	m_buffer.push_back(u8'"');
+	append_json_escaped(m_buffer, text);
+	m_buffer.push_back(u8'"');
+}
+
+//-----------------------------------------------------------------------------
+//	Write the key (or array separator) for a child of 'parent'.
+//-----------------------------------------------------------------------------
+void
+JsonConverter::begin_child(Level & parent, const Element & element, const String & path)
+{
+	std::u8string_view name = element.name;
+	if(!element.name_space.empty())
+	{
+		m_qualified_name.assign(element.name_space).append(u8":").append(element.name);
+		name = m_qualified_name;
+	}
+
+	open_object(parent);
+
+	bool b_repeat = 	parent.last_child == name &&
+										(parent.b_array || (m_options.b_auto_arrays && parent.value_position != NO_POSITION));
+
+	if(b_repeat)
+	{
+		// The second of a run of siblings turns the first into an array.
+		if(!parent.b_array)
+		{
+			m_buffer.insert(parent.value_position, 1, u8'[');
+			parent.b_array = true;
+		}
+		m_buffer.push_back(u8',');
+	}
+	else
+	{
+		if(parent.b_array)
+		{
+			m_buffer.push_back(u8']');
+			parent.b_array = false;
+		}
+		if(parent.b_members)
+			m_buffer.push_back(u8',');
+		append_key({}, name);
+		parent.b_members = true;
+		parent.last_child.assign(name);
+
+		if(!m_array_paths.empty() && m_array_paths.contains(std::u8string_view(path)))
+		{
+			m_buffer.push_back(u8'[');
+			parent.b_array = true;
+		}
+	}
+
+	parent.value_position = m_buffer.size();
+}
+
+void
+JsonConverter::begin_value(const Element & element)
+{
+	auto & level = push_level();
+
+	if(!element.attributes.empty())
+	{
+		open_object(level);
+		for(auto & [name, value] : element.attributes)
+		{
+			if(level.b_members)
+				m_buffer.push_back(u8',');
+			append_key(m_options.attribute_prefix, name);
+			append_string(value);
+			level.b_members = true;
+		}
+	}
+
+	if(element.b_closed)
+		end_value(element);
+}
+
+void
+JsonConverter::end_value(const Element & element)
+{
+	auto & level 	= m_levels[m_depth - 1];
+	auto text 		= trim_text(element.content);
+
+	if(level.b_object)
+	{
+		if(level.b_array)
+			m_buffer.push_back(u8']');
+		if(!text.empty())
+		{
+			if(level.b_members)
+				m_buffer.push_back(u8',');
+			append_key({}, m_options.text_key);
+			append_string(text);
+		}
+		m_buffer.push_back(u8'}');
+	}
+	else if(text.empty())
+		m_buffer.append(u8"null");
+	else
+		append_string(text);
+
+	--m_depth;
+}
+
+std::error_code
+JsonConverter::end_line()
+{
+	m_buffer.push_back(u8'\n');
+	++m_lines;
+	return flush(true);
+}
+
+//-----------------------------------------------------------------------------
+//	Hand the buffer to the sink, keeping anything that may still need a '['
+//	inserted unless 'b_all'.
+//-----------------------------------------------------------------------------
+std::error_code
+JsonConverter::flush(bool b_all)
+{
+	if(!m_sink)
+		return {};
+
+	auto keep = m_buffer.size();
+	if(!b_all)
+		for(std::size_t i = 0; i < m_depth; ++i)
+			if(!m_levels[i].b_array && m_levels[i].value_position != NO_POSITION)
+				keep = std::min(keep, m_levels[i].value_position);
+
+	// Avoid moving a large retained tail for a small write.
+	if(keep == 0 || (!b_all && keep < m_options.flush_bytes / 2))
+		return {};
+
+	auto ec = m_sink(std::u8string_view(m_buffer).substr(0, keep));
+	m_buffer.erase(0, keep);
+
+	for(std::size_t i = 0; i < m_depth; ++i)
+	{
+		auto & position = m_levels[i].value_position;
+		position = (position != NO_POSITION && position >= keep) ? position - keep : NO_POSITION;
+	}
+	return ec;
+}
+
+std::error_code
+JsonConverter::on_event(Parser::Action action, const String & path, const ElementStack & element_stack)
+{
+	if(element_stack.empty() || (action != Parser::ACTION_START_ELEMENT && action != Parser::ACTION_END_ELEMENT))
+		return {};
+
+	const auto & element 	= element_stack.back();
+	const auto depth 			= element_stack.size();
+
+	if(action == Parser::ACTION_START_ELEMENT)
+	{
+		if(m_record_depth == 0)
+		{
+			if(m_options.record_path.empty())
+			{
+				// The document is an object holding the root element. It only
+				// ever has one child, so never needs an array inserted.
+				auto & document = push_level();
+				open_object(document);
+				begin_child(document, element, path);
+				document.value_position = NO_POSITION;
+			}
+			else if(std::u8string_view(path) != m_options.record_path)
+				return {};
+
+			m_record_depth = depth;
+		}
+		else
+			begin_child(m_levels[m_depth - 1], element, path);
+
+		begin_value(element);
+	}
+	else if(m_record_depth != 0)
+		end_value(element);
+	else
+		return {};
+
+	bool b_ended = action == Parser::ACTION_END_ELEMENT || element.b_closed;
+	if(b_ended && depth == m_record_depth)
+	{
+		if(m_options.record_path.empty())
+		{
+			m_buffer.push_back(u8'}');
+			--m_depth;
+		}
+		m_record_depth = 0;
+		return end_line();
+	}
+
+	if(m_buffer.size() >= m_options.flush_bytes)
+		return flush(false);
+	return {};
+}
+
+} // namespace adexml
@@ -0,0 +1,131 @@
+//=============================================================================
+//	FILE:					json.h
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Streaming conversion of parser events to JSON, without building a
+//		tree.
+//
+//			<item id="7"><name>Bolt</name><tag>a</tag><tag>b</tag></item>
+//
+//		becomes
+//
+//			{"item":{"@id":"7","name":"Bolt","tag":["a","b"]}}
+//
+//		An element with neither attributes nor children becomes its text (or
+//		null when it has none). Otherwise it becomes an object holding its
+//		attributes, with attribute_prefix added to their names, its children
+//		and its text under text_key. Text is trimmed of trailing whitespace,
+//		and whitespace-only text is dropped.
+//
+//		Consecutive siblings with the same name are grouped into an array
+//		(b_auto_arrays). Elements whose paths are listed in array_paths are
+//		always arrays, even when there is only one of them. Siblings of the
+//		same name separated by other elements produce repeated keys.
+//
+//		Each document is written as one line. With a record_path, each
+//		element at that path is written as one line instead (NDJSON) and
+//		everything outside the records is ignored.
+//
+//		Output is written to an internal buffer that is handed to the sink
+//		at the end of each line and whenever it passes flush_bytes. Grouping
+//		an array means inserting '[' before the first value, so the buffer
+//		keeps the most recent child of each open element; memory is bounded
+//		by nesting depth and the size of those children, not the document.
+//		Without a sink the buffer holds the whole output.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_JSON_H
+#define GUARD_ADE_XML_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+struct JsonOptions
+{
+	std::u8string								attribute_prefix 	= u8"@";
+	std::u8string								text_key 					= u8"#text";
+	std::u8string								record_path;											// Empty to convert whole documents
+	std::vector<std::u8string>	array_paths;											// Full element paths always written as arrays
+	bool												b_auto_arrays 		= true;
+	std::size_t									flush_bytes 			= 64 * 1024;
+};
+
+//-----------------------------------------------------------------------------
+//	Append 'text' to 'out' as the contents of a JSON string (without the
+//	quotes).
+//-----------------------------------------------------------------------------
+void	append_json_escaped(std::u8string & out, std::u8string_view text);
+
+class JsonConverter
+{
+public:
+	using Sink = std::function<std::error_code (std::u8string_view json)>;
+
+private:
+	static constexpr std::size_t	NO_POSITION = static_cast<std::size_t>(-1);
+
+	struct Level
+	{
+		std::u8string		last_child;								// Name of the most recent child
+		std::size_t			value_position 	= NO_POSITION;	// Buffer position of that child's value
+		bool						b_object 				= false;	// '{' written
+		bool						b_members 			= false;
+		bool						b_array 				= false;	// Inside an array of last_child
+	};
+
+	JsonOptions																									m_options;
+	Sink																												m_sink;
+	std::unordered_set<std::u8string, StringHash, StringEqual>	m_array_paths;
+	std::u8string																								m_buffer;
+	std::u8string																								m_qualified_name;	// Scratch for "prefix:name"
+	std::vector<Level>																					m_levels;				// Reused; only m_depth are open
+	std::size_t																									m_depth 				= 0;
+	std::size_t																									m_record_depth 	= 0;		// Parser depth of the line's top element, 0 outside
+	std::uint64_t																								m_lines 				= 0;
+
+	Level &							push_level();
+	void								open_object(Level & level);
+	void								append_key(std::u8string_view prefix, std::u8string_view name);
+	void								append_string(std::u8string_view text);
+	void								begin_child(Level & parent, const Element & element, const String & path);
+	void								begin_value(const Element & element);
+	void								end_value(const Element & element);
+	std::error_code			end_line();
+	std::error_code			flush(bool b_all);
+
+public:
+	explicit JsonConverter(JsonOptions options = {}, Sink sink = {});
+
+	Parser::Callback		callback()		{return [this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);};}
+	std::error_code			on_event(Parser::Action action, const String & path, const ElementStack & element_stack);
+
+	//---------------------------------------------------------------------------
+	//	Hand any buffered output to the sink.
+	//---------------------------------------------------------------------------
+	std::error_code			finish()				{return flush(true);}
+
+	std::u8string_view	output() const	{return m_buffer;}				// Output not yet handed to the sink
+	std::uint64_t				lines() const		{return m_lines;}
+	void								clear();
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_JSON_H
@@ -0,0 +1,54 @@
+//=============================================================================
+//	FILE:					memory.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <new>
+#include "memory.h"
+
+namespace adexml
+{
+
+void *
+BoundedResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	if(bytes > m_budget - std::min(m_used, m_budget))
+		throw std::bad_alloc();
+
+	auto ptr = m_upstream->allocate(bytes, alignment);
+	m_used += bytes;
+	m_peak = std::max(m_peak, m_used);
+	return ptr;
+}
+
+void
+BoundedResource::do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment)
+{
+	m_upstream->deallocate(ptr, bytes, alignment);
+	m_used -= bytes;
+}
+
+void *
+CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	auto ptr = m_upstream->allocate(bytes, alignment);
+	++m_allocations;
+	m_bytes 	+= bytes;
+	m_in_use	+= bytes;
+	return ptr;
+}
+
+void
+CountingResource::do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment)
+{
+	m_upstream->deallocate(ptr, bytes, alignment);
+	m_in_use -= bytes;
+}
+
+} // namespace adexml
@@ -0,0 +1,94 @@
+//=============================================================================
+//	FILE:					memory.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Memory resources for use with Parser.
+//
+//		A typical per-request setup backs a parse with a monotonic buffer and
+//		caps it with a budget:
+//
+//			std::pmr::monotonic_buffer_resource	arena(64 * 1024);
+//			adexml::BoundedResource							budget(16 * 1024 * 1024, &arena);
+//			adexml::Parser											parser(callback, &budget);
+//
+//		When the budget is exhausted the parse fails with OUT_OF_MEMORY and
+//		everything is released with the arena.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_MEMORY_H
+#define GUARD_ADE_XML_MEMORY_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace adexml
+{
+
+//-----------------------------------------------------------------------------
+//	Passes allocations through to an upstream resource until the number of
+//	outstanding bytes would exceed the budget, after which allocation throws
+//	std::bad_alloc. Not thread safe; use one per parser.
+//-----------------------------------------------------------------------------
+class BoundedResource : public std::pmr::memory_resource
+{
+private:
+	std::pmr::memory_resource *		m_upstream;
+	std::size_t										m_budget;
+	std::size_t										m_used = 0;
+	std::size_t										m_peak = 0;
+
+public:
+	explicit BoundedResource(std::size_t budget, std::pmr::memory_resource * upstream = std::pmr::get_default_resource())
+		: m_upstream(upstream), m_budget(budget) {}
+
+	std::size_t			budget() const									{return m_budget;}
+	std::size_t			used() const										{return m_used;}
+	std::size_t			peak() const										{return m_peak;}
+	void						set_budget(std::size_t budget)	{m_budget = budget;}
+
+protected:
+	void *					do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void						do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override;
+	bool						do_is_equal(const std::pmr::memory_resource & other) const noexcept override	{return this == &other;}
+};
+
+//-----------------------------------------------------------------------------
+//	Passes every allocation through to an upstream resource and counts them.
+//	allocations() and bytes() accumulate until reset(); in_use() is the number
+//	of bytes currently allocated and is not affected by reset(). Not thread
+//	safe; use one per parser.
+//-----------------------------------------------------------------------------
+class CountingResource : public std::pmr::memory_resource
+{
+private:
+	std::pmr::memory_resource *		m_upstream;
+	std::size_t										m_allocations	= 0;
+	std::size_t										m_bytes				= 0;
+	std::size_t										m_in_use			= 0;
+
+public:
+	explicit CountingResource(std::pmr::memory_resource * upstream = std::pmr::get_default_resource())
+		: m_upstream(upstream) {}
+
+	std::pmr::memory_resource *	upstream() const	{return m_upstream;}
+	std::size_t			allocations() const			{return m_allocations;}
+	std::size_t			bytes() const						{return m_bytes;}
+	std::size_t			in_use() const					{return m_in_use;}
+	void						reset()									{m_allocations = 0; m_bytes = 0;}
+
+protected:
+	void *					do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void						do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override;
+	bool						do_is_equal(const std::pmr::memory_resource & other) const noexcept override	{return this == &other;}
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_MEMORY_H
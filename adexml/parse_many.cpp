@@ -0,0 +1,157 @@
+//=============================================================================
+//	FILE:					parse_many.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <thread>
+#include "parse_many.h"
+
+namespace adexml
+{
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+//	A worker's queue is a contiguous run of batch indices [begin,end) packed
+//	into one atomic word. The owner takes batches from the front and thieves
+//	take them from the back, both with a single compare-exchange.
+//-----------------------------------------------------------------------------
+class BatchRange
+{
+private:
+	std::atomic<std::uint64_t>		m_range{0};
+
+	static constexpr std::uint64_t	pack(std::uint32_t begin, std::uint32_t end)	{return (std::uint64_t(begin) << 32) | end;}
+
+public:
+	void	assign(std::uint32_t begin, std::uint32_t end)	{m_range.store(pack(begin,end), std::memory_order_relaxed);}
+
+	std::optional<std::uint32_t>
+	pop_front()
+	{
+		auto range = m_range.load(std::memory_order_acquire);
+		for(;;)
+		{
+			auto begin 	= static_cast<std::uint32_t>(range >> 32);
+			auto end 		= static_cast<std::uint32_t>(range);
+			if(begin >= end)
+				return std::nullopt;
+			if(m_range.compare_exchange_weak(range, pack(begin+1, end), std::memory_order_acq_rel, std::memory_order_acquire))
+				return begin;
+		}
+	}
+
+	std::optional<std::uint32_t>
+	pop_back()
+	{
+		auto range = m_range.load(std::memory_order_acquire);
+		for(;;)
+		{
+			auto begin 	= static_cast<std::uint32_t>(range >> 32);
+			auto end 		= static_cast<std::uint32_t>(range);
+			if(begin >= end)
+				return std::nullopt;
+			if(m_range.compare_exchange_weak(range, pack(begin, end-1), std::memory_order_acq_rel, std::memory_order_acquire))
+				return end-1;
+		}
+	}
+};
+
+struct Batch
+{
+	std::size_t		first;
+	std::size_t		last;
+};
+
+std::vector<Batch>
+make_batches(std::span<const std::span<const char8_t>> documents, const ParseManyOptions & options)
+{
+	std::vector<Batch>	batches;
+	std::size_t					bytes = 0;
+	std::size_t					first = 0;
+
+	for(std::size_t i = 0; i < documents.size(); ++i)
+	{
+		bytes += documents[i].size();
+		if((bytes >= options.batch_bytes) || (i+1-first >= options.batch_documents) || (i+1 == documents.size()))
+		{
+			batches.push_back({first, i+1});
+			first = i+1;
+			bytes = 0;
+		}
+	}
+
+	return batches;
+}
+
+} // namespace
+
+std::vector<std::error_code>
+parse_many(	std::span<const std::span<const char8_t>>	documents,
+						const HandlerFactory &										factory,
+						const ParseManyOptions &									options )
+{
+	std::vector<std::error_code>	results(documents.size());
+	const auto										batches = make_batches(documents, options);
+	if(batches.empty())
+		return results;
+
+	unsigned thread_count = options.threads ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+	thread_count = static_cast<unsigned>(std::min<std::size_t>(thread_count, batches.size()));
+
+	auto queues = std::make_unique<BatchRange[]>(thread_count);
+	for(unsigned w = 0; w < thread_count; ++w)
+		queues[w].assign(	static_cast<std::uint32_t>((batches.size() * w) / thread_count),
+											static_cast<std::uint32_t>((batches.size() * (w+1)) / thread_count) );
+
+	auto next_batch = [&](unsigned worker) -> std::optional<std::uint32_t>
+		{
+			if(auto batch = queues[worker].pop_front())
+				return batch;
+			for(unsigned i = 1; i < thread_count; ++i)
+				if(auto batch = queues[(worker + i) % thread_count].pop_back())
+					return batch;
+			return std::nullopt;
+		};
+
+	auto run_worker = [&](unsigned worker)
+		{
+			std::pmr::unsynchronized_pool_resource	arena;
+			Parser																	parser(Parser::Callback{}, &arena);
+
+			while(auto index = next_batch(worker))
+			{
+				const auto & batch = batches[*index];
+				for(auto doc = batch.first; doc < batch.last; ++doc)
+				{
+					parser.reset();
+					parser.set_callback(factory({doc, worker, &arena}));
+					auto ec = parser.write(documents[doc]);
+					results[doc] = ec ? ec : parser.finish();
+				}
+			}
+		};
+
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+	for(unsigned w = 1; w < thread_count; ++w)
+		threads.emplace_back(run_worker, w);
+	run_worker(0);
+	for(auto & thread : threads)
+		thread.join();
+
+	return results;
+}
+
+} // namespace adexml
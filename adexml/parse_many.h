@@ -0,0 +1,77 @@
+//=============================================================================
+//	FILE:					parse_many.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Parses many independent documents in parallel. Documents are grouped
+//		into batches, the batches are split between worker threads and idle
+//		workers steal batches from busy ones. Each worker owns one Parser and
+//		an unsynchronized pool resource (its arena) which the parser allocates
+//		from. The parser is reset between documents.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_PARSE_MANY_H
+#define GUARD_ADE_XML_PARSE_MANY_H
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <system_error>
+#include <vector>
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+struct ParseManyOptions
+{
+	unsigned				threads 					= 0;					// 0 = std::thread::hardware_concurrency()
+	std::size_t			batch_bytes 			= 64 * 1024;	// Close a batch once it holds this much input...
+	std::size_t			batch_documents 	= 256;				// ...or this many documents.
+};
+
+struct DocumentContext
+{
+	std::size_t			document;		// Index of the document in the input range
+	unsigned				worker;			// Index of the worker thread parsing it
+	std::pmr::memory_resource *	resource;	// The worker's arena, also used by its parser
+};
+
+//-----------------------------------------------------------------------------
+//	The factory is called once per document, on the worker thread that parses
+//	it, to provide the callback for that document. The worker index can be used
+//	to select per-worker state without locking.
+//-----------------------------------------------------------------------------
+using HandlerFactory = std::function<Parser::Callback (const DocumentContext & context)>;
+
+//-----------------------------------------------------------------------------
+//	Returns one error code per document, in input order. A document that parsed
+//	successfully and was complete has an empty error code.
+//-----------------------------------------------------------------------------
+std::vector<std::error_code>	parse_many(	std::span<const std::span<const char8_t>>	documents,
+																					const HandlerFactory &										factory,
+																					const ParseManyOptions &									options = {} );
+
+template<std::ranges::random_access_range R>
+	requires std::ranges::contiguous_range<std::ranges::range_value_t<R>>
+std::vector<std::error_code>
+parse_many(R && documents, const HandlerFactory & factory, const ParseManyOptions & options = {})
+{
+	std::vector<std::span<const char8_t>> spans;
+	spans.reserve(std::ranges::size(documents));
+	for(auto && doc : documents)
+		spans.emplace_back(reinterpret_cast<const char8_t *>(std::ranges::data(doc)), std::ranges::size(doc));
+	return parse_many(std::span<const std::span<const char8_t>>(spans), factory, options);
+}
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_PARSE_MANY_H
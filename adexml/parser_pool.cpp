@@ -0,0 +1,108 @@
+//=============================================================================
+//	FILE:					parser_pool.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <cassert>
+#include <utility>
+#include "parser_pool.h"
+
+namespace adexml
+{
+
+//=============================================================================
+//
+//	LEASE
+//
+//=============================================================================
+
+ParserPool::Lease &
+ParserPool::Lease::operator=(Lease && other) noexcept
+{
+	if(this != &other)
+	{
+		release();
+		m_pool 			= std::exchange(other.m_pool, nullptr);
+		m_parser 		= std::exchange(other.m_parser, nullptr);
+		m_index 		= other.m_index;
+		m_overflow	= std::move(other.m_overflow);
+	}
+	return *this;
+}
+
+void
+ParserPool::Lease::release()
+{
+	if(m_pool)
+		m_pool->give_back(m_index);
+	m_pool 		= nullptr;
+	m_parser	= nullptr;
+	m_overflow.reset();
+}
+
+//=============================================================================
+//
+//	PARSER POOL
+//
+//	The free list is a Treiber stack of parser indices. The head carries a
+//	generation tag in its upper 32 bits so that a pop racing with a pop/push
+//	pair of the same index (ABA) fails its compare-exchange.
+//
+//=============================================================================
+
+ParserPool::ParserPool(std::size_t capacity)
+	: m_next(std::make_unique<std::atomic<std::uint32_t>[]>(capacity))
+	, m_head(capacity ? 0 : NIL)
+{
+	assert(capacity < NIL);
+	m_parsers.reserve(capacity);
+	for(std::size_t i = 0; i < capacity; ++i)
+	{
+		m_parsers.push_back(std::make_unique<Parser>(Parser::Callback{}));
+		m_next[i].store((i+1 < capacity) ? static_cast<std::uint32_t>(i+1) : NIL, std::memory_order_relaxed);
+	}
+}
+
+ParserPool::Lease
+ParserPool::acquire(Parser::Callback callback)
+{
+	auto head = m_head.load(std::memory_order_acquire);
+
+	for(;;)
+	{
+		auto index = static_cast<std::uint32_t>(head);
+		if(index == NIL)
+			return Lease(std::make_unique<Parser>(std::move(callback)));
+
+		auto next 		= m_next[index].load(std::memory_order_relaxed);
+		auto new_head = ((head >> 32) + 1) << 32 | next;
+		if(m_head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+		{
+			auto & parser = *m_parsers[index];
+			parser.set_callback(std::move(callback));
+			return Lease(this, &parser, index);
+		}
+	}
+}
+
+void
+ParserPool::give_back(std::uint32_t index)
+{
+	auto & parser = *m_parsers[index];
+	parser.reset();
+	parser.set_callback({});
+
+	auto head = m_head.load(std::memory_order_relaxed);
+	do
+	{
+		m_next[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+	}
+	while(!m_head.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | index, std::memory_order_release, std::memory_order_relaxed));
+}
+
+} // namespace adexml
@@ -0,0 +1,89 @@
+//=============================================================================
+//	FILE:					parser_pool.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		A fixed size pool of warm parsers that may be shared between threads.
+//		Checkout and return use a lock-free free list. When the pool is
+//		exhausted a lease owns a freshly constructed parser instead so that
+//		acquire() never blocks.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_PARSER_POOL_H
+#define GUARD_ADE_XML_PARSER_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+class ParserPool
+{
+public:
+	//---------------------------------------------------------------------------
+	//	A lease returns its parser to the pool (after resetting it) when it is
+	//	destroyed.
+	//---------------------------------------------------------------------------
+	class Lease
+	{
+	private:
+		friend class ParserPool;
+
+		ParserPool *							m_pool 		= nullptr;
+		Parser *									m_parser 	= nullptr;
+		std::uint32_t							m_index 	= 0;
+		std::unique_ptr<Parser>		m_overflow;
+
+		Lease(ParserPool * pool, Parser * parser, std::uint32_t index) : m_pool(pool), m_parser(parser), m_index(index) {}
+		Lease(std::unique_ptr<Parser> parser) : m_parser(parser.get()), m_overflow(std::move(parser)) {}
+
+	public:
+		Lease() = default;
+		Lease(Lease && other) noexcept			{*this = std::move(other);}
+		Lease(const Lease &) = delete;
+		~Lease()														{release();}
+
+		Lease &		operator=(Lease && other) noexcept;
+		Lease &		operator=(const Lease &) = delete;
+
+		Parser *	operator->() const					{return m_parser;}
+		Parser &	operator*() const						{return *m_parser;}
+		Parser *	get() const									{return m_parser;}
+		explicit	operator bool() const				{return m_parser != nullptr;}
+		bool			is_pooled() const						{return m_pool != nullptr;}
+
+		void			release();
+	};
+
+private:
+	static constexpr std::uint32_t	NIL = UINT32_MAX;
+
+	std::vector<std::unique_ptr<Parser>>							m_parsers;
+	std::unique_ptr<std::atomic<std::uint32_t>[]>			m_next;
+	std::atomic<std::uint64_t>												m_head;	// tag:32 | index:32
+
+public:
+	explicit ParserPool(std::size_t capacity);
+	ParserPool(const ParserPool &) = delete;
+	ParserPool & operator=(const ParserPool &) = delete;
+
+	Lease									acquire(Parser::Callback callback);
+	std::size_t						capacity() const {return m_parsers.size();}
+
+private:
+	void									give_back(std::uint32_t index);
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_PARSER_POOL_H
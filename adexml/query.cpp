@@ -0,0 +1,430 @@
+//=============================================================================
+//	FILE:					query.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <cassert>
+#include "query.h"
+
+namespace adexml
+{
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+//	Minimal cursor over a query expression.
+//-----------------------------------------------------------------------------
+class ExpressionReader
+{
+private:
+	std::u8string_view	m_text;
+	std::size_t					m_pos = 0;
+
+public:
+	explicit ExpressionReader(std::u8string_view text) : m_text(text) {}
+
+	bool				at_end() const													{return m_pos >= m_text.size();}
+	char8_t			peek(std::size_t ahead = 0) const				{return (m_pos + ahead < m_text.size()) ? m_text[m_pos + ahead] : 0;}
+	bool				accept(std::u8string_view token)				{if(!m_text.substr(m_pos).starts_with(token)) return false; m_pos += token.size(); return true;}
+	void				skip_space()														{while(peek() == SPACE || peek() == CHARACTER_TABULATION) ++m_pos;}
+
+	std::u8string_view
+	name()
+	{
+		auto start = m_pos;
+		while(!at_end())
+		{
+			auto ch = peek();
+			if(	ch == SOLIDUS || ch == SQUARE_BRACKET_LEFT || ch == SQUARE_BRACKET_RIGHT || ch == EQUALS_SIGN ||
+					ch == SPACE || ch == CHARACTER_TABULATION || ch == APOSTROPHE || ch == QUOTATION_MARK || ch == 0x40 )
+				break;
+			++m_pos;
+		}
+		return m_text.substr(start, m_pos - start);
+	}
+
+	std::optional<std::u8string_view>
+	literal()
+	{
+		auto delimiter = peek();
+		if(delimiter != APOSTROPHE && delimiter != QUOTATION_MARK)
+			return std::nullopt;
+		auto end = m_text.find(delimiter, m_pos + 1);
+		if(end == std::u8string_view::npos)
+			return std::nullopt;
+		auto value = m_text.substr(m_pos + 1, end - m_pos - 1);
+		m_pos = end + 1;
+		return value;
+	}
+
+	std::optional<std::uint32_t>
+	integer()
+	{
+		std::uint32_t value = 0;
+		auto 					start = m_pos;
+		while(peek() >= DIGIT_ZERO && peek() <= DIGIT_NINE)
+			value = value * 10 + (m_text[m_pos++] - DIGIT_ZERO);
+		if(start == m_pos)
+			return std::nullopt;
+		return value;
+	}
+};
+
+void
+append_escaped(std::u8string & out, std::u8string_view text, bool b_attribute)
+{
+	for(auto ch : text)
+		switch(ch)
+		{
+			case AMPERSAND :				out.append(u8"&amp;"); break;
+			case LESS_THAN_SIGN :		out.append(u8"&lt;"); break;
+			case GREATER_THAN_SIGN :	out.append(u8"&gt;"); break;
+			case QUOTATION_MARK :		if(b_attribute) out.append(u8"&quot;"); else out.push_back(ch); break;
+			default :								out.push_back(ch); break;
+		}
+}
+
+void
+append_start_tag(std::u8string & markup, const Element & element)
+{
+	markup.push_back(LESS_THAN_SIGN);
+	markup.append(element.name);
+	for(auto & [name, value] : element.attributes)
+	{
+		markup.push_back(SPACE);
+		markup.append(name);
+		markup.append(u8"=\"");
+		append_escaped(markup, value, true);
+		markup.push_back(QUOTATION_MARK);
+	}
+	markup.push_back(GREATER_THAN_SIGN);
+}
+
+} // namespace
+
+//=============================================================================
+//
+//	COMPILATION
+//
+//=============================================================================
+
+QuerySet::QuerySet()
+{
+	m_nodes.emplace_back();		// Root node, active for the document itself.
+	reset();
+}
+
+bool
+QuerySet::Step::matches_predicates(const Element & element) const
+{
+	for(auto & predicate : predicates)
+	{
+		auto ifind = element.attributes.find(predicate.attribute);
+		if(ifind == element.attributes.end())
+			return false;
+		if(predicate.b_has_value && (std::u8string_view(ifind->second) != predicate.value))
+			return false;
+	}
+
+	return true;
+}
+
+std::uint32_t
+QuerySet::add_step(std::uint32_t node, Step && step)
+{
+	for(auto index : m_nodes[node].steps)
+		if(m_steps[index].same_test(step))
+			return m_steps[index].target;
+
+	step.target = static_cast<std::uint32_t>(m_nodes.size());
+	m_nodes.emplace_back();
+	m_nodes[node].steps.push_back(static_cast<std::uint32_t>(m_steps.size()));
+	m_steps.push_back(std::move(step));
+	return m_steps.back().target;
+}
+
+std::expected<std::size_t, std::error_code>
+QuerySet::add(std::u8string_view expression)
+{
+	const auto			syntax_error = std::unexpected(make_error_code(adexml::Error::QUERY_SYNTAX_ERROR));
+	ExpressionReader	reader(expression);
+	std::vector<Step>	steps;
+	Output						output{m_query_count, QueryResult::ELEMENT, {}};
+
+	reader.skip_space();
+	Axis axis = reader.accept(u8"//") ? Axis::DESCENDANT : (reader.accept(u8"/"), Axis::CHILD);
+
+	for(;;)
+	{
+		Step step;
+		step.axis = axis;
+
+		if(!reader.accept(u8"*"))
+		{
+			auto name = reader.name();
+			if(name.empty())
+				return syntax_error;
+			step.name = name;
+		}
+
+		while(reader.accept(u8"["))
+		{
+			reader.skip_space();
+			if(reader.accept(u8"@"))
+			{
+				Predicate predicate;
+				predicate.attribute = reader.name();
+				if(predicate.attribute.empty())
+					return syntax_error;
+				reader.skip_space();
+				if(reader.accept(u8"="))
+				{
+					reader.skip_space();
+					auto value = reader.literal();
+					if(!value)
+						return syntax_error;
+					predicate.value 			= *value;
+					predicate.b_has_value = true;
+				}
+				step.predicates.push_back(std::move(predicate));
+			}
+			else
+			{
+				// The position counts siblings that pass the name test, so an
+				// attribute predicate may follow it but not precede it.
+				auto position = reader.integer();
+				if(!position || (*position == 0) || (step.position != 0) || !step.predicates.empty())
+					return syntax_error;
+				step.position = *position;
+			}
+			reader.skip_space();
+			if(!reader.accept(u8"]"))
+				return syntax_error;
+		}
+
+		steps.push_back(std::move(step));
+
+		reader.skip_space();
+		if(reader.at_end())
+			break;
+		if(reader.accept(u8"//"))
+			axis = Axis::DESCENDANT;
+		else if(reader.accept(u8"/"))
+		{
+			axis = Axis::CHILD;
+			if(reader.accept(u8"@"))
+			{
+				output.result 		= QueryResult::ATTRIBUTE;
+				output.attribute	= reader.name();
+				if(output.attribute.empty())
+					return syntax_error;
+			}
+			else if(reader.accept(u8"text()"))
+				output.result = QueryResult::TEXT;
+			else
+				continue;
+
+			reader.skip_space();
+			if(!reader.at_end())
+				return syntax_error;
+			break;
+		}
+		else
+			return syntax_error;
+	}
+
+	std::uint32_t node = 0;
+	for(auto & step : steps)
+		node = add_step(node, std::move(step));
+	m_nodes[node].outputs.push_back(std::move(output));
+
+	return m_query_count++;
+}
+
+//=============================================================================
+//
+//	EVALUATION
+//
+//=============================================================================
+
+void
+QuerySet::reset()
+{
+	m_depth 					= 0;
+	m_active_captures = 0;
+	if(m_frames.empty())
+		m_frames.emplace_back();
+	auto & root = m_frames.front();
+	root.nodes.assign(1, 0);
+	root.counters.clear();
+	root.text_queries.clear();
+}
+
+std::error_code
+QuerySet::on_event(Parser::Action action, const String & path, const ElementStack & element_stack)
+{
+	if(element_stack.empty())
+		return {};
+
+	const auto & element = element_stack.back();
+
+	switch(action)
+	{
+		case Parser::ACTION_START_ELEMENT :
+			if(auto ec = on_start(path, element))
+				return ec;
+			if(element.b_closed)
+				return on_end(path, element);
+			break;
+
+		case Parser::ACTION_END_ELEMENT :
+			return on_end(path, element);
+
+		default :
+			break;
+	}
+	return {};
+}
+
+std::uint32_t
+QuerySet::count_sibling(Frame & frame, std::uint32_t step)
+{
+	for(auto & counter : frame.counters)
+		if(counter.step == step)
+			return ++counter.count;
+	frame.counters.push_back({step, 1});
+	return 1;
+}
+
+std::error_code
+QuerySet::on_start(const String & path, const Element & element)
+{
+	++m_depth;
+	if(m_frames.size() <= m_depth)
+		m_frames.resize(m_depth + 1);
+
+	auto & parent = m_frames[m_depth - 1];
+	auto & frame 	= m_frames[m_depth];
+	frame.nodes.clear();
+	frame.counters.clear();
+	frame.text_queries.clear();
+
+	capture_start(element);
+
+	auto activate = [&](std::uint32_t node)
+		{
+			if(std::find(frame.nodes.begin(), frame.nodes.end(), node) == frame.nodes.end())
+				frame.nodes.push_back(node);
+		};
+
+	for(auto node : parent.nodes)
+		for(auto index : m_nodes[node].steps)
+		{
+			const auto & step = m_steps[index];
+
+			if(step.axis == Axis::DESCENDANT)
+				activate(node);
+
+			if(!step.matches_name(element))
+				continue;
+			if(step.position && (count_sibling(parent, index) != step.position))
+				continue;
+			if(!step.matches_predicates(element))
+				continue;
+
+			activate(step.target);
+
+			for(auto & output : m_nodes[step.target].outputs)
+				switch(output.result)
+				{
+					case QueryResult::ATTRIBUTE :
+					{
+						auto ifind = element.attributes.find(output.attribute);
+						if(ifind != element.attributes.end())
+							if(auto ec = emit(output.query, QueryResult::ATTRIBUTE, ifind->second, path))
+								return ec;
+						break;
+					}
+
+					case QueryResult::TEXT :
+						frame.text_queries.push_back(output.query);
+						break;
+
+					case QueryResult::ELEMENT :
+						if(m_captures.size() <= m_active_captures)
+							m_captures.emplace_back();
+						auto & capture = m_captures[m_active_captures++];
+						capture.query = output.query;
+						capture.depth = m_depth;
+						capture.markup.clear();
+						append_start_tag(capture.markup, element);
+						break;
+				}
+		}
+
+	return {};
+}
+
+std::error_code
+QuerySet::on_end(const String & path, const Element & element)
+{
+	assert(m_depth > 0);
+	auto & frame = m_frames[m_depth];
+
+	for(auto query : frame.text_queries)
+		if(auto ec = emit(query, QueryResult::TEXT, element.content, path))
+			return ec;
+
+	capture_end(element);
+	while(m_active_captures && (m_captures[m_active_captures - 1].depth == m_depth))
+	{
+		auto & capture = m_captures[--m_active_captures];
+		if(auto ec = emit(capture.query, QueryResult::ELEMENT, capture.markup, path))
+			return ec;
+	}
+
+	--m_depth;
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	Subtree capture. Captures nest, so the active captures always form a stack
+//	ordered by depth and the innermost ones finish first.
+//-----------------------------------------------------------------------------
+
+void
+QuerySet::capture_start(const Element & element)
+{
+	for(std::size_t i = 0; i < m_active_captures; ++i)
+		append_start_tag(m_captures[i].markup, element);
+}
+
+void
+QuerySet::capture_end(const Element & element)
+{
+	for(std::size_t i = 0; i < m_active_captures; ++i)
+	{
+		auto & markup = m_captures[i].markup;
+		append_escaped(markup, element.content, false);
+		markup.append(u8"</");
+		markup.append(element.name);
+		markup.push_back(GREATER_THAN_SIGN);
+	}
+}
+
+std::error_code
+QuerySet::emit(std::size_t query, QueryResult result, std::u8string_view value, std::u8string_view path)
+{
+	if(m_handler)
+		return m_handler({query, result, value, path});
+	return {};
+}
+
+} // namespace adexml
@@ -0,0 +1,166 @@
+//=============================================================================
+//	FILE:					query.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Streaming evaluation of a subset of XPath over Parser events.
+//
+//		query     := ('/' | '//')? step (('/' | '//') step)* result?
+//		step      := (name | '*') predicate*
+//		predicate := '[' '@' name ('=' literal)? ']' | '[' integer ']'
+//		result    := '/@' name | '/text()'
+//
+//		A query without a result selects whole elements, which are delivered as
+//		serialized markup. Because the parser accumulates all of an element's
+//		character data into Element::content, an element's text is written
+//		after its child elements in the serialized subtree.
+//
+//		All queries in a QuerySet are compiled into one automaton in which
+//		common step prefixes are shared. Evaluation keeps one frame of active
+//		automaton states per open element so memory is bounded by document
+//		depth (plus the size of any subtrees currently being captured).
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_QUERY_H
+#define GUARD_ADE_XML_QUERY_H
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+enum class QueryResult
+{
+	ELEMENT,
+	TEXT,
+	ATTRIBUTE
+};
+
+struct QueryMatch
+{
+	std::size_t					query;		// Value returned by QuerySet::add()
+	QueryResult					result;
+	std::u8string_view	value;		// Serialized subtree, text content or attribute value
+	std::u8string_view	path;			// Path of the matching element
+};
+
+class QuerySet
+{
+public:
+	using MatchHandler = std::function<std::error_code (const QueryMatch & match)>;
+
+private:
+	enum class Axis
+	{
+		CHILD,
+		DESCENDANT
+	};
+
+	struct Predicate
+	{
+		std::u8string				attribute;
+		std::u8string				value;
+		bool								b_has_value = false;
+
+		bool operator==(const Predicate &) const = default;
+	};
+
+	struct Step
+	{
+		Axis										axis 			= Axis::CHILD;
+		std::u8string						name;						// Empty matches any element
+		std::vector<Predicate>	predicates;
+		std::uint32_t						position	= 0;	// 1-based, 0 when there is no positional predicate. Precedes the predicates.
+		std::uint32_t						target		= 0;	// Automaton node reached by this step
+
+		bool	same_test(const Step & other) const {return axis == other.axis && name == other.name && predicates == other.predicates && position == other.position;}
+		bool	matches_name(const Element & element) const {return name.empty() || (std::u8string_view(element.name) == name);}
+		bool	matches_predicates(const Element & element) const;
+	};
+
+	struct Output
+	{
+		std::size_t					query;
+		QueryResult					result;
+		std::u8string				attribute;
+	};
+
+	struct Node
+	{
+		std::vector<std::uint32_t>	steps;
+		std::vector<Output>					outputs;
+	};
+
+	struct Counter
+	{
+		std::uint32_t				step;
+		std::uint32_t				count;
+	};
+
+	struct Frame
+	{
+		std::vector<std::uint32_t>	nodes;					// Active automaton nodes for children of this element
+		std::vector<Counter>				counters;				// Sibling counts for positional steps
+		std::vector<std::size_t>		text_queries;		// Queries that want this element's text at its end
+	};
+
+	struct Capture
+	{
+		std::size_t					query;
+		std::size_t					depth;
+		std::u8string				markup;
+	};
+
+	std::vector<Node>				m_nodes;
+	std::vector<Step>				m_steps;
+	std::size_t							m_query_count = 0;
+	MatchHandler						m_handler;
+
+	std::vector<Frame>			m_frames;
+	std::size_t							m_depth = 0;
+	std::vector<Capture>		m_captures;
+	std::size_t							m_active_captures = 0;
+
+public:
+	QuerySet();
+	explicit QuerySet(MatchHandler handler) : QuerySet() {m_handler = std::move(handler);}
+
+	std::expected<std::size_t, std::error_code>		add(std::u8string_view expression);
+	void						set_handler(MatchHandler handler)	{m_handler = std::move(handler);}
+	std::size_t			size() const											{return m_query_count;}
+
+	//---------------------------------------------------------------------------
+	//	Feed parser events to the query set. callback() returns a Parser callback
+	//	bound to this query set, which must outlive the parser that uses it.
+	//	reset() discards evaluation state between documents.
+	//---------------------------------------------------------------------------
+	std::error_code	on_event(Parser::Action action, const String & path, const ElementStack & element_stack);
+	Parser::Callback	callback()												{return [this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);};}
+	void						reset();
+
+private:
+	std::uint32_t		add_step(std::uint32_t node, Step && step);
+	std::error_code	on_start(const String & path, const Element & element);
+	std::error_code	on_end(const String & path, const Element & element);
+	std::uint32_t		count_sibling(Frame & frame, std::uint32_t step);
+	void						capture_start(const Element & element);
+	void						capture_end(const Element & element);
+	std::error_code	emit(std::size_t query, QueryResult result, std::u8string_view value, std::u8string_view path);
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_QUERY_H
@@ -0,0 +1,619 @@
+//=============================================================================
+//	FILE:					schema.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <map>
+#include "schema.h"
+
+namespace adexml
+{
+
+namespace
+{
+
+constexpr std::size_t	MAX_MODEL_STATES = 1024;
+
+std::error_code	syntax_error()	{return adexml::Error::DTD_SYNTAX_ERROR;}
+
+bool	is_space(char8_t ch)	{return (ch == SPACE) || (ch == CHARACTER_TABULATION) || (ch == LINE_FEED) || (ch == CARRIAGE_RETURN);}
+
+std::u8string_view
+trim_space(std::u8string_view text)
+{
+	while(!text.empty() && is_space(text.front()))	text.remove_prefix(1);
+	while(!text.empty() && is_space(text.back()))		text.remove_suffix(1);
+	return text;
+}
+
+bool
+is_name(std::u8string_view text)
+{
+	return !text.empty() && is_entity_name_start_char(text.front()) && std::ranges::all_of(text, [](char8_t ch){return is_entity_name_char(ch);});
+}
+
+bool
+is_name_token(std::u8string_view text)
+{
+	return !text.empty() && std::ranges::all_of(text, [](char8_t ch){return is_entity_name_char(ch);});
+}
+
+// Apply 'check' to each space separated token. There must be at least one.
+template<typename CHECK>
+bool
+all_tokens(std::u8string_view text, CHECK check)
+{
+	text = trim_space(text);
+	if(text.empty())
+		return false;
+
+	while(!text.empty())
+	{
+		auto end = std::ranges::find_if(text, is_space) - text.begin();
+		if(!check(text.substr(0, end)))
+			return false;
+		text = trim_space(text.substr(end));
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	Content model syntax tree.
+//	cp ::= (Name | choice | seq) ('?' | '*' | '+')?
+//-----------------------------------------------------------------------------
+struct ModelNode
+{
+	enum Kind : std::uint8_t {LEAF, SEQUENCE, CHOICE};
+
+	Kind												kind 				= LEAF;
+	char8_t											occurrence 	= 0;
+	std::uint32_t								symbol 			= 0;
+	std::vector<std::uint32_t>	children;
+};
+
+class ModelReader
+{
+private:
+	std::u8string_view	m_text;
+	std::size_t					m_pos = 0;
+
+public:
+	explicit ModelReader(std::u8string_view text) : m_text(text) {}
+
+	bool				at_end()							{skip_space(); return m_pos >= m_text.size();}
+	char8_t			peek()								{skip_space(); return (m_pos < m_text.size()) ? m_text[m_pos] : 0;}
+	bool				accept(char8_t ch)		{if(peek() != ch) return false; ++m_pos; return true;}
+	bool				accept(std::u8string_view token)	{skip_space(); if(!m_text.substr(m_pos).starts_with(token)) return false; m_pos += token.size(); return true;}
+	void				skip_space()					{while((m_pos < m_text.size()) && is_space(m_text[m_pos])) ++m_pos;}
+
+	std::u8string_view
+	name()
+	{
+		skip_space();
+		auto start = m_pos;
+		if((m_pos < m_text.size()) && is_entity_name_start_char(m_text[m_pos]))
+			while((m_pos < m_text.size()) && is_entity_name_char(m_text[m_pos]))
+				++m_pos;
+		return m_text.substr(start, m_pos - start);
+	}
+
+	char8_t
+	occurrence()
+	{
+		if(m_pos < m_text.size())
+			switch(m_text[m_pos])
+			{
+				case QUESTION_MARK :	[[fallthrough]];
+				case u8'*' :					[[fallthrough]];
+				case u8'+' :					return m_text[m_pos++];
+			}
+		return 0;
+	}
+};
+
+//-----------------------------------------------------------------------------
+//	Glushkov construction. Every leaf of the model is a position; the
+//	automaton has a start state plus one state per position, with an edge
+//	p -> q (on q's symbol) for every q in follow(p).
+//-----------------------------------------------------------------------------
+class Glushkov
+{
+public:
+	struct Sets
+	{
+		bool												b_nullable = false;
+		std::vector<std::uint32_t>	first;
+		std::vector<std::uint32_t>	last;
+	};
+
+	std::vector<std::uint32_t>								symbols;		// Symbol of each position
+	std::vector<std::vector<std::uint32_t>>		follow;
+
+	Sets
+	build(const std::vector<ModelNode> & nodes, std::uint32_t index)
+	{
+		const auto & node = nodes[index];
+		Sets sets;
+
+		switch(node.kind)
+		{
+			case ModelNode::LEAF :
+				sets.first = sets.last = {static_cast<std::uint32_t>(symbols.size())};
+				symbols.push_back(node.symbol);
+				follow.emplace_back();
+				break;
+
+			case ModelNode::CHOICE :
+				for(auto child : node.children)
+				{
+					auto child_sets = build(nodes, child);
+					sets.b_nullable |= child_sets.b_nullable;
+					merge(sets.first, child_sets.first);
+					merge(sets.last, child_sets.last);
+				}
+				break;
+
+			case ModelNode::SEQUENCE :
+				{
+					std::vector<Sets> parts;
+					for(auto child : node.children)
+						parts.push_back(build(nodes, child));
+
+					sets.b_nullable = true;
+					for(auto & part : parts)
+					{
+						merge(sets.first, part.first);
+						if(!part.b_nullable)
+						{
+							sets.b_nullable = false;
+							break;
+						}
+					}
+					for(auto it = parts.rbegin(); it != parts.rend(); ++it)
+					{
+						merge(sets.last, it->last);
+						if(!it->b_nullable)
+							break;
+					}
+					for(std::size_t i = 0; i < parts.size(); ++i)
+						for(std::size_t j = i + 1; j < parts.size(); ++j)
+						{
+							for(auto p : parts[i].last)
+								merge(follow[p], parts[j].first);
+							if(!parts[j].b_nullable)
+								break;
+						}
+				}
+				break;
+		}
+
+		if((node.occurrence == u8'*') || (node.occurrence == u8'+'))
+			for(auto p : sets.last)
+				merge(follow[p], sets.first);
+		if((node.occurrence == u8'*') || (node.occurrence == QUESTION_MARK))
+			sets.b_nullable = true;
+
+		return sets;
+	}
+
+private:
+	static void
+	merge(std::vector<std::uint32_t> & into, const std::vector<std::uint32_t> & from)
+	{
+		std::vector<std::uint32_t> merged;
+		std::ranges::set_union(into, from, std::back_inserter(merged));
+		into.swap(merged);
+	}
+};
+
+} // namespace
+
+//=============================================================================
+//
+//	SCHEMA
+//
+//=============================================================================
+
+std::uint32_t
+Schema::Rule::next(std::uint32_t state, std::uint32_t symbol) const
+{
+	auto it = std::ranges::lower_bound(alphabet, symbol);
+	if((it == alphabet.end()) || (*it != symbol))
+		return NONE;
+	return transitions[state * alphabet.size() + (it - alphabet.begin())];
+}
+
+std::uint32_t
+Schema::intern(std::u8string_view name)
+{
+	auto [it, b_inserted] = m_symbols.try_emplace(std::u8string(name), static_cast<std::uint32_t>(m_rules.size()));
+	if(b_inserted)
+		m_rules.emplace_back();
+	return it->second;
+}
+
+std::uint32_t
+Schema::find(std::u8string_view name) const
+{
+	auto it = m_symbols.find(name);
+	return (it == m_symbols.end()) ? NONE : it->second;
+}
+
+bool
+Schema::declares(std::u8string_view element) const
+{
+	auto symbol = find(element);
+	return (symbol != NONE) && (m_rules[symbol].content != Content::UNDECLARED);
+}
+
+std::size_t
+Schema::state_count() const
+{
+	std::size_t count = 0;
+	for(auto & rule : m_rules)
+		count += rule.accepting.size();
+	return count;
+}
+
+std::expected<Schema, std::error_code>
+Schema::parse(std::u8string_view declarations, std::u8string_view root)
+{
+	Doctype doctype;
+	if(auto ec = parse_declarations(declarations, doctype))
+		return std::unexpected(ec);
+	doctype.name.assign(root);
+	return compile(doctype);
+}
+
+std::expected<Schema, std::error_code>
+Schema::compile(const Doctype & doctype)
+{
+	Schema schema;
+	schema.m_root.assign(doctype.name);
+
+	for(auto & decl : doctype.elements)
+	{
+		auto symbol = schema.intern(decl.name);
+		if(schema.m_rules[symbol].content != Content::UNDECLARED)
+			return std::unexpected(syntax_error());
+
+		// compile_content() may intern new names, so the rule is built aside.
+		Rule rule;
+		if(auto ec = schema.compile_content(rule, decl.content))
+			return std::unexpected(ec);
+		schema.m_rules[symbol] = std::move(rule);
+	}
+
+	for(auto & decl : doctype.attributes)
+	{
+		auto & attributes = schema.m_rules[schema.intern(decl.element)].attributes;
+		if(std::ranges::any_of(attributes, [&](auto & attribute){return std::u8string_view(attribute.name) == std::u8string_view(decl.name);}))
+			continue;		// The first definition of an attribute is binding.
+
+		Attribute attribute;
+		attribute.name.assign(decl.name);
+		attribute.value.assign(decl.value);
+		for(auto & value : decl.values)
+			attribute.values.emplace_back(value);
+		attribute.type 			= decl.type;
+		attribute.presence 	= decl.presence;
+
+		if((attribute.presence == AttributeDefault::FIXED) || (attribute.presence == AttributeDefault::VALUE))
+			if((attribute.type == AttributeType::ENUMERATION) || (attribute.type == AttributeType::NOTATION))
+				if(std::ranges::find(attribute.values, attribute.value) == attribute.values.end())
+					return std::unexpected(syntax_error());
+
+		attributes.push_back(std::move(attribute));
+	}
+
+	return schema;
+}
+
+std::error_code
+Schema::compile_content(Rule & rule, std::u8string_view model)
+{
+	ModelReader reader(model);
+
+	if(reader.accept(u8"EMPTY"))
+		rule.content = Content::EMPTY;
+	else if(reader.accept(u8"ANY"))
+		rule.content = Content::ANY;
+	else if(reader.accept(u8"(") && reader.accept(u8"#PCDATA"))
+	{
+		//-------------------------------------------------------------------------
+		//	Mixed ::= '(' S? '#PCDATA' (S? '|' S? Name)* S? ')*' | '(' S? '#PCDATA' S? ')'
+		//	A single accepting state that loops on every named child.
+		//-------------------------------------------------------------------------
+		rule.content = Content::MIXED;
+		while(reader.accept(u8'|'))
+		{
+			auto name = reader.name();
+			if(name.empty())
+				return syntax_error();
+			rule.alphabet.push_back(intern(name));
+		}
+		if(!reader.accept(u8')'))
+			return syntax_error();
+		if(!reader.accept(u8'*') && !rule.alphabet.empty())
+			return syntax_error();
+
+		std::ranges::sort(rule.alphabet);
+		auto duplicates = std::ranges::unique(rule.alphabet);
+		rule.alphabet.erase(duplicates.begin(), duplicates.end());
+		rule.transitions.assign(rule.alphabet.size(), 0);
+		rule.accepting.assign(1, true);
+	}
+	else
+	{
+		//-------------------------------------------------------------------------
+		//	children ::= (choice | seq) ('?' | '*' | '+')?
+		//-------------------------------------------------------------------------
+		rule.content = Content::CHILDREN;
+		reader = ModelReader(model);
+
+		std::vector<ModelNode> nodes;
+		auto parse_cp = [&](auto & self) -> std::expected<std::uint32_t, std::error_code>
+		{
+			ModelNode node;
+			if(reader.accept(u8'('))
+			{
+				char8_t separator = 0;
+				do
+				{
+					auto child = self(self);
+					if(!child)
+						return child;
+					node.children.push_back(*child);
+
+					auto ch = reader.peek();
+					if((ch == u8',') || (ch == u8'|'))
+					{
+						if(separator && (separator != ch))
+							return std::unexpected(syntax_error());
+						separator = ch;
+						reader.accept(ch);
+					}
+					else
+						break;
+				}
+				while(true);
+
+				if(!reader.accept(u8')'))
+					return std::unexpected(syntax_error());
+				node.kind = (separator == u8'|') ? ModelNode::CHOICE : ModelNode::SEQUENCE;
+			}
+			else
+			{
+				auto name = reader.name();
+				if(name.empty())
+					return std::unexpected(syntax_error());
+				node.kind 	= ModelNode::LEAF;
+				node.symbol = intern(name);
+			}
+			node.occurrence = reader.occurrence();
+			nodes.push_back(std::move(node));
+			return static_cast<std::uint32_t>(nodes.size() - 1);
+		};
+
+		if(reader.peek() != u8'(')
+			return syntax_error();
+		auto root = parse_cp(parse_cp);
+		if(!root)
+			return root.error();
+		if(!reader.at_end())
+			return syntax_error();
+
+		//-------------------------------------------------------------------------
+		//	Subset construction over the Glushkov automaton. A DFA state is the
+		//	set of positions the NFA may be in; START stands for the initial state.
+		//-------------------------------------------------------------------------
+		Glushkov glushkov;
+		auto sets = glushkov.build(nodes, *root);
+		const auto START = static_cast<std::uint32_t>(glushkov.symbols.size());
+
+		rule.alphabet = glushkov.symbols;
+		std::ranges::sort(rule.alphabet);
+		auto duplicates = std::ranges::unique(rule.alphabet);
+		rule.alphabet.erase(duplicates.begin(), duplicates.end());
+
+		std::map<std::vector<std::uint32_t>, std::uint32_t>	ids;
+		std::vector<std::vector<std::uint32_t>>							states;
+		ids.emplace(std::vector<std::uint32_t>{START}, 0);
+		states.push_back({START});
+
+		for(std::size_t index = 0; index < states.size(); ++index)
+		{
+			if(states.size() > MAX_MODEL_STATES)
+				return adexml::Error::DTD_LIMIT_EXCEEDED;
+
+			auto current = states[index];
+			rule.accepting.push_back(std::ranges::any_of(current, [&](std::uint32_t p)
+				{return (p == START) ? sets.b_nullable : std::ranges::binary_search(sets.last, p);}));
+
+			for(auto symbol : rule.alphabet)
+			{
+				std::vector<std::uint32_t> target;
+				for(auto p : current)
+					for(auto q : (p == START) ? sets.first : glushkov.follow[p])
+						if(glushkov.symbols[q] == symbol)
+							target.push_back(q);
+
+				if(target.empty())
+				{
+					rule.transitions.push_back(NONE);
+					continue;
+				}
+
+				std::ranges::sort(target);
+				auto unique = std::ranges::unique(target);
+				target.erase(unique.begin(), unique.end());
+
+				auto [it, b_inserted] = ids.try_emplace(target, static_cast<std::uint32_t>(states.size()));
+				if(b_inserted)
+					states.push_back(target);
+				rule.transitions.push_back(it->second);
+			}
+		}
+	}
+
+	return reader.at_end() ? std::error_code{} : syntax_error();
+}
+
+//=============================================================================
+//
+//	VALIDATOR
+//
+//=============================================================================
+
+Validator::Validator(std::shared_ptr<const Schema> schema, std::pmr::memory_resource * resource)
+	: m_schema(std::move(schema))
+	, m_frames(resource)
+	, m_ids(resource)
+{
+}
+
+std::error_code
+Validator::start_element(Element & element)
+{
+	auto & schema = *m_schema;
+	auto symbol 	= schema.find(element.name);
+	if((symbol == Schema::NONE) || (schema.m_rules[symbol].content == Schema::Content::UNDECLARED))
+		return adexml::Error::UNDECLARED_ELEMENT;
+
+	if(m_frames.empty())
+	{
+		if(!schema.m_root.empty() && (std::u8string_view(element.name) != std::u8string_view(schema.m_root)))
+			return adexml::Error::INVALID_CONTENT;
+	}
+	else
+	{
+		auto & parent = m_frames.back();
+		auto & rule 	= schema.m_rules[parent.rule];
+		switch(rule.content)
+		{
+			case Schema::Content::ANY :				break;
+			case Schema::Content::MIXED :			[[fallthrough]];
+			case Schema::Content::CHILDREN :
+				parent.state = rule.next(parent.state, symbol);
+				if(parent.state != Schema::NONE)
+					break;
+				[[fallthrough]];
+			default :
+				return adexml::Error::INVALID_CONTENT;
+		}
+	}
+
+	if(auto ec = check_attributes(schema.m_rules[symbol], element))
+		return ec;
+
+	m_frames.push_back({symbol, 0});
+	return {};
+}
+
+std::error_code
+Validator::end_element(const Element & element)
+{
+	if(m_frames.empty())
+		return adexml::Error::INVALID_STATE;
+
+	auto frame = m_frames.back();
+	m_frames.pop_back();
+
+	auto & rule = m_schema->m_rules[frame.rule];
+	switch(rule.content)
+	{
+		case Schema::Content::EMPTY :
+			if(!element.content.empty())
+				return adexml::Error::INVALID_CONTENT;
+			break;
+
+		case Schema::Content::CHILDREN :
+			if(!rule.accepting[frame.state] || !std::ranges::all_of(element.content, is_space))
+				return adexml::Error::INVALID_CONTENT;
+			break;
+
+		default :
+			break;
+	}
+	return {};
+}
+
+bool
+Validator::is_valid(const Frame & frame) const
+{
+	return (frame.rule < m_schema->m_rules.size()) && (frame.state < std::max<std::size_t>(m_schema->m_rules[frame.rule].accepting.size(), 1));
+}
+
+std::error_code
+Validator::check_attributes(const Schema::Rule & rule, Element & element)
+{
+	std::size_t matched = 0;
+	std::size_t added		= 0;
+	for(auto & attribute : rule.attributes)
+	{
+		auto it = element.attributes.find(std::u8string_view(attribute.name));
+		if(it == element.attributes.end())
+		{
+			switch(attribute.presence)
+			{
+				case AttributeDefault::REQUIRED :		return adexml::Error::MISSING_ATTRIBUTE;
+				case AttributeDefault::IMPLIED :		break;
+				default :
+					element.attributes.try_emplace(String(attribute.name, element.get_allocator()), std::u8string_view(attribute.value));
+					++added;
+					break;
+			}
+			continue;
+		}
+
+		++matched;
+		if((attribute.presence == AttributeDefault::FIXED) && (std::u8string_view(it->second) != std::u8string_view(attribute.value)))
+			return adexml::Error::INVALID_ATTRIBUTE_VALUE;
+		if(auto ec = check_value(attribute, it->second))
+			return ec;
+	}
+
+	// Anything beyond the matched and defaulted attributes was not declared.
+	if(element.attributes.size() > matched + added)
+	{
+		for(auto & [name, value] : element.attributes)
+			if(std::ranges::none_of(rule.attributes, [&](auto & attribute){return std::u8string_view(attribute.name) == std::u8string_view(name);}))
+				return adexml::Error::UNDECLARED_ATTRIBUTE;
+	}
+	return {};
+}
+
+std::error_code
+Validator::check_value(const Schema::Attribute & attribute, std::u8string_view value)
+{
+	bool b_valid = true;
+	switch(attribute.type)
+	{
+		case AttributeType::CDATA :				break;
+		case AttributeType::IDREF :				[[fallthrough]];
+		case AttributeType::ENTITY :			b_valid = is_name(trim_space(value)); break;
+		case AttributeType::IDREFS :			[[fallthrough]];
+		case AttributeType::ENTITIES :		b_valid = all_tokens(value, is_name); break;
+		case AttributeType::NMTOKEN :			b_valid = is_name_token(trim_space(value)); break;
+		case AttributeType::NMTOKENS :		b_valid = all_tokens(value, is_name_token); break;
+		case AttributeType::NOTATION :		[[fallthrough]];
+		case AttributeType::ENUMERATION :	b_valid = std::ranges::find(attribute.values, trim_space(value)) != attribute.values.end(); break;
+
+		case AttributeType::ID :
+			value = trim_space(value);
+			if(!is_name(value))
+				b_valid = false;
+			else if(!m_ids.emplace(value).second)
+				return adexml::Error::DUPLICATE_ID;
+			break;
+	}
+	return b_valid ? std::error_code{} : adexml::Error::INVALID_ATTRIBUTE_VALUE;
+}
+
+} // namespace adexml
@@ -0,0 +1,165 @@
+//=============================================================================
+//	FILE:					schema.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Validation against DTD element and attribute-list declarations in the
+//		same pass as parsing.
+//
+//		Each element's content model is compiled into a deterministic
+//		automaton: a Glushkov (position) automaton is built from the model and
+//		made deterministic by subset construction, so models that are not
+//		1-unambiguous are still accepted. While parsing, the Validator keeps
+//		one frame (element rule and automaton state) per open element, so each
+//		child costs one table lookup.
+//
+//		Attribute defaults from the declarations are added to elements that do
+//		not specify them. ID values are checked for uniqueness; IDREF targets
+//		are not resolved.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_SCHEMA_H
+#define GUARD_ADE_XML_SCHEMA_H
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "dtd.h"
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+//=============================================================================
+//
+//	SCHEMA
+//
+//=============================================================================
+
+class Schema
+{
+public:
+	//---------------------------------------------------------------------------
+	//	Compile the element and attribute-list declarations of a DOCTYPE. If the
+	//	doctype has a name the document's root element must match it.
+	//---------------------------------------------------------------------------
+	static std::expected<Schema, std::error_code>	compile(const Doctype & doctype);
+
+	//---------------------------------------------------------------------------
+	//	Compile a list of markup declarations, such as an external .dtd file.
+	//	'root', if given, is the required root element.
+	//---------------------------------------------------------------------------
+	static std::expected<Schema, std::error_code>	parse(std::u8string_view declarations, std::u8string_view root = {});
+
+	bool				declares(std::u8string_view element) const;
+	std::size_t	state_count() const;		// Total automaton states over all content models
+
+private:
+	friend class Validator;
+
+	static constexpr std::uint32_t	NONE = UINT32_MAX;
+
+	enum class Content : std::uint8_t
+	{
+		UNDECLARED,
+		EMPTY,
+		ANY,
+		MIXED,
+		CHILDREN
+	};
+
+	struct Attribute
+	{
+		std::u8string								name;
+		std::u8string								value;
+		std::vector<std::u8string>	values;
+		AttributeType								type 			= AttributeType::CDATA;
+		AttributeDefault						presence 	= AttributeDefault::IMPLIED;
+	};
+
+	struct Rule
+	{
+		Content											content = Content::UNDECLARED;
+		std::vector<std::uint32_t>	alphabet;				// Sorted element symbols the model mentions
+		std::vector<std::uint32_t>	transitions;		// [state * alphabet.size() + column] -> state or NONE
+		std::vector<bool>						accepting;
+		std::vector<Attribute>			attributes;
+
+		std::uint32_t	next(std::uint32_t state, std::uint32_t symbol) const;
+	};
+
+	std::unordered_map<std::u8string, std::uint32_t, StringHash, StringEqual>	m_symbols;
+	std::vector<Rule>				m_rules;				// Indexed by symbol
+	std::u8string						m_root;
+
+	Schema() = default;
+
+	std::uint32_t		intern(std::u8string_view name);
+	std::uint32_t		find(std::u8string_view name) const;
+	std::error_code	compile_content(Rule & rule, std::u8string_view model);
+};
+
+//=============================================================================
+//
+//	VALIDATOR
+//
+//	Run-time state for validating one document against a Schema. The Parser
+//	owns one when a schema is set (see Parser::set_schema()).
+//
+//=============================================================================
+
+class Validator
+{
+private:
+	friend class Parser;		// Checkpoints
+
+	struct Frame
+	{
+		std::uint32_t		rule;
+		std::uint32_t		state;
+	};
+
+	std::shared_ptr<const Schema>														m_schema;
+	std::pmr::vector<Frame>																	m_frames;
+	std::pmr::unordered_set<String, StringHash, StringEqual>	m_ids;
+
+public:
+	Validator(std::shared_ptr<const Schema> schema, std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+
+	std::pmr::memory_resource *							resource() const	{return m_frames.get_allocator().resource();}
+	const std::shared_ptr<const Schema> &		schema() const		{return m_schema;}
+	void		set_schema(std::shared_ptr<const Schema> schema)	{m_schema = std::move(schema); reset();}
+	void		reset()				{m_frames.clear(); m_ids.clear();}
+
+	//---------------------------------------------------------------------------
+	//	Called when an element's start tag is complete (and, for an empty-element
+	//	tag, followed immediately by end_element()). start_element() checks the
+	//	element against its parent's content model, checks its attributes and
+	//	adds any declared defaults. end_element() checks that the content model
+	//	is complete and that the element's character data is allowed.
+	//---------------------------------------------------------------------------
+	std::error_code		start_element(Element & element);
+	std::error_code		end_element(const Element & element);
+
+private:
+	bool							is_valid(const Frame & frame) const;
+	std::error_code		check_attributes(const Schema::Rule & rule, Element & element);
+	std::error_code		check_value(const Schema::Attribute & attribute, std::u8string_view value);
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_SCHEMA_H
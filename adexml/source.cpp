@@ -0,0 +1,484 @@
+//=============================================================================
+//	FILE:					source.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include "source.h"
+
+// Defined by CMake when the codec libraries are found.
+#ifndef ADEXML_HAVE_ZLIB
+#define ADEXML_HAVE_ZLIB 0
+#endif
+#ifndef ADEXML_HAVE_ZSTD
+#define ADEXML_HAVE_ZSTD 0
+#endif
+
+#if ADEXML_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#if ADEXML_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace adexml
+{
+
+namespace
+{
+	constexpr std::size_t		DECODER_INPUT_BYTES = 64 * 1024;
+
+	std::error_code	io_error()	{return std::make_error_code(std::errc::io_error);}
+}
+
+//=============================================================================
+//
+//	SOURCES
+//
+//=============================================================================
+
+std::expected<std::size_t, std::error_code>
+MemorySource::read(std::span<char8_t> buffer)
+{
+	auto count = std::min(buffer.size(), m_data.size());
+	std::copy_n(m_data.begin(), count, buffer.begin());
+	m_data = m_data.subspan(count);
+	return count;
+}
+
+std::expected<std::unique_ptr<FileSource>, std::error_code>
+FileSource::open(const std::filesystem::path & file)
+{
+	std::ifstream stream(file, std::ios::binary);
+	if(!stream)
+		return std::unexpected(std::make_error_code(std::errc::no_such_file_or_directory));
+	return std::unique_ptr<FileSource>(new FileSource(std::move(stream)));
+}
+
+std::expected<std::size_t, std::error_code>
+FileSource::read(std::span<char8_t> buffer)
+{
+	m_stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	if(m_stream.bad())
+		return std::unexpected(io_error());
+	return static_cast<std::size_t>(m_stream.gcount());
+}
+
+//=============================================================================
+//
+//	CODECS
+//
+//=============================================================================
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+//	Base for decoders: owns the compressed input and a buffer of it.
+//-----------------------------------------------------------------------------
+class Decoder : public Source
+{
+protected:
+	std::unique_ptr<Source>		m_input;
+	std::vector<char8_t>			m_buffer;
+	std::size_t								m_begin		= 0;		// Unconsumed input is [m_begin,m_end)
+	std::size_t								m_end			= 0;
+	bool											m_b_eof		= false;
+
+	explicit Decoder(std::unique_ptr<Source> input) : m_input(std::move(input)), m_buffer(DECODER_INPUT_BYTES) {}
+
+	std::span<const char8_t>	pending() const			{return std::span(m_buffer).subspan(m_begin, m_end - m_begin);}
+	void											consume(std::size_t count)	{m_begin += count;}
+
+	// Refill the input buffer once it has been consumed.
+	std::error_code
+	fill()
+	{
+		if(m_begin < m_end || m_b_eof)
+			return {};
+		auto count = m_input->read(m_buffer);
+		if(!count)
+			return count.error();
+		m_begin 	= 0;
+		m_end 		= *count;
+		m_b_eof 	= (*count == 0);
+		return {};
+	}
+};
+
+class StoredDecoder : public Source
+{
+private:
+	std::unique_ptr<Source>		m_input;
+
+public:
+	explicit StoredDecoder(std::unique_ptr<Source> input) : m_input(std::move(input)) {}
+
+	std::expected<std::size_t, std::error_code>	read(std::span<char8_t> buffer) override	{return m_input->read(buffer);}
+};
+
+#if ADEXML_HAVE_ZLIB
+
+class GzipDecoder : public Decoder
+{
+private:
+	z_stream		m_stream {};
+	bool				m_b_end = false;		// The last member has ended
+
+public:
+	explicit GzipDecoder(std::unique_ptr<Source> input) : Decoder(std::move(input))
+	{
+		// 15 + 32: maximum window with gzip or zlib header detection.
+		if(inflateInit2(&m_stream, 15 + 32) != Z_OK)
+			throw std::bad_alloc();
+	}
+
+	~GzipDecoder() override		{inflateEnd(&m_stream);}
+
+	std::expected<std::size_t, std::error_code>
+	read(std::span<char8_t> buffer) override
+	{
+		std::size_t produced = 0;
+		while(produced == 0 && !m_b_end && !buffer.empty())
+		{
+			if(auto ec = fill())
+				return std::unexpected(ec);
+
+			auto input 					= pending();
+			m_stream.next_in 		= reinterpret_cast<Bytef *>(const_cast<char8_t *>(input.data()));
+			m_stream.avail_in 	= static_cast<uInt>(input.size());
+			m_stream.next_out 	= reinterpret_cast<Bytef *>(buffer.data());
+			m_stream.avail_out	= static_cast<uInt>(std::min<std::size_t>(buffer.size(), UINT32_MAX));
+
+			auto result = inflate(&m_stream, Z_NO_FLUSH);
+			consume(input.size() - m_stream.avail_in);
+			produced = reinterpret_cast<char8_t *>(m_stream.next_out) - buffer.data();
+
+			if(result == Z_STREAM_END)
+			{
+				// Another gzip member may follow.
+				if(auto ec = fill())
+					return std::unexpected(ec);
+				if(pending().empty())
+					m_b_end = true;
+				else if(inflateReset(&m_stream) != Z_OK)
+					return std::unexpected(make_error_code(Error::DECOMPRESSION_ERROR));
+			}
+			else if(result == Z_BUF_ERROR && m_b_eof && pending().empty())
+				return std::unexpected(make_error_code(Error::DECOMPRESSION_ERROR));
+			else if(result != Z_OK && result != Z_BUF_ERROR)
+				return std::unexpected(make_error_code(result == Z_MEM_ERROR ? Error::OUT_OF_MEMORY : Error::DECOMPRESSION_ERROR));
+		}
+		return produced;
+	}
+};
+
+#endif
+
+#if ADEXML_HAVE_ZSTD
+
+class ZstdDecoder : public Decoder
+{
+private:
+	ZSTD_DCtx *		m_context;
+	std::size_t		m_hint = 1;				// Non-zero while a frame is incomplete
+
+public:
+	explicit ZstdDecoder(std::unique_ptr<Source> input) : Decoder(std::move(input)), m_context(ZSTD_createDCtx())
+	{
+		if(!m_context)
+			throw std::bad_alloc();
+	}
+
+	~ZstdDecoder() override		{ZSTD_freeDCtx(m_context);}
+
+	std::expected<std::size_t, std::error_code>
+	read(std::span<char8_t> buffer) override
+	{
+		ZSTD_outBuffer out {buffer.data(), buffer.size(), 0};
+		while(out.pos == 0 && !buffer.empty())
+		{
+			if(auto ec = fill())
+				return std::unexpected(ec);
+
+			auto input = pending();
+			if(input.empty())
+			{
+				if(m_hint != 0)
+					return std::unexpected(make_error_code(Error::DECOMPRESSION_ERROR));	// Truncated frame
+				break;
+			}
+
+			ZSTD_inBuffer in {input.data(), input.size(), 0};
+			m_hint = ZSTD_decompressStream(m_context, &out, &in);
+			consume(in.pos);
+			if(ZSTD_isError(m_hint))
+				return std::unexpected(make_error_code(Error::DECOMPRESSION_ERROR));
+		}
+		return out.pos;
+	}
+};
+
+#endif
+
+} // namespace
+
+bool
+codec_available(Codec codec)
+{
+	switch(codec)
+	{
+		case Codec::STORED :	return true;
+		case Codec::GZIP :		return ADEXML_HAVE_ZLIB;
+		case Codec::ZSTD :		return ADEXML_HAVE_ZSTD;
+	}
+	return false;
+}
+
+Codec
+detect_codec(std::span<const char8_t> prefix)
+{
+	auto starts_with = [&](std::initializer_list<std::uint8_t> magic)
+		{
+			return prefix.size() >= magic.size() && std::equal(magic.begin(), magic.end(), prefix.begin());
+		};
+
+	if(starts_with({0x1F, 0x8B}))
+		return Codec::GZIP;
+	if(starts_with({0x28, 0xB5, 0x2F, 0xFD}))
+		return Codec::ZSTD;
+	if(prefix.size() >= 2 && (prefix[0] & 0x0F) == 8 && ((prefix[0] << 8) | prefix[1]) % 31 == 0)
+		return Codec::GZIP;		// zlib header
+	return Codec::STORED;
+}
+
+std::expected<std::unique_ptr<Source>, std::error_code>
+make_decoder(Codec codec, std::unique_ptr<Source> input)
+{
+	if(!codec_available(codec))
+		return std::unexpected(make_error_code(Error::CODEC_UNAVAILABLE));
+
+	try
+	{
+		switch(codec)
+		{
+#if ADEXML_HAVE_ZLIB
+			case Codec::GZIP :		return std::make_unique<GzipDecoder>(std::move(input));
+#endif
+#if ADEXML_HAVE_ZSTD
+			case Codec::ZSTD :		return std::make_unique<ZstdDecoder>(std::move(input));
+#endif
+			default :							return std::make_unique<StoredDecoder>(std::move(input));
+		}
+	}
+	catch(const std::bad_alloc &)
+	{
+		return std::unexpected(make_error_code(Error::OUT_OF_MEMORY));
+	}
+}
+
+std::expected<std::unique_ptr<Source>, std::error_code>
+open_source(const std::filesystem::path & file, std::optional<Codec> codec)
+{
+	if(!codec)
+	{
+		std::ifstream stream(file, std::ios::binary);
+		char8_t				prefix[4] {};
+		stream.read(reinterpret_cast<char *>(prefix), sizeof(prefix));
+		codec = detect_codec(std::span(prefix, static_cast<std::size_t>(stream.gcount())));
+	}
+
+	auto input = FileSource::open(file);
+	if(!input)
+		return std::unexpected(input.error());
+	return make_decoder(*codec, std::move(*input));
+}
+
+//=============================================================================
+//
+//	PARSING
+//
+//=============================================================================
+
+namespace
+{
+
+std::error_code
+write_block(Parser & parser, std::span<const char8_t> block)
+{
+	auto result = parser.write_some(block);
+	if(!result.ec && parser.is_paused())
+		return Error::PAUSED;
+	return result.ec;
+}
+
+//-----------------------------------------------------------------------------
+//	Blocks circulate between the threads: the reader takes free blocks, fills
+//	them and queues them as ready; the parser takes ready blocks, parses them
+//	and returns them to the free list.
+//-----------------------------------------------------------------------------
+class Pipeline
+{
+private:
+	struct Ready
+	{
+		std::size_t		block;
+		std::size_t		size;
+	};
+
+	Source &														m_source;
+	std::vector<std::vector<char8_t>>		m_blocks;
+	std::mutex													m_mutex;
+	std::condition_variable							m_cv_free;
+	std::condition_variable							m_cv_ready;
+	std::vector<std::size_t>						m_free;
+	std::deque<Ready>										m_ready;
+	std::error_code											m_ec;						// Error from the source
+	bool																m_b_done = false;		// The reader has finished
+	bool																m_b_stop = false;		// The parser has finished
+
+	void
+	reader()
+	{
+		for(;;)
+		{
+			std::size_t block;
+			{
+				std::unique_lock lock(m_mutex);
+				m_cv_free.wait(lock, [this] {return m_b_stop || !m_free.empty();});
+				if(m_b_stop)
+					break;
+				block = m_free.back();
+				m_free.pop_back();
+			}
+
+			std::expected<std::size_t, std::error_code> count;
+			try
+			{
+				count = m_source.read(m_blocks[block]);
+			}
+			catch(const std::bad_alloc &)
+			{
+				count = std::unexpected(make_error_code(Error::OUT_OF_MEMORY));
+			}
+
+			std::lock_guard lock(m_mutex);
+			if(!count || *count == 0)
+			{
+				m_ec 			= count ? std::error_code{} : count.error();
+				m_b_done 	= true;
+				m_cv_ready.notify_one();
+				break;
+			}
+			m_ready.push_back({block, *count});
+			m_cv_ready.notify_one();
+		}
+	}
+
+public:
+	Pipeline(Source & source, const SourceOptions & options)
+		: m_source(source)
+	{
+		auto count = std::max<std::size_t>(options.blocks, 2);
+		m_blocks.resize(count, std::vector<char8_t>(std::max<std::size_t>(options.block_bytes, 1)));
+		for(std::size_t i = 0; i < count; ++i)
+			m_free.push_back(i);
+	}
+
+	std::error_code
+	run(Parser & parser)
+	{
+		std::thread			thread([this] {reader();});
+		std::error_code ec;
+
+		for(;;)
+		{
+			Ready ready;
+			{
+				std::unique_lock lock(m_mutex);
+				m_cv_ready.wait(lock, [this] {return m_b_done || !m_ready.empty();});
+				if(m_ready.empty())
+					break;
+				ready = m_ready.front();
+				m_ready.pop_front();
+			}
+
+			ec = write_block(parser, std::span(m_blocks[ready.block]).first(ready.size));
+
+			std::lock_guard lock(m_mutex);
+			m_free.push_back(ready.block);
+			m_cv_free.notify_one();
+			if(ec)
+				break;
+		}
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_b_stop = true;
+			m_cv_free.notify_one();
+		}
+		thread.join();
+
+		if(ec)
+			return ec;
+		return m_ec;
+	}
+};
+
+} // namespace
+
+std::error_code
+parse_source(Source & source, Parser & parser, const SourceOptions & options)
+{
+	std::error_code ec;
+
+	if(options.b_threaded)
+	{
+		try
+		{
+			Pipeline pipeline(source, options);
+			ec = pipeline.run(parser);
+		}
+		catch(const std::bad_alloc &)
+		{
+			return make_error_code(Error::OUT_OF_MEMORY);
+		}
+		catch(const std::system_error & error)
+		{
+			return error.code();		// Thread creation failed
+		}
+	}
+	else
+	{
+		std::vector<char8_t> block(std::max<std::size_t>(options.block_bytes, 1));
+		for(;;)
+		{
+			auto count = source.read(block);
+			if(!count)
+				return count.error();
+			if(*count == 0)
+				break;
+			if((ec = write_block(parser, std::span(block).first(*count))))
+				break;
+		}
+	}
+
+	if(ec)
+		return ec;
+	return parser.finish();
+}
+
+} // namespace adexml
@@ -0,0 +1,144 @@
+//=============================================================================
+//	FILE:					source.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Input sources and streaming decompression in front of Parser.
+//
+//			auto source = adexml::open_source("archive.xml.gz");
+//			if(source)
+//				ec = adexml::parse_source(**source, parser);
+//
+//		parse_source() reads the source in fixed-size blocks and writes each
+//		block straight to the parser, so compressed input is never expanded
+//		into a file or one large buffer. By default the source is read (and
+//		decompressed) on a second thread while the parser works through the
+//		previous block.
+//
+//		The stored codec is always available. GZIP (and zlib) needs zlib and
+//		ZSTD needs libzstd; each is built in only if CMake found it, which
+//		codec_available() reports at run time.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_SOURCE_H
+#define GUARD_ADE_XML_SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+//=============================================================================
+//
+//	SOURCES
+//
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+//	read() fills as much of 'buffer' as it can and returns the number of bytes
+//	written, which is only zero at the end of the input.
+//-----------------------------------------------------------------------------
+class Source
+{
+public:
+	virtual ~Source() = default;
+	virtual std::expected<std::size_t, std::error_code>	read(std::span<char8_t> buffer) = 0;
+};
+
+class MemorySource : public Source
+{
+private:
+	std::span<const char8_t>		m_data;
+
+public:
+	explicit MemorySource(std::span<const char8_t> data) : m_data(data) {}
+
+	std::expected<std::size_t, std::error_code>	read(std::span<char8_t> buffer) override;
+};
+
+class FileSource : public Source
+{
+private:
+	std::ifstream								m_stream;
+
+	explicit FileSource(std::ifstream stream) : m_stream(std::move(stream)) {}
+
+public:
+	static std::expected<std::unique_ptr<FileSource>, std::error_code>	open(const std::filesystem::path & file);
+
+	std::expected<std::size_t, std::error_code>	read(std::span<char8_t> buffer) override;
+};
+
+//=============================================================================
+//
+//	CODECS
+//
+//=============================================================================
+
+enum class Codec : std::uint8_t
+{
+	STORED,
+	GZIP,				// gzip or zlib framing, including concatenated gzip members
+	ZSTD
+};
+
+bool										codec_available(Codec codec);
+
+//-----------------------------------------------------------------------------
+//	Identify the codec from the first few bytes of the input (four are
+//	enough). Anything that is not recognised is STORED.
+//-----------------------------------------------------------------------------
+Codec										detect_codec(std::span<const char8_t> prefix);
+
+//-----------------------------------------------------------------------------
+//	A source that decodes 'input'. Fails with CODEC_UNAVAILABLE if the codec
+//	was not built in. Corrupt or truncated input fails a later read() with
+//	DECOMPRESSION_ERROR.
+//-----------------------------------------------------------------------------
+std::expected<std::unique_ptr<Source>, std::error_code>	make_decoder(Codec codec, std::unique_ptr<Source> input);
+
+//-----------------------------------------------------------------------------
+//	Open a file for parsing, decoding it with 'codec' or, by default, with the
+//	codec detected from its first bytes.
+//-----------------------------------------------------------------------------
+std::expected<std::unique_ptr<Source>, std::error_code>	open_source(const std::filesystem::path & file, std::optional<Codec> codec = std::nullopt);
+
+//=============================================================================
+//
+//	PARSING
+//
+//=============================================================================
+
+struct SourceOptions
+{
+	std::size_t			block_bytes	= 64 * 1024;
+	std::size_t			blocks			= 4;				// Blocks in flight between the threads
+	bool						b_threaded	= true;			// Read the source on a second thread
+};
+
+//-----------------------------------------------------------------------------
+//	Write the whole of 'source' to 'parser' and finish() it. The parser is not
+//	reset first. Returns the first error from the source or the parser. A
+//	callback that pauses the parser stops the parse with PAUSED; the parse
+//	cannot be resumed because the remaining input has been discarded.
+//-----------------------------------------------------------------------------
+std::error_code					parse_source(Source & source, Parser & parser, const SourceOptions & options = {});
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_SOURCE_H
@@ -0,0 +1,711 @@
+//=============================================================================
+//	FILE:					static_document.h
+//	SYSTEM:
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Parsing of XML embedded in the program at compile time, into a
+//		read-only table of elements that needs no allocation or parsing at
+//		run time.
+//
+//			static constexpr auto config = adexml::parse_static<u8R"(
+//				<config>
+//					<server host="localhost" port="8080"/>
+//				</config>)">();
+//
+//			auto port = config.find(u8"config/server").attribute(u8"port");
+//
+//		An embedded resource can be parsed the same way from a constant
+//		array, for example one filled by #embed or generated by xxd:
+//
+//			static constexpr char config_xml[] = { ... };
+//			static constexpr auto config = adexml::parse_static<adexml::FixedString(config_xml)>();
+//
+//		Malformed XML is a compile error. The failing instantiation of
+//		malformed_xml_literal<> names the adexml::Error and the byte offset
+//		of the problem in its template arguments.
+//
+//		The grammar is the Parser's, with the same names, entity handling
+//		and content rules: carriage returns and line feeds are dropped from
+//		text and leading spaces and tabs are skipped, so an element's
+//		content() is what Parser delivers in Element::content. Comments,
+//		processing instructions and the XML declaration are skipped.
+//		Literals may not contain a DOCTYPE; only the predefined entities and
+//		character references are recognised. Unlike the Parser, a '<' in an
+//		attribute value is rejected.
+//
+//		Element names keep any namespace prefix, as they do in paths built
+//		by the Parser. Attributes are kept in document order.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_STATIC_DOCUMENT_H
+#define GUARD_ADE_XML_STATIC_DOCUMENT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "entity.h"
+#include "errors.h"
+
+namespace adexml
+{
+
+//-----------------------------------------------------------------------------
+//	A string usable as a template argument. A single trailing NUL, as ends a
+//	string literal, is not part of the text.
+//-----------------------------------------------------------------------------
+template<std::size_t N>
+struct FixedString
+{
+	char8_t				text[N] = {};
+	std::size_t		length 	= 0;
+
+	constexpr FixedString(const char8_t (&literal)[N])
+	{
+		for(std::size_t i = 0; i < N; ++i)
+			text[i] = literal[i];
+		length = (literal[N - 1] == 0) ? N - 1 : N;
+	}
+
+	constexpr FixedString(const char (&literal)[N])
+	{
+		for(std::size_t i = 0; i < N; ++i)
+			text[i] = static_cast<char8_t>(literal[i]);
+		length = (literal[N - 1] == 0) ? N - 1 : N;
+	}
+
+	constexpr std::u8string_view	view() const	{return {text, length};}
+};
+
+inline constexpr std::uint32_t	STATIC_NO_NODE = static_cast<std::uint32_t>(-1);
+
+struct StaticText
+{
+	std::uint32_t		offset 	= 0;
+	std::uint32_t		length 	= 0;
+};
+
+struct StaticAttribute
+{
+	StaticText			name;
+	StaticText			value;
+};
+
+struct StaticElement
+{
+	StaticText			name;
+	StaticText			content;
+	std::uint32_t		parent 						= STATIC_NO_NODE;
+	std::uint32_t		first_child 			= STATIC_NO_NODE;
+	std::uint32_t		next_sibling 			= STATIC_NO_NODE;
+	std::uint32_t		first_attribute 	= 0;
+	std::uint32_t		attribute_count 	= 0;
+};
+
+//=============================================================================
+//
+//	NODE
+//
+//	A handle to one element of a StaticDocument. A default constructed node,
+//	or one returned by a failed lookup, is empty and tests false; all of its
+//	lookups return empty nodes and values.
+//
+//=============================================================================
+
+class StaticNode
+{
+private:
+	const StaticElement *		m_elements 		= nullptr;
+	const StaticAttribute *	m_attributes 	= nullptr;
+	const char8_t *					m_text 				= nullptr;
+	std::uint32_t						m_id 					= STATIC_NO_NODE;
+
+	constexpr const StaticElement &	element() const									{return m_elements[m_id];}
+	constexpr std::u8string_view		text(StaticText range) const		{return {m_text + range.offset, range.length};}
+	constexpr StaticNode						at(std::uint32_t id) const			{return {m_elements, m_attributes, m_text, id};}
+
+public:
+	constexpr StaticNode() = default;
+	constexpr StaticNode(const StaticElement * elements, const StaticAttribute * attributes, const char8_t * text, std::uint32_t id)
+		: m_elements(elements), m_attributes(attributes), m_text(text), m_id(id) {}
+
+	constexpr explicit operator bool() const			{return m_id != STATIC_NO_NODE;}
+	constexpr std::uint32_t				id() const				{return m_id;}
+	constexpr std::u8string_view	name() const			{return *this ? text(element().name) : std::u8string_view{};}
+	constexpr std::u8string_view	content() const		{return *this ? text(element().content) : std::u8string_view{};}
+	constexpr StaticNode					parent() const		{return *this ? at(element().parent) : StaticNode{};}
+	constexpr StaticNode					first_child() const		{return *this ? at(element().first_child) : StaticNode{};}
+	constexpr StaticNode					next_sibling() const	{return *this ? at(element().next_sibling) : StaticNode{};}
+
+	constexpr std::size_t					attribute_count() const							{return *this ? element().attribute_count : 0;}
+	constexpr std::u8string_view	attribute_name(std::size_t index) const		{return text(m_attributes[element().first_attribute + index].name);}
+	constexpr std::u8string_view	attribute_value(std::size_t index) const	{return text(m_attributes[element().first_attribute + index].value);}
+
+	constexpr std::optional<std::u8string_view>
+	attribute(std::u8string_view name) const
+	{
+		for(std::size_t index = 0; index < attribute_count(); ++index)
+			if(attribute_name(index) == name)
+				return attribute_value(index);
+		return std::nullopt;
+	}
+
+	constexpr bool	has_attribute(std::u8string_view name) const	{return attribute(name).has_value();}
+
+	//---------------------------------------------------------------------------
+	//	The first child, or following sibling, with the given name.
+	//---------------------------------------------------------------------------
+	constexpr StaticNode
+	child(std::u8string_view name) const
+	{
+		auto node = first_child();
+		while(node && (node.name() != name))
+			node = node.next_sibling();
+		return node;
+	}
+
+	constexpr StaticNode
+	next_sibling(std::u8string_view name) const
+	{
+		auto node = next_sibling();
+		while(node && (node.name() != name))
+			node = node.next_sibling();
+		return node;
+	}
+
+	//---------------------------------------------------------------------------
+	//	Follow a path of child names separated by '/', taking the first child
+	//	of each name.
+	//---------------------------------------------------------------------------
+	constexpr StaticNode
+	find(std::u8string_view path) const
+	{
+		auto node = *this;
+		while(node && !path.empty())
+		{
+			auto separator = path.find(u8'/');
+			node = node.child(path.substr(0, separator));
+			path = (separator == path.npos) ? std::u8string_view{} : path.substr(separator + 1);
+		}
+		return node;
+	}
+};
+
+//=============================================================================
+//
+//	LITERAL PARSER
+//
+//	Parses the whole text into growable containers, which is only possible
+//	during constant evaluation because they are freed again before it ends.
+//	parse_static() runs it once to size the document and again to fill it.
+//
+//=============================================================================
+
+struct LiteralTree
+{
+	Error													error 				= Error::NONE;
+	std::size_t										error_offset 	= 0;
+	std::vector<StaticElement>		elements;
+	std::vector<StaticAttribute>	attributes;
+	std::u8string									text;
+};
+
+class LiteralParser
+{
+private:
+	struct Open
+	{
+		std::uint32_t		id;
+		std::uint32_t		last_child 	= STATIC_NO_NODE;
+		std::u8string		content;
+	};
+
+	std::u8string_view		m_xml;
+	std::size_t						m_pos 			= 0;
+	LiteralTree						m_tree;
+	std::vector<Open>			m_stack;
+	std::uint32_t					m_last_top 	= STATIC_NO_NODE;
+
+	static constexpr bool	is_space(char8_t ch)	{return (ch == SPACE) || (ch == CHARACTER_TABULATION) || (ch == CARRIAGE_RETURN) || (ch == LINE_FEED);}
+
+	//---------------------------------------------------------------------------
+	//	Searches, comparisons and appends are explicit loops: with UBSan enabled
+	//	GCC rejects the library versions in constant evaluation when they point
+	//	into the literal.
+	//---------------------------------------------------------------------------
+	static constexpr void
+	append(std::u8string & out, std::u8string_view text)
+	{
+		for(auto ch : text)
+			out.push_back(ch);
+	}
+
+	static constexpr bool
+	same(std::u8string_view a, std::u8string_view b)
+	{
+		if(a.size() != b.size())
+			return false;
+		for(std::size_t i = 0; i < a.size(); ++i)
+			if(a[i] != b[i])
+				return false;
+		return true;
+	}
+
+	constexpr bool
+	matches_at(std::size_t pos, std::u8string_view text) const
+	{
+		return (pos <= m_xml.size()) && (m_xml.size() - pos >= text.size()) && same(m_xml.substr(pos, text.size()), text);
+	}
+
+	constexpr std::size_t
+	find_from(std::u8string_view text) const
+	{
+		for(std::size_t pos = m_pos; pos + text.size() <= m_xml.size(); ++pos)
+			if(matches_at(pos, text))
+				return pos;
+		return m_xml.npos;
+	}
+
+	constexpr bool				at_end() const												{return m_pos >= m_xml.size();}
+	constexpr bool				next_is(std::u8string_view text) const	{return matches_at(m_pos, text);}
+	constexpr void				skip_spaces()													{while(!at_end() && is_space(m_xml[m_pos])) ++m_pos;}
+
+	constexpr Error
+	fail(Error error)
+	{
+		m_tree.error 				= error;
+		m_tree.error_offset = m_pos;
+		return error;
+	}
+
+	//---------------------------------------------------------------------------
+	//	Decode the code point at m_pos without consuming it. Malformed UTF-8
+	//	decodes as 0, which is not a name character.
+	//---------------------------------------------------------------------------
+	constexpr char32_t
+	peek(std::size_t & length) const
+	{
+		const char8_t	lead = m_xml[m_pos];
+		length = (lead < 0x80) ? 1 : (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 0;
+		if((length == 0) || (m_pos + length > m_xml.size()))
+		{
+			length = 1;
+			return 0;
+		}
+
+		char32_t code = (length == 1) ? lead : (lead & (0x7F >> length));
+		for(std::size_t i = 1; i < length; ++i)
+		{
+			const char8_t	next = m_xml[m_pos + i];
+			if((next & 0xC0) != 0x80)
+			{
+				length = 1;
+				return 0;
+			}
+			code = (code << 6) | (next & 0x3F);
+		}
+		return code;
+	}
+
+	static constexpr void
+	append_utf8(std::u8string & out, char32_t ch)
+	{
+		if(ch < 0x80)
+			out.push_back(static_cast<char8_t>(ch));
+		else if(ch < 0x800)
+		{
+			out.push_back(static_cast<char8_t>(0xC0 | (ch >> 6)));
+			out.push_back(static_cast<char8_t>(0x80 | (ch & 0x3F)));
+		}
+		else if(ch < 0x10000)
+		{
+			out.push_back(static_cast<char8_t>(0xE0 | (ch >> 12)));
+			out.push_back(static_cast<char8_t>(0x80 | ((ch >> 6) & 0x3F)));
+			out.push_back(static_cast<char8_t>(0x80 | (ch & 0x3F)));
+		}
+		else
+		{
+			out.push_back(static_cast<char8_t>(0xF0 | (ch >> 18)));
+			out.push_back(static_cast<char8_t>(0x80 | ((ch >> 12) & 0x3F)));
+			out.push_back(static_cast<char8_t>(0x80 | ((ch >> 6) & 0x3F)));
+			out.push_back(static_cast<char8_t>(0x80 | (ch & 0x3F)));
+		}
+	}
+
+	constexpr StaticText
+	append_text(std::u8string_view text)
+	{
+		StaticText range{static_cast<std::uint32_t>(m_tree.text.size()), static_cast<std::uint32_t>(text.size())};
+		append(m_tree.text, text);
+		return range;
+	}
+
+	constexpr std::u8string_view	view(StaticText range) const	{return std::u8string_view(m_tree.text).substr(range.offset, range.length);}
+
+	//---------------------------------------------------------------------------
+	//	A name at m_pos, appended to the text.
+	//---------------------------------------------------------------------------
+	constexpr Error
+	parse_name(StaticText & name)
+	{
+		const auto 	begin = m_pos;
+		std::size_t length = 0;
+		if(at_end() || !is_xml_name_start_char(peek(length)))
+			return at_end() ? fail(Error::INCOMPLETE_DOCUMENT) : fail(Error::INVALID_ELEMENT_NAME);
+
+		m_pos += length;
+		while(!at_end() && is_xml_name_char(peek(length)))
+			m_pos += length;
+
+		name = append_text(m_xml.substr(begin, m_pos - begin));
+		return Error::NONE;
+	}
+
+	//---------------------------------------------------------------------------
+	//	An entity or character reference at m_pos ('&').
+	//---------------------------------------------------------------------------
+	constexpr Error
+	parse_reference(std::u8string & out)
+	{
+		constexpr std::size_t MAX_REFERENCE = 32;
+
+		auto end = find_from(u8";");
+		if((end == m_xml.npos) || (end - m_pos > MAX_REFERENCE))
+			return fail(Error::INVALID_ENTITY_CHARACTER);
+
+		auto body = m_xml.substr(m_pos + 1, end - m_pos - 1);
+		auto ch 	= body.starts_with(char8_t(NUMBER_SIGN)) ? decode_char_reference(body) : predefined_entity(body);
+		if(!ch)
+			return fail(body.starts_with(char8_t(NUMBER_SIGN)) ? Error::INVALID_ENTITY_CHARACTER : Error::UNKNOWN_ENTITY);
+
+		append_utf8(out, *ch);
+		m_pos = end + 1;
+		return Error::NONE;
+	}
+
+	constexpr Error
+	parse_attribute(StaticElement & element)
+	{
+		StaticAttribute attribute;
+		if(auto error = parse_name(attribute.name); error != Error::NONE)
+			return error;
+
+		for(std::uint32_t index = 0; index < element.attribute_count; ++index)
+			if(view(m_tree.attributes[element.first_attribute + index].name) == view(attribute.name))
+				return fail(Error::ATTRIBUTE_DUPLICATE_NAME);
+
+		skip_spaces();
+		if(at_end() || (m_xml[m_pos] != EQUALS_SIGN))
+			return fail(at_end() ? Error::INCOMPLETE_DOCUMENT : Error::ATTRIBUTE_SYNTAX_ERROR);
+		++m_pos;
+		skip_spaces();
+		if(at_end() || ((m_xml[m_pos] != QUOTATION_MARK) && (m_xml[m_pos] != APOSTROPHE)))
+			return fail(at_end() ? Error::INCOMPLETE_DOCUMENT : Error::ATTRIBUTE_SYNTAX_ERROR);
+
+		const char8_t	delimiter = m_xml[m_pos++];
+		std::u8string	value;
+		for(;;)
+		{
+			if(at_end())
+				return fail(Error::INCOMPLETE_DOCUMENT);
+
+			const char8_t ch = m_xml[m_pos];
+			if(ch == delimiter)
+				break;
+			if(ch == LESS_THAN_SIGN)
+				return fail(Error::ATTRIBUTE_VALUE_ILLERGAL_CHAR);
+			if(ch == AMPERSAND)
+			{
+				if(auto error = parse_reference(value); error != Error::NONE)
+					return error;
+			}
+			else
+			{
+				value.push_back(ch);
+				++m_pos;
+			}
+		}
+		++m_pos;
+
+		attribute.value = append_text(value);
+		m_tree.attributes.push_back(attribute);
+		++element.attribute_count;
+		return Error::NONE;
+	}
+
+	constexpr Error
+	parse_start_tag()
+	{
+		++m_pos;		// '<'
+
+		const auto 		id = static_cast<std::uint32_t>(m_tree.elements.size());
+		StaticElement	element;
+		if(auto error = parse_name(element.name); error != Error::NONE)
+			return error;
+		element.first_attribute = static_cast<std::uint32_t>(m_tree.attributes.size());
+
+		bool b_closed = false;
+		for(;;)
+		{
+			skip_spaces();
+			if(at_end())
+				return fail(Error::INCOMPLETE_DOCUMENT);
+
+			const char8_t ch = m_xml[m_pos];
+			if(ch == GREATER_THAN_SIGN)
+			{
+				++m_pos;
+				break;
+			}
+			if(ch == SOLIDUS)
+			{
+				if(!next_is(u8"/>"))
+					return fail(Error::START_TAG_SYNTAX_ERROR);
+				m_pos += 2;
+				b_closed = true;
+				break;
+			}
+			if(auto error = parse_attribute(element); error != Error::NONE)
+				return (error == Error::INVALID_ELEMENT_NAME) ? fail(Error::ATTRIBUTE_SYNTAX_ERROR) : error;
+		}
+
+		if(m_stack.empty())
+		{
+			if(m_last_top != STATIC_NO_NODE)
+				m_tree.elements[m_last_top].next_sibling = id;
+			m_last_top = id;
+		}
+		else
+		{
+			auto & parent 	= m_stack.back();
+			element.parent 	= parent.id;
+			if(parent.last_child == STATIC_NO_NODE)
+				m_tree.elements[parent.id].first_child = id;
+			else
+				m_tree.elements[parent.last_child].next_sibling = id;
+			parent.last_child = id;
+		}
+
+		element.content = append_text({});
+		m_tree.elements.push_back(element);
+		if(!b_closed)
+			m_stack.push_back(Open{id, STATIC_NO_NODE, {}});
+		return Error::NONE;
+	}
+
+	constexpr Error
+	parse_end_tag()
+	{
+		m_pos += 2;		// "</"
+
+		// The name is compared in place rather than appended to the text.
+		const auto 	begin 	= m_pos;
+		std::size_t length 	= 0;
+		if(at_end() || !is_xml_name_start_char(peek(length)))
+			return fail(at_end() ? Error::INCOMPLETE_DOCUMENT : Error::INVALID_ELEMENT_NAME);
+		while(!at_end() && is_xml_name_char(peek(length)))
+			m_pos += length;
+		const auto 	name 		= m_xml.substr(begin, m_pos - begin);
+
+		skip_spaces();
+		if(at_end() || (m_xml[m_pos] != GREATER_THAN_SIGN))
+			return fail(at_end() ? Error::INCOMPLETE_DOCUMENT : Error::INVALID_ELEMENT_NAME);
+		if(m_stack.empty() || !same(view(m_tree.elements[m_stack.back().id].name), name))
+			return fail(Error::ELEMENT_TAG_MISMATCH);
+		++m_pos;
+
+		auto & open = m_stack.back();
+		m_tree.elements[open.id].content = append_text(open.content);
+		m_stack.pop_back();
+		return Error::NONE;
+	}
+
+	//---------------------------------------------------------------------------
+	//	Skip to the end of a construct that is not kept.
+	//---------------------------------------------------------------------------
+	constexpr Error
+	skip_past(std::u8string_view terminator)
+	{
+		auto end = find_from(terminator);
+		if(end == m_xml.npos)
+			return fail(Error::INCOMPLETE_DOCUMENT);
+		m_pos = end + terminator.size();
+		return Error::NONE;
+	}
+
+	constexpr Error
+	parse_markup()
+	{
+		if(next_is(u8"<!--"))
+			return skip_past(u8"-->");
+
+		if(next_is(u8"<![CDATA["))
+		{
+			if(m_stack.empty())
+				return fail(Error::INVALID_MARKUP_DECLARATION);
+			m_pos += 9;
+			auto end = find_from(u8"]]>");
+			if(end == m_xml.npos)
+				return fail(Error::INCOMPLETE_DOCUMENT);
+			append(m_stack.back().content, m_xml.substr(m_pos, end - m_pos));
+			m_pos = end + 3;
+			return Error::NONE;
+		}
+
+		if(next_is(u8"<?"))
+		{
+			m_pos += 2;
+			std::size_t length = 0;
+			if(at_end() || !is_xml_name_start_char(peek(length)))
+				return fail(at_end() ? Error::INCOMPLETE_DOCUMENT : Error::INVALID_ELEMENT_NAME);
+			return skip_past(u8"?>");
+		}
+
+		if(next_is(u8"<!"))
+			return fail(Error::INVALID_MARKUP_DECLARATION);
+
+		if(next_is(u8"</"))
+			return parse_end_tag();
+
+		return parse_start_tag();
+	}
+
+	//---------------------------------------------------------------------------
+	//	Text follows the Parser's rules: line breaks are dropped and leading
+	//	spaces and tabs skipped. Text outside any element is ignored.
+	//---------------------------------------------------------------------------
+	constexpr Error
+	parse_text()
+	{
+		const char8_t ch = m_xml[m_pos];
+		if(m_stack.empty())
+		{
+			++m_pos;
+			return Error::NONE;
+		}
+
+		auto & content = m_stack.back().content;
+		if(ch == AMPERSAND)
+			return parse_reference(content);
+
+		++m_pos;
+		if((ch == CARRIAGE_RETURN) || (ch == LINE_FEED))
+			return Error::NONE;
+		if(((ch == SPACE) || (ch == CHARACTER_TABULATION)) && content.empty())
+			return Error::NONE;
+		content.push_back(ch);
+		return Error::NONE;
+	}
+
+public:
+	constexpr explicit LiteralParser(std::u8string_view xml) : m_xml(xml) {}
+
+	constexpr LiteralTree
+	parse() &&
+	{
+		while(!at_end())
+		{
+			auto error = (m_xml[m_pos] == LESS_THAN_SIGN) ? parse_markup() : parse_text();
+			if(error != Error::NONE)
+				return std::move(m_tree);
+		}
+
+		if(!m_stack.empty() || m_tree.elements.empty())
+			fail(Error::INCOMPLETE_DOCUMENT);
+		return std::move(m_tree);
+	}
+};
+
+//=============================================================================
+//
+//	DOCUMENT
+//
+//=============================================================================
+
+template<std::size_t ELEMENTS, std::size_t ATTRIBUTES, std::size_t BYTES>
+class StaticDocument
+{
+private:
+	std::array<StaticElement, ELEMENTS>			m_elements 		= {};
+	std::array<StaticAttribute, ATTRIBUTES>	m_attributes 	= {};
+	std::array<char8_t, BYTES>							m_text 				= {};
+
+public:
+	constexpr explicit
+	StaticDocument(const LiteralTree & tree)
+	{
+		for(std::size_t i = 0; i < ELEMENTS; ++i)		m_elements[i] 	= tree.elements[i];
+		for(std::size_t i = 0; i < ATTRIBUTES; ++i)	m_attributes[i] = tree.attributes[i];
+		for(std::size_t i = 0; i < BYTES; ++i)			m_text[i] 			= tree.text[i];
+	}
+
+	static constexpr std::size_t	element_count()		{return ELEMENTS;}
+
+	constexpr StaticNode	node(std::uint32_t id) const	{return {m_elements.data(), m_attributes.data(), m_text.data(), id};}
+	constexpr StaticNode	root() const									{return node(0);}
+
+	//---------------------------------------------------------------------------
+	//	Follow a path from the top level, e.g. "config/server", taking the
+	//	first element of each name.
+	//---------------------------------------------------------------------------
+	constexpr StaticNode
+	find(std::u8string_view path) const
+	{
+		auto separator 	= path.find(u8'/');
+		auto top 				= root();
+		while(top && (top.name() != path.substr(0, separator)))
+			top = top.next_sibling();
+		return (separator == path.npos) ? top : top.find(path.substr(separator + 1));
+	}
+};
+
+//-----------------------------------------------------------------------------
+//	Instantiated only for malformed XML, to stop the compile. ERROR and
+//	OFFSET say what is wrong and where.
+//-----------------------------------------------------------------------------
+template<Error ERROR, std::size_t OFFSET>
+consteval void
+malformed_xml_literal()
+{
+	static_assert(ERROR == Error::NONE, "adexml::parse_static: malformed XML (see the error and byte offset in the template arguments)");
+}
+
+struct StaticLayout
+{
+	Error						error 				= Error::NONE;
+	std::size_t			error_offset	= 0;
+	std::size_t			elements 			= 0;
+	std::size_t			attributes 		= 0;
+	std::size_t			bytes 				= 0;
+};
+
+constexpr StaticLayout
+measure_literal(std::u8string_view xml)
+{
+	auto tree = LiteralParser(xml).parse();
+	return {tree.error, tree.error_offset, tree.elements.size(), tree.attributes.size(), tree.text.size()};
+}
+
+template<FixedString XML>
+consteval auto
+parse_static()
+{
+	constexpr auto layout = measure_literal(XML.view());
+	if constexpr (layout.error != Error::NONE)
+		malformed_xml_literal<layout.error, layout.error_offset>();
+	else
+		return StaticDocument<layout.elements, layout.attributes, layout.bytes>(LiteralParser(XML.view()).parse());
+}
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_STATIC_DOCUMENT_H
@@ -0,0 +1,52 @@
+//=============================================================================
+//	FILE:					strings.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		String and hashing types shared by the parser, its elements and the
+//		entity table.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_STRINGS_H
+#define GUARD_ADE_XML_STRINGS_H
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace adexml
+{
+
+//-----------------------------------------------------------------------------
+//	Transparent hashing so that attributes can be looked up with a string view
+//	without constructing a temporary key.
+//-----------------------------------------------------------------------------
+struct StringHash
+{
+	using is_transparent = void;
+	std::size_t	operator()(std::u8string_view text) const noexcept	{return std::hash<std::u8string_view>{}(text);}
+};
+
+struct StringEqual
+{
+	using is_transparent = void;
+	bool				operator()(std::u8string_view lhs, std::u8string_view rhs) const noexcept	{return lhs == rhs;}
+};
+
+//-----------------------------------------------------------------------------
+//	All strings and containers owned by the parser and its elements allocate
+//	from a std::pmr::memory_resource supplied to the Parser.
+//-----------------------------------------------------------------------------
+using String				= std::pmr::u8string;
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_STRINGS_H
@@ -0,0 +1,457 @@
+//=============================================================================
+//	FILE:					tape.cpp
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Layout, in host byte order:
+//
+//			header		magic "ADEXMLTP", u32 version, u32 byte order mark,
+//								u64 word count, u64 event count, u64 string count,
+//								u64 pool bytes
+//			words			u32 event words, padded to a multiple of 8 bytes
+//			offsets		u64 offset of each string in the pool, plus the end
+//			pool			string bytes
+//
+//		A START event is START_WORDS words:
+//
+//			action | flags << 8 | element type << 16
+//			namespace string id
+//			name string id
+//			attribute count
+//			offset (low word), offset (high word)
+//
+//		followed by a (name, value) pair of string ids for each attribute.
+//		FLAG_CONTEXT marks an element that was already open when recording
+//		began; replay pushes it without delivering an event.
+//		An END event closes the innermost element and is END_WORDS words:
+//
+//			action
+//			content string id
+//=============================================================================
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "tape.h"
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ADEXML_HAVE_MMAP 1
+#endif
+
+namespace adexml
+{
+
+namespace
+{
+	constexpr char						TAPE_MAGIC[8]		= {'A','D','E','X','M','L','T','P'};
+	constexpr std::uint32_t		TAPE_VERSION		= 1;
+	constexpr std::uint32_t		TAPE_BYTE_ORDER	= 0x01020304;
+	constexpr std::size_t			HEADER_SIZE			= 48;
+	constexpr std::size_t			START_WORDS			= 6;
+	constexpr std::size_t			END_WORDS				= 2;
+
+	constexpr std::uint32_t		FLAG_CLOSED			= 0x01;
+	constexpr std::uint32_t		FLAG_CONTEXT		= 0x02;
+
+	struct Header
+	{
+		char						magic[8];
+		std::uint32_t		version;
+		std::uint32_t		byte_order;
+		std::uint64_t		word_count;
+		std::uint64_t		event_count;
+		std::uint64_t		string_count;
+		std::uint64_t		pool_bytes;
+	};
+	static_assert(sizeof(Header) == HEADER_SIZE);
+
+	constexpr std::size_t	padded(std::size_t bytes)		{return (bytes + 7) & ~std::size_t(7);}
+
+	//---------------------------------------------------------------------------
+	//	Storage for a tape taken from a recorder, section by section.
+	//---------------------------------------------------------------------------
+	struct Sections
+	{
+		std::vector<std::uint32_t>	words;
+		std::vector<std::uint64_t>	offsets;
+		std::u8string								pool;
+	};
+}
+
+//=============================================================================
+//
+//	RECORDER
+//
+//=============================================================================
+
+std::uint32_t
+TapeRecorder::intern(std::u8string_view text)
+{
+	auto it = m_strings.find(text);
+	if(it != m_strings.end())
+		return *it;
+
+	auto id = static_cast<std::uint32_t>(m_string_offsets.size() - 1);
+	m_pool.append(text);
+	m_string_offsets.push_back(m_pool.size());
+	m_strings.insert(id);
+	return id;
+}
+
+void
+TapeRecorder::clear()
+{
+	m_words.clear();
+	m_strings.clear();
+	m_string_offsets.assign(1, 0);
+	m_pool.clear();
+	m_events = 0;
+}
+
+void
+TapeRecorder::record_start(const Element & element, std::uint32_t flags)
+{
+	m_words.push_back(	static_cast<std::uint32_t>(Parser::ACTION_START_ELEMENT) | ((flags | (element.b_closed ? FLAG_CLOSED : 0)) << 8) |
+											(static_cast<std::uint32_t>(element.type) << 16) );
+	m_words.push_back(intern(element.name_space));
+	m_words.push_back(intern(element.name));
+	m_words.push_back(static_cast<std::uint32_t>(element.attributes.size()));
+	m_words.push_back(static_cast<std::uint32_t>(element.offset));
+	m_words.push_back(static_cast<std::uint32_t>(element.offset >> 32));
+
+	for(auto & [name, value] : element.attributes)
+	{
+		m_words.push_back(intern(name));
+		m_words.push_back(intern(value));
+	}
+}
+
+std::error_code
+TapeRecorder::on_event(Parser::Action action, const String &, const ElementStack & element_stack)
+{
+	if(element_stack.empty() || (action != Parser::ACTION_START_ELEMENT && action != Parser::ACTION_END_ELEMENT))
+		return {};
+
+	const auto & element = element_stack.back();
+
+	// Recording began part way through the document; record the open
+	// elements (including this one for an END) so the tape stands alone.
+	if(m_words.empty())
+	{
+		auto open = element_stack.size() - (action == Parser::ACTION_START_ELEMENT ? 1 : 0);
+		for(std::size_t i = 0; i < open; ++i)
+			record_start(element_stack[i], FLAG_CONTEXT);
+	}
+
+	if(action == Parser::ACTION_END_ELEMENT)
+	{
+		m_words.push_back(static_cast<std::uint32_t>(action));
+		m_words.push_back(intern(element.content));
+		++m_events;
+		return {};
+	}
+
+	record_start(element, 0);
+	++m_events;
+	return {};
+}
+
+Tape
+TapeRecorder::make_tape(std::shared_ptr<const void> storage, std::span<const std::uint32_t> words,
+												std::span<const std::uint64_t> offsets, std::u8string_view pool) const
+{
+	Tape tape;
+	tape.m_storage					= std::move(storage);
+	tape.m_words						= words;
+	tape.m_string_offsets		= offsets;
+	tape.m_pool							= pool;
+	tape.m_events						= m_events;
+	return tape;
+}
+
+Tape
+TapeRecorder::tape() const
+{
+	auto sections = std::make_shared<Sections>(m_words, m_string_offsets, m_pool);
+	return make_tape(sections, sections->words, sections->offsets, sections->pool);
+}
+
+Tape
+TapeRecorder::take()
+{
+	auto sections = std::make_shared<Sections>(std::move(m_words), std::move(m_string_offsets), std::move(m_pool));
+	auto tape = make_tape(sections, sections->words, sections->offsets, sections->pool);
+	clear();
+	return tape;
+}
+
+//=============================================================================
+//
+//	TAPE
+//
+//=============================================================================
+
+std::error_code
+Tape::bind(std::shared_ptr<const void> storage, std::span<const std::byte> data)
+{
+	const auto invalid = make_error_code(Error::INVALID_TAPE);
+
+	Header header;
+	if(data.size() < HEADER_SIZE)
+		return invalid;
+	std::memcpy(&header, data.data(), HEADER_SIZE);
+
+	if(std::memcmp(header.magic, TAPE_MAGIC, sizeof(TAPE_MAGIC)) != 0 || header.version != TAPE_VERSION || header.byte_order != TAPE_BYTE_ORDER)
+		return invalid;
+
+	// Check the section sizes without overflowing.
+	auto remaining = data.size() - HEADER_SIZE;
+	if(header.word_count > remaining / sizeof(std::uint32_t))
+		return invalid;
+	auto words_bytes = padded(header.word_count * sizeof(std::uint32_t));
+	if(words_bytes > remaining)
+		return invalid;
+	remaining -= words_bytes;
+	if(header.string_count >= remaining / sizeof(std::uint64_t))
+		return invalid;
+	auto offsets_bytes = (header.string_count + 1) * sizeof(std::uint64_t);
+	if(header.pool_bytes != remaining - offsets_bytes)
+		return invalid;
+
+	auto words 		= reinterpret_cast<const std::uint32_t *>(data.data() + HEADER_SIZE);
+	auto offsets 	= reinterpret_cast<const std::uint64_t *>(data.data() + HEADER_SIZE + words_bytes);
+	auto pool 		= reinterpret_cast<const char8_t *>(data.data() + HEADER_SIZE + words_bytes + offsets_bytes);
+
+	if(offsets[0] != 0 || offsets[header.string_count] != header.pool_bytes)
+		return invalid;
+	for(std::size_t i = 0; i < header.string_count; ++i)
+		if(offsets[i] > offsets[i + 1])
+			return invalid;
+
+	m_storage					= std::move(storage);
+	m_words						= {words, header.word_count};
+	m_string_offsets	= {offsets, header.string_count + 1};
+	m_pool						= {pool, header.pool_bytes};
+	m_events					= header.event_count;
+	return {};
+}
+
+std::size_t
+Tape::size_bytes() const
+{
+	return HEADER_SIZE + padded(m_words.size_bytes()) + m_string_offsets.size_bytes() + m_pool.size();
+}
+
+std::u8string_view
+Tape::string(std::uint32_t id) const
+{
+	return m_pool.substr(m_string_offsets[id], m_string_offsets[id + 1] - m_string_offsets[id]);
+}
+
+std::expected<Tape, std::error_code>
+Tape::open(const std::filesystem::path & file)
+{
+	Tape tape;
+
+#if ADEXML_HAVE_MMAP
+	int fd = ::open(file.c_str(), O_RDONLY);
+	if(fd < 0)
+		return std::unexpected(std::error_code(errno, std::system_category()));
+
+	struct stat info {};
+	if(::fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		::close(fd);
+		return std::unexpected(make_error_code(Error::INVALID_TAPE));
+	}
+
+	auto size 		= static_cast<std::size_t>(info.st_size);
+	auto address 	= ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(address == MAP_FAILED)
+		return std::unexpected(std::error_code(errno, std::system_category()));
+
+	std::shared_ptr<const void> storage(address, [size](const void * ptr) {::munmap(const_cast<void *>(ptr), size);});
+	if(auto ec = tape.bind(std::move(storage), {static_cast<const std::byte *>(address), size}))
+		return std::unexpected(ec);
+#else
+	std::error_code ec;
+	auto size = std::filesystem::file_size(file, ec);
+	if(ec)
+		return std::unexpected(ec);
+
+	auto storage = std::make_shared<std::vector<std::byte>>(size);
+	std::ifstream stream(file, std::ios::binary);
+	if(!stream.read(reinterpret_cast<char *>(storage->data()), static_cast<std::streamsize>(size)))
+		return std::unexpected(std::make_error_code(std::errc::io_error));
+
+	auto bytes = std::span<const std::byte>(*storage);
+	if(auto ec = tape.bind(std::move(storage), bytes))
+		return std::unexpected(ec);
+#endif
+
+	return tape;
+}
+
+std::error_code
+Tape::save(const std::filesystem::path & file) const
+{
+	static constexpr std::uint64_t	EMPTY_OFFSETS[] = {0};
+	static constexpr char						PADDING[8]			= {};
+
+	auto offsets = m_string_offsets.empty() ? std::span<const std::uint64_t>(EMPTY_OFFSETS) : m_string_offsets;
+
+	Header header {};
+	std::memcpy(header.magic, TAPE_MAGIC, sizeof(TAPE_MAGIC));
+	header.version 				= TAPE_VERSION;
+	header.byte_order 		= TAPE_BYTE_ORDER;
+	header.word_count 		= m_words.size();
+	header.event_count		= m_events;
+	header.string_count		= offsets.size() - 1;
+	header.pool_bytes			= m_pool.size();
+
+	std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+	if(!stream)
+		return std::make_error_code(std::errc::io_error);
+
+	auto write = [&](const void * data, std::size_t size) {stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));};
+	write(&header, HEADER_SIZE);
+	write(m_words.data(), m_words.size_bytes());
+	write(PADDING, padded(m_words.size_bytes()) - m_words.size_bytes());
+	write(offsets.data(), offsets.size_bytes());
+	write(m_pool.data(), m_pool.size());
+	if(!stream)
+		return std::make_error_code(std::errc::io_error);
+	return {};
+}
+
+std::error_code
+Tape::replay(const Parser::Callback & callback, std::pmr::memory_resource * resource) const
+{
+	TapePlayer player(resource);
+	return player.play(*this, callback);
+}
+
+//=============================================================================
+//
+//	PLAYER
+//
+//=============================================================================
+
+Element &
+TapePlayer::push()
+{
+	if(m_pool.empty())
+		return m_stack.emplace_back();
+
+	m_stack.push_back(std::move(m_pool.back()));
+	m_pool.pop_back();
+	m_stack.back().clear();
+	return m_stack.back();
+}
+
+void
+TapePlayer::pop()
+{
+	m_pool.push_back(std::move(m_stack.back()));
+	m_stack.pop_back();
+	auto slash = m_path.rfind(u8'/');
+	m_path.resize(slash == String::npos ? 0 : slash);
+}
+
+std::error_code
+TapePlayer::play(const Tape & tape, const Parser::Callback & callback)
+{
+	const auto invalid 			= make_error_code(Error::INVALID_TAPE);
+	const auto strings 			= tape.string_count();
+	const auto words				= tape.m_words;
+	auto resource						= m_stack.get_allocator().resource();
+
+	while(!m_stack.empty())
+		pop();
+	m_path.clear();
+
+	try
+	{
+		for(std::size_t pos = 0; pos < words.size();)
+		{
+			auto action = static_cast<Parser::Action>(words[pos] & 0xFF);
+
+			if(action == Parser::ACTION_START_ELEMENT)
+			{
+				if(words.size() - pos < START_WORDS)
+					return invalid;
+
+				auto event 			= words.subspan(pos, START_WORDS);
+				auto flags			= (event[0] >> 8) & 0xFF;
+				auto type				= (event[0] >> 16) & 0xFF;
+				auto attributes = event[3];
+				pos += START_WORDS;
+
+				if(event[1] >= strings || event[2] >= strings || type > static_cast<std::uint32_t>(ElementType::DTD) || (words.size() - pos) / 2 < attributes)
+					return invalid;
+
+				auto & element 			= push();
+				element.name_space.assign(tape.string(event[1]));
+				element.name.assign(tape.string(event[2]));
+				element.offset			= static_cast<std::uint64_t>(event[4]) | (static_cast<std::uint64_t>(event[5]) << 32);
+				element.type				= static_cast<ElementType>(type);
+				element.b_closed		= (flags & FLAG_CLOSED) != 0;
+
+				for(std::uint32_t i = 0; i < attributes; ++i, pos += 2)
+				{
+					if(words[pos] >= strings || words[pos + 1] >= strings)
+						return invalid;
+					element.attributes.insert_or_assign(String(tape.string(words[pos]), resource), tape.string(words[pos + 1]));
+				}
+
+				if(!m_path.empty())
+					m_path.push_back(u8'/');
+				m_path.append(element.name);
+
+				if(flags & FLAG_CONTEXT)
+					continue;
+
+				if(callback)
+					if(auto ec = callback(action, m_path, m_stack))
+						return ec;
+
+				if(element.b_closed)
+					pop();
+			}
+			else if(action == Parser::ACTION_END_ELEMENT)
+			{
+				if(words.size() - pos < END_WORDS || m_stack.empty() || words[pos + 1] >= strings)
+					return invalid;
+
+				m_stack.back().content.assign(tape.string(words[pos + 1]));
+				pos += END_WORDS;
+
+				if(callback)
+					if(auto ec = callback(action, m_path, m_stack))
+						return ec;
+
+				pop();
+			}
+			else
+				return invalid;
+		}
+	}
+	catch(const std::bad_alloc &)
+	{
+		return make_error_code(Error::OUT_OF_MEMORY);
+	}
+
+	return {};
+}
+
+} // namespace adexml
@@ -0,0 +1,186 @@
+//=============================================================================
+//	FILE:					tape.h
+//	SYSTEM:				
+//	DESCRIPTION:
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Event tapes record the events a parser delivers so that they can be
+//		replayed to any callback without parsing the document again.
+//
+//			adexml::TapeRecorder	recorder;
+//			adexml::Parser				parser(recorder.callback());
+//			... write the document ...
+//			auto tape = recorder.tape();
+//
+//			tape.replay(first_pass.callback());
+//			tape.replay(second_pass.callback());
+//
+//		A tape is a sequence of 32-bit words plus a deduplicated string pool:
+//		names, namespaces, attribute values and content are stored once and
+//		referred to by string id. The saved form is the in-memory form, so
+//		Tape::open() maps the file and replays from the mapping directly.
+//		Words are in host byte order; a tape saved on a machine of the other
+//		endianness is rejected.
+//
+//		Replay rebuilds the element stack and path exactly as the parser
+//		presents them, except that an element's content is only available at
+//		its END event; at a child's START its ancestors' content is empty.
+//		A tape is immutable and may be replayed from several threads at once.
+//
+//		A recorder that starts (or is cleared) part way through a document
+//		first records the elements already open as context, which replay
+//		rebuilds without delivering. Every tape can therefore be replayed on
+//		its own, so a long parse can be cut into a series of tapes.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_TAPE_H
+#define GUARD_ADE_XML_TAPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+#include "xml_parser.h"
+
+namespace adexml
+{
+
+//=============================================================================
+//
+//	TAPE
+//
+//=============================================================================
+
+class Tape
+{
+private:
+	friend class TapeRecorder;
+	friend class TapePlayer;
+
+	std::shared_ptr<const void>		m_storage;			// Owns the memory behind the spans
+	std::span<const std::uint32_t>	m_words;
+	std::span<const std::uint64_t>	m_string_offsets;	// string_count + 1 entries into m_pool
+	std::u8string_view							m_pool;
+	std::uint64_t										m_events = 0;
+
+	std::error_code		bind(std::shared_ptr<const void> storage, std::span<const std::byte> data);
+	std::u8string_view	string(std::uint32_t id) const;
+
+public:
+	Tape() = default;
+
+	//---------------------------------------------------------------------------
+	//	open() maps a saved tape (or reads it where mapping is unavailable).
+	//---------------------------------------------------------------------------
+	static std::expected<Tape, std::error_code>	open(const std::filesystem::path & file);
+	std::error_code			save(const std::filesystem::path & file) const;
+
+	std::uint64_t				event_count() const		{return m_events;}
+	std::size_t					string_count() const	{return m_string_offsets.empty() ? 0 : m_string_offsets.size() - 1;}
+	std::size_t					size_bytes() const;
+	bool								empty() const					{return m_events == 0;}
+
+	//---------------------------------------------------------------------------
+	//	Deliver the recorded events to 'callback'. Stops at, and returns, the
+	//	first error the callback returns.
+	//---------------------------------------------------------------------------
+	std::error_code			replay(const Parser::Callback & callback, std::pmr::memory_resource * resource = std::pmr::get_default_resource()) const;
+};
+
+//-----------------------------------------------------------------------------
+//	Replays tapes, keeping its element stack and path buffers from one tape
+//	to the next. Use one per thread.
+//-----------------------------------------------------------------------------
+class TapePlayer
+{
+private:
+	ElementStack		m_stack;
+	ElementStack		m_pool;					// Retired elements kept for their capacity, as in Parser
+	String					m_path;
+
+	Element &				push();
+	void						pop();
+
+public:
+	explicit TapePlayer(std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+		: m_stack(resource), m_pool(resource), m_path(resource) {}
+
+	//---------------------------------------------------------------------------
+	//	Replay one tape from an empty stack, as Tape::replay().
+	//---------------------------------------------------------------------------
+	std::error_code	play(const Tape & tape, const Parser::Callback & callback);
+};
+
+//=============================================================================
+//
+//	RECORDER
+//
+//=============================================================================
+
+class TapeRecorder
+{
+private:
+	//---------------------------------------------------------------------------
+	//	The string set holds ids and hashes them through the pool, so each
+	//	string is stored once.
+	//---------------------------------------------------------------------------
+	struct StringKey
+	{
+		using is_transparent = void;
+
+		const TapeRecorder *	recorder;
+
+		std::size_t	operator()(std::uint32_t id) const							{return std::hash<std::u8string_view>{}(recorder->string(id));}
+		std::size_t	operator()(std::u8string_view text) const				{return std::hash<std::u8string_view>{}(text);}
+		bool				operator()(std::uint32_t a, std::uint32_t b) const	{return a == b;}
+		bool				operator()(std::uint32_t a, std::u8string_view b) const	{return recorder->string(a) == b;}
+		bool				operator()(std::u8string_view a, std::uint32_t b) const	{return a == recorder->string(b);}
+	};
+
+	std::vector<std::uint32_t>		m_words;
+	std::vector<std::uint64_t>		m_string_offsets {0};
+	std::u8string									m_pool;
+	std::unordered_set<std::uint32_t, StringKey, StringKey>	m_strings {16, StringKey{this}, StringKey{this}};
+	std::uint64_t									m_events = 0;
+
+	std::u8string_view	string(std::uint32_t id) const	{return std::u8string_view(m_pool).substr(m_string_offsets[id], m_string_offsets[id + 1] - m_string_offsets[id]);}
+	std::uint32_t				intern(std::u8string_view text);
+	void								record_start(const Element & element, std::uint32_t flags);
+	Tape								make_tape(std::shared_ptr<const void> storage, std::span<const std::uint32_t> words,
+																std::span<const std::uint64_t> offsets, std::u8string_view pool) const;
+
+public:
+	TapeRecorder() = default;
+	TapeRecorder(const TapeRecorder &) = delete;
+	TapeRecorder & operator=(const TapeRecorder &) = delete;
+
+	Parser::Callback		callback()		{return [this](auto action, auto & path, auto & stack) {return on_event(action, path, stack);};}
+	std::error_code			on_event(Parser::Action action, const String & path, const ElementStack & element_stack);
+
+	std::uint64_t				event_count() const	{return m_events;}
+	void								clear();
+
+	//---------------------------------------------------------------------------
+	//	tape() copies the events recorded so far into a tape and keeps them.
+	//	take() moves them into a tape without copying and clears the recorder.
+	//---------------------------------------------------------------------------
+	Tape								tape() const;
+	Tape								take();
+};
+
+} // namespace adexml
+
+#endif // ! defined GUARD_ADE_XML_TAPE_H
@@ -42,10 +42,14 @@ code_length(char8_t u8)
 class U8Parser
 {
 private:
-	size_t						m_codelen = 0;
+	std::uint8_t			m_codelen = 0;
 	char32_t					m_code 		= 0;
 
 public:
+	// The partial sequence being decoded, for parser checkpoints.
+	std::uint64_t			state() const										{return (static_cast<std::uint64_t>(m_codelen) << 32) | m_code;}
+	void							set_state(std::uint64_t state)	{m_codelen = static_cast<std::uint8_t>(state >> 32); m_code = static_cast<char32_t>(state);}
+
 	std::optional<char32_t> put(char8_t u8)
 		{
 			static const size_t trailingbytes[] = { 1,1,1,1,1,1,1,1,2,2,2,2,3,3,4,5 };
@@ -54,7 +58,7 @@ public:
 			{
 				if((u8 & 0x80) == 0)
 					return static_cast<char32_t>(u8);
-				m_codelen = trailingbytes[(u8>>2)&0x0F];
+				m_codelen = static_cast<std::uint8_t>(trailingbytes[(u8>>2)&0x0F]);
 				m_code 		= u8 & (0x1F >> (m_codelen-1));
 				return {};
 			}
@@ -126,8 +130,9 @@ u8_to_u32( const std::u8string & u8 )
 }
 
 
+template<typename Alloc>
 inline int
-u32_to_u8(uint32_t u32, std::u8string & out_u8)
+u32_to_u8(uint32_t u32, std::basic_string<char8_t, std::char_traits<char8_t>, Alloc> & out_u8)
 {
 	int len=0;
 
@@ -11,9 +11,24 @@
 #include <iostream>
 #include <fstream>
 #include <format>
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <cstdint>
+#include <new>
 #include "xml_parser.h"
+#include "charset.h"
+#include "fingerprint.h"
+#include "schema.h"
+
+//-----------------------------------------------------------------------------
+//	Statistics instrumentation, compiled out unless ADEXML_ENABLE_STATS is set.
+//-----------------------------------------------------------------------------
+#if ADEXML_ENABLE_STATS
+#define ADEXML_STATS(...)		__VA_ARGS__
+#else
+#define ADEXML_STATS(...)
+#endif
 
 //=============================================================================
 //
@@ -31,24 +46,896 @@
 namespace adexml
 {
 
-std::error_code
-Parser::write(std::span<char8_t> data)
-{
-	std::error_code ec;
+namespace
+{
+	constexpr std::u8string_view	KEYWORD_COMMENT	= u8"--";
+	constexpr std::u8string_view	KEYWORD_CDATA		= u8"[CDATA[";
+	constexpr std::u8string_view	KEYWORD_DOCTYPE	= u8"DOCTYPE";
+
+	constexpr std::uint8_t				DOCTYPE_IN_SUBSET		= 0x01;
+	constexpr std::uint8_t				DOCTYPE_IN_COMMENT	= 0x02;
+	constexpr std::uint8_t				DOCTYPE_IN_PI				= 0x04;
+
+	constexpr std::uint32_t				saturate_u32(std::uint64_t value)	{return static_cast<std::uint32_t>(std::min<std::uint64_t>(value, UINT32_MAX));}
+
+	// Shared by every parser that has not been given limits of its own.
+	constexpr Parser::Limits			DEFAULT_LIMITS;
+}
+
+Parser::Parser(Callback callback, std::pmr::memory_resource * resource)
+	: m_callback(std::move(callback))
+	, m_resource(resource)
+	, m_element_stack(&m_resource)
+	, m_element_pool(&m_resource)
+	, m_stack_path(&m_resource)
+	, m_limits(&DEFAULT_LIMITS)
+{
+}
+
+Parser::~Parser()
+{
+	release_idle_scratch();
+}
+
+std::error_code
+Parser::write(std::span<const char8_t> data)
+{
+	auto result = write_some(data);
+	if(result.ec)
+		return result.ec;
+	return m_b_paused ? adexml::Error::PAUSED : std::error_code{};
+}
+
+Parser::WriteResult
+Parser::write_some(std::span<const char8_t> data)
+{
+	if(m_b_paused)
+		return {0, adexml::Error::PAUSED};
+
+	const auto 			start = m_position;
+	std::error_code ec;
+
+	ADEXML_STATS(m_stats_mark = std::chrono::steady_clock::now());
+
+	try
+	{
+		acquire_scratch();
+
+		//-------------------------------------------------------------------------
+		//	The document size limit is applied to the chunk as a whole rather than
+		//	per byte. Only the bytes below the limit are parsed.
+		//-------------------------------------------------------------------------
+		const bool b_truncated = (m_limits->max_document_bytes - std::min(m_position, m_limits->max_document_bytes)) < data.size();
+		if(b_truncated)
+			data = data.first(m_limits->max_document_bytes - std::min(m_position, m_limits->max_document_bytes));
+
+		m_scratch->chunk 					= data.data();
+		m_scratch->chunk_offset		= m_position;
+
+		for(auto ch : data)
+		{
+			switch(m_encoding)
+			{
+				case Parser::ENCODING_PLAIN_TEXT : 	ec = parse_char(static_cast<char32_t>(ch)); break;
+				case Parser::ENCODING_UTF8 : 				m_u8_parser.put(ch).and_then([&](char32_t u32)->std::optional<char32_t> {ec = parse_char(u32); return std::nullopt;}); break;
+				case Parser::ENCODING_ISO_8859_1 :	ec = parse_char(charset::ISO_8859_1[ch]); break;
+				case Parser::ENCODING_ISO_8859_15 :	ec = parse_char(charset::ISO_8859_15[ch]); break;
+				case Parser::ENCODING_WINDOWS_1252 :	ec = parse_char(charset::WINDOWS_1252[ch]); break;
+				default :														ec = std::make_error_code(std::errc::protocol_not_supported); break;
+			}
+			if(ec)
+			{
+				//---------------------------------------------------------------------
+				//	A callback paused the parser. The byte that completed the event
+				//	has been fully processed; the rest is kept for resume().
+				//---------------------------------------------------------------------
+				if(ec == adexml::Error::PAUSED)
+				{
+					ec = {};
+					++m_position;
+				}
+				break;
+			}
+			++m_position;
+			ADEXML_STATS(if(m_position >= m_stats_next_sample) stats_sample());
+		}
+
+		count_lines();
+
+		if(m_b_paused)
+			extras().resume = data.subspan(m_position - start);
+
+		if(b_truncated && !ec)
+		{
+			set_state(State::STATE_ERROR);
+			ec = adexml::Error::DOCUMENT_LIMIT_EXCEEDED;
+		}
+
+		if(m_b_compact && is_between_tokens())
+		{
+			shrink_to_fit();
+			release_idle_scratch();
+		}
+	}
+	catch(const std::bad_alloc &)
+	{
+		count_lines();
+		set_state(State::STATE_ERROR);
+		ec = adexml::Error::OUT_OF_MEMORY;
+	}
+
+#if ADEXML_ENABLE_STATS
+	stats_charge();
+	m_stats.bytes += m_position - start;
+#endif
+	return {static_cast<std::size_t>(m_position - start), ec};
+}
+
+Parser::WriteResult
+Parser::resume()
+{
+	if(!m_b_paused)
+		return {};
+
+	m_b_paused = false;
+	return write_some(m_extras ? std::exchange(m_extras->resume, {}) : std::span<const char8_t>{});
+}
+
+std::error_code
+Parser::put(char32_t ch)
+{
+	try
+	{
+		if(m_b_paused)
+			return adexml::Error::PAUSED;
+
+		if(m_position >= m_limits->max_document_bytes)
+		{
+			set_state(State::STATE_ERROR);
+			return adexml::Error::DOCUMENT_LIMIT_EXCEEDED;
+		}
+
+		acquire_scratch();
+		ADEXML_STATS(m_stats_mark = std::chrono::steady_clock::now());
+		auto ec = parse_char(ch);
+		ADEXML_STATS(stats_charge());
+		if(ec == adexml::Error::PAUSED)
+			ec = {};
+		ADEXML_STATS(if(!ec) ++m_stats.bytes);
+		if(!ec && (++m_position, ch == adexml::LINE_FEED))
+		{
+			m_line 		= saturate_u32(m_line + 1ULL);
+			m_column 	= 1;
+		}
+		else if(!ec)
+			m_column 	= saturate_u32(m_column + 1ULL);
+		if(m_b_compact)
+			release_idle_scratch();
+		return ec;
+	}
+	catch(const std::bad_alloc &)
+	{
+		set_state(State::STATE_ERROR);
+		return adexml::Error::OUT_OF_MEMORY;
+	}
+}
+
+//=============================================================================
+//
+//	LOCATION
+//
+//=============================================================================
+
+namespace
+{
+	// Move 'line' and 'column' on over the bytes in [begin,end). Both scans
+	// are plain algorithms over bytes so they vectorise well.
+	void advance_location(const char8_t * begin, const char8_t * end, std::uint64_t & line, std::uint64_t & column)
+	{
+		auto lines = std::count(begin, end, adexml::LINE_FEED);
+		if(lines == 0)
+		{
+			column += end - begin;
+			return;
+		}
+
+		auto last = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(begin), adexml::LINE_FEED);
+		line 		+= lines;
+		column 	= (end - last.base()) + 1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	Bring the stored location up to m_position at the end of a write() and
+//	forget the chunk.
+//-----------------------------------------------------------------------------
+void
+Parser::count_lines()
+{
+	if(!m_scratch || !m_scratch->chunk)
+		return;
+
+	std::uint64_t line 		= m_line;
+	std::uint64_t column 	= m_column;
+	advance_location(m_scratch->chunk, m_scratch->chunk + (m_position - m_scratch->chunk_offset), line, column);
+	m_line 						= saturate_u32(line);
+	m_column 					= saturate_u32(column);
+	m_scratch->chunk 	= nullptr;
+}
+
+Parser::Location
+Parser::location() const
+{
+	std::uint64_t line 		= m_line;
+	std::uint64_t column 	= m_column;
+
+	if(m_scratch && m_scratch->chunk)
+	{
+		advance_location(m_scratch->chunk, m_scratch->chunk + (m_position - m_scratch->chunk_offset), line, column);
+		line 		= saturate_u32(line);
+		column 	= saturate_u32(column);
+	}
+
+	return {m_position, line, column};
+}
+
+Parser::Location
+Parser::locate(std::span<const char8_t> input, std::uint64_t offset)
+{
+	offset 								= std::min<std::uint64_t>(offset, input.size());
+	std::uint64_t line 		= 1;
+	std::uint64_t column 	= 1;
+
+	advance_location(input.data(), input.data() + offset, line, column);
+	return {offset, line, column};
+}
+
+//=============================================================================
+//
+//	CHECKPOINT
+//
+//	Integers are written as LEB128 varints and strings as a length followed by
+//	their UTF-8 bytes, so a checkpoint is about the size of the open elements'
+//	names, attributes and content plus any DOCTYPE.
+//
+//=============================================================================
+
+namespace
+{
+	constexpr std::uint64_t		CHECKPOINT_MAGIC		= 0x50434C4D58454441ULL;		// "ADEXMLCP"
+	constexpr std::uint64_t		CHECKPOINT_VERSION	= 3;
+
+	class CheckpointWriter
+	{
+	private:
+		std::vector<std::byte> &	m_out;
+
+	public:
+		explicit CheckpointWriter(std::vector<std::byte> & out) : m_out(out) {}
+
+		void
+		number(std::uint64_t value)
+		{
+			while(value >= 0x80)
+			{
+				m_out.push_back(static_cast<std::byte>(value | 0x80));
+				value >>= 7;
+			}
+			m_out.push_back(static_cast<std::byte>(value));
+		}
+
+		void
+		text(std::u8string_view value)
+		{
+			number(value.size());
+			auto bytes = std::as_bytes(std::span(value));
+			m_out.insert(m_out.end(), bytes.begin(), bytes.end());
+		}
+	};
+
+	//---------------------------------------------------------------------------
+	//	Reads fail soft: after the first malformed field ok() is false and
+	//	every further read returns zero or an empty string.
+	//---------------------------------------------------------------------------
+	class CheckpointReader
+	{
+	private:
+		std::span<const std::byte>	m_data;
+		bool												m_b_ok = true;
+
+	public:
+		explicit CheckpointReader(std::span<const std::byte> data) : m_data(data) {}
+
+		bool	ok() const		{return m_b_ok;}
+		void	fail()				{m_b_ok = false;}
+		bool	at_end() const	{return m_data.empty();}
+
+		std::uint64_t
+		number()
+		{
+			std::uint64_t value = 0;
+			for(unsigned shift = 0; m_b_ok && (shift < 64); shift += 7)
+			{
+				if(m_data.empty())
+					break;
+				auto byte = std::to_integer<std::uint64_t>(m_data.front());
+				m_data 		= m_data.subspan(1);
+				value 		|= (byte & 0x7F) << shift;
+				if(!(byte & 0x80))
+					return value;
+			}
+			m_b_ok = false;
+			return 0;
+		}
+
+		std::u8string_view
+		text()
+		{
+			auto size = number();
+			if(!m_b_ok || (size > m_data.size()))
+			{
+				m_b_ok = false;
+				return {};
+			}
+			std::u8string_view value(reinterpret_cast<const char8_t *>(m_data.data()), size);
+			m_data = m_data.subspan(size);
+			return value;
+		}
+
+		// A number that must be below 'limit'.
+		std::uint64_t
+		bounded(std::uint64_t limit)
+		{
+			auto value = number();
+			if(value >= limit)
+				m_b_ok = false;
+			return m_b_ok ? value : 0;
+		}
+	};
+}
+
+std::expected<std::vector<std::byte>, std::error_code>
+Parser::checkpoint() const
+{
+	if(m_scratch && m_scratch->chunk)
+		return std::unexpected(make_error_code(adexml::Error::INVALID_STATE));
+
+	std::vector<std::byte>	blob;
+	CheckpointWriter				out(blob);
+
+	out.number(CHECKPOINT_MAGIC);
+	out.number(CHECKPOINT_VERSION);
+
+	out.number(m_position);
+	out.number(m_line);
+	out.number(m_column);
+	out.number(m_encoding);
+	out.number(m_state);
+	out.number(static_cast<std::uint64_t>(m_element_type));
+	out.number(m_attr_delimeter);
+	out.number(m_markup_state);
+	out.number(m_u8_parser.state());
+
+	out.number(m_entity_parser.m_state);
+
+	out.number(m_scratch ? 1 : 0);
+	if(m_scratch)
+	{
+		out.text(m_scratch->tag_name);
+		out.text(m_scratch->tag_namespace);
+		out.text(m_scratch->attr_name);
+		out.text(m_scratch->attr_value);
+		out.text(m_scratch->markup);
+		out.text(m_scratch->entity_name);
+		out.number(m_scratch->tag_offset);
+		out.number(m_scratch->attr_count);
+	}
+
+	out.number(m_element_stack.size());
+	for(auto & element : m_element_stack)
+	{
+		out.text(element.name_space);
+		out.text(element.name);
+		out.text(element.content);
+		out.number(element.offset);
+		out.number(element.fingerprint);
+		out.number(static_cast<std::uint64_t>(element.type));
+		out.number(element.b_closed ? 1 : 0);
+		out.number(element.attributes.size());
+		for(auto & [name, value] : element.attributes)
+		{
+			out.text(name);
+			out.text(value);
+		}
+	}
+	out.text(m_stack_path);		// Excludes an element whose start tag is incomplete
+
+	const Doctype * doctype = m_extras ? m_extras->doctype.get() : nullptr;
+	out.number(doctype ? 1 : 0);
+	if(doctype)
+	{
+		out.text(doctype->name);
+		out.text(doctype->public_id);
+		out.text(doctype->system_id);
+		out.number(doctype->entities.m_expansions_left);
+		out.number(doctype->entities.m_expansion_bytes_left);
+
+		out.number(doctype->entities.m_entities.size());
+		for(auto & [name, entity] : doctype->entities.m_entities)
+		{
+			out.text(name);
+			out.text(entity.text);
+			out.number(static_cast<std::uint64_t>(entity.expansion));
+		}
+
+		out.number(doctype->elements.size());
+		for(auto & decl : doctype->elements)
+		{
+			out.text(decl.name);
+			out.text(decl.content);
+		}
+
+		out.number(doctype->attributes.size());
+		for(auto & decl : doctype->attributes)
+		{
+			out.text(decl.element);
+			out.text(decl.name);
+			out.text(decl.value);
+			out.number(static_cast<std::uint64_t>(decl.type));
+			out.number(static_cast<std::uint64_t>(decl.presence));
+			out.number(decl.values.size());
+			for(auto & value : decl.values)
+				out.text(value);
+		}
+	}
+
+	const Validator * validator = m_extras ? m_extras->validator.get() : nullptr;
+	out.number(validator ? 1 : 0);
+	if(validator)
+	{
+		out.number(validator->m_frames.size());
+		for(auto & frame : validator->m_frames)
+		{
+			out.number(frame.rule);
+			out.number(frame.state);
+		}
+		out.number(validator->m_ids.size());
+		for(auto & id : validator->m_ids)
+			out.text(id);
+	}
+
+	return blob;
+}
+
+std::error_code
+Parser::restore(std::span<const std::byte> checkpoint)
+{
+	CheckpointReader in(checkpoint);
+	if((in.number() != CHECKPOINT_MAGIC) || (in.number() != CHECKPOINT_VERSION))
+		return adexml::Error::INVALID_CHECKPOINT;
+
+	reset();
+
+	try
+	{
+		m_position 			= in.number();
+		m_line					= static_cast<std::uint32_t>(in.bounded(UINT32_MAX + 1ULL));
+		m_column				= static_cast<std::uint32_t>(in.bounded(UINT32_MAX + 1ULL));
+		if((m_line == 0) || (m_column == 0))
+			in.fail();
+		m_encoding			= static_cast<Encoding>(in.bounded(ENCODING_WINDOWS_1252 + 1));
+		m_state					= static_cast<State>(in.bounded(STATE_DOCTYPE + 1));
+		m_element_type	= static_cast<ElementType>(in.bounded(static_cast<std::uint64_t>(ElementType::DTD) + 1));
+		m_attr_delimeter	= static_cast<char8_t>(in.bounded(0x100));
+		m_markup_state	= static_cast<std::uint8_t>(in.bounded(0x100));
+		m_u8_parser.set_state(in.number());
+
+		m_entity_parser.m_state 								= static_cast<EntityParser::State>(in.bounded(EntityParser::STATE_NAME + 1));
+
+		if(in.bounded(2))
+		{
+			acquire_scratch();
+			m_scratch->tag_name.assign(in.text());
+			m_scratch->tag_namespace.assign(in.text());
+			m_scratch->attr_name.assign(in.text());
+			m_scratch->attr_value.assign(in.text());
+			m_scratch->markup.assign(in.text());
+			m_scratch->entity_name.assign(in.text());
+			m_scratch->tag_offset	= in.number();
+			m_scratch->attr_count	= static_cast<std::uint32_t>(in.number());
+		}
+		else if(!m_entity_parser.is_idle())
+			in.fail();
+
+		for(auto count = in.number(); in.ok() && count; --count)
+		{
+			auto & element = push_element();
+			element.name_space.assign(in.text());
+			element.name.assign(in.text());
+			element.content.assign(in.text());
+			element.offset		= in.number();
+			element.fingerprint	= in.number();
+			element.type			= static_cast<ElementType>(in.bounded(static_cast<std::uint64_t>(ElementType::DTD) + 1));
+			element.b_closed 	= in.bounded(2) != 0;
+			for(auto attributes = in.number(); in.ok() && attributes; --attributes)
+			{
+				auto name = in.text();
+				element.attributes.insert_or_assign(String(name, &m_resource), in.text());
+			}
+		}
+		m_stack_path.assign(in.text());
+
+		// Only these states can be entered with no element open.
+		switch(m_state)
+		{
+			case STATE_IDLE : case STATE_ERROR : case STATE_TAG_START : case STATE_END_TAG : case STATE_END_TAG_NAME : case STATE_END_TAG_BODY :
+			case STATE_MARKUP_DECL : case STATE_COMMENT : case STATE_DOCTYPE :
+				break;
+			default :
+				if(m_element_stack.empty())
+					in.fail();
+				break;
+		}
+
+		if(in.bounded(2))
+		{
+			auto & doctype = acquire_doctype();
+			doctype.name.assign(in.text());
+			doctype.public_id.assign(in.text());
+			doctype.system_id.assign(in.text());
+			doctype.entities.m_expansions_left 			= in.number();
+			doctype.entities.m_expansion_bytes_left	= in.number();
+
+			for(auto count = in.number(); in.ok() && count; --count)
+			{
+				auto name 	= in.text();
+				auto & entity = doctype.entities.m_entities[String(name, &m_resource)];
+				entity.text.assign(in.text());
+				entity.expansion = static_cast<EntityTable::Expansion>(in.bounded(static_cast<std::uint64_t>(EntityTable::Expansion::EXPANDED) + 1));
+			}
+
+			for(auto count = in.number(); in.ok() && count; --count)
+			{
+				auto name = in.text();
+				doctype.elements.push_back({String(name, &m_resource), String(in.text(), &m_resource)});
+			}
+
+			for(auto count = in.number(); in.ok() && count; --count)
+			{
+				AttributeDecl decl{String(in.text(), &m_resource), String(in.text(), &m_resource), std::pmr::vector<String>(&m_resource), String(in.text(), &m_resource)};
+				decl.type 		= static_cast<AttributeType>(in.bounded(static_cast<std::uint64_t>(AttributeType::ENUMERATION) + 1));
+				decl.presence	= static_cast<AttributeDefault>(in.bounded(static_cast<std::uint64_t>(AttributeDefault::VALUE) + 1));
+				for(auto values = in.number(); in.ok() && values; --values)
+					decl.values.emplace_back(in.text());
+				doctype.attributes.push_back(std::move(decl));
+			}
+		}
+
+		if(in.bounded(2))
+		{
+			auto * validator = m_extras ? m_extras->validator.get() : nullptr;
+			if(!validator)
+			{
+				reset();
+				return adexml::Error::INVALID_CHECKPOINT;
+			}
+			for(auto count = in.number(); in.ok() && count; --count)
+			{
+				auto rule = static_cast<std::uint32_t>(in.number());
+				validator->m_frames.push_back({rule, static_cast<std::uint32_t>(in.number())});
+				if(!validator->is_valid(validator->m_frames.back()))
+					in.fail();
+			}
+			for(auto count = in.number(); in.ok() && count; --count)
+				validator->m_ids.emplace(in.text());
+		}
+	}
+	catch(const std::bad_alloc &)
+	{
+		reset();
+		return adexml::Error::OUT_OF_MEMORY;
+	}
+
+	if(!in.ok() || !in.at_end())
+	{
+		reset();
+		return adexml::Error::INVALID_CHECKPOINT;
+	}
+	return {};
+}
+
+//=============================================================================
+//
+//	LIMITS
+//
+//=============================================================================
+
+void
+Parser::set_limits(const Limits & limits)
+{
+	if(limits == DEFAULT_LIMITS)
+		m_limits = &DEFAULT_LIMITS;
+	else
+	{
+		auto & extra 	= extras();
+		extra.limits 	= limits;
+		m_limits 			= &extra.limits;
+	}
+	m_entity_parser.set_max_name(m_limits->max_name_bytes);
+	if(m_extras && m_extras->doctype)
+		m_extras->doctype->entities.set_budget(m_limits->max_entity_expansions, m_limits->max_entity_expansion_bytes);
+}
+
+void
+Parser::set_encoding(Encoding encoding, bool b_fixed)
+{
+	if(m_extras || (encoding != ENCODING_UTF8) || b_fixed)
+	{
+		auto & extra 							= extras();
+		extra.document_encoding 	= encoding;
+		extra.b_fixed_encoding 		= b_fixed;
+	}
+	m_encoding = encoding;
+}
+
+void
+Parser::set_attribute_hook(AttributeHook hook)
+{
+	if(m_extras || hook)
+		extras().attribute_hook = std::move(hook);
+}
+
+//-----------------------------------------------------------------------------
+//	Encoding names are matched ignoring case, with the aliases in common use
+//	from the IANA character set registry.
+//-----------------------------------------------------------------------------
+std::optional<Parser::Encoding>
+Parser::encoding_from_name(std::u8string_view name)
+{
+	static constexpr std::pair<std::u8string_view, Encoding>	NAMES[] =
+	{
+		{u8"utf-8",						ENCODING_UTF8},
+		{u8"utf8",						ENCODING_UTF8},
+		{u8"us-ascii",				ENCODING_UTF8},
+		{u8"ascii",						ENCODING_UTF8},
+		{u8"iso-8859-1",			ENCODING_ISO_8859_1},
+		{u8"iso_8859-1",			ENCODING_ISO_8859_1},
+		{u8"iso8859-1",				ENCODING_ISO_8859_1},
+		{u8"latin1",					ENCODING_ISO_8859_1},
+		{u8"l1",							ENCODING_ISO_8859_1},
+		{u8"iso-8859-15",			ENCODING_ISO_8859_15},
+		{u8"iso_8859-15",			ENCODING_ISO_8859_15},
+		{u8"iso8859-15",			ENCODING_ISO_8859_15},
+		{u8"latin-9",					ENCODING_ISO_8859_15},
+		{u8"latin9",					ENCODING_ISO_8859_15},
+		{u8"windows-1252",		ENCODING_WINDOWS_1252},
+		{u8"cp1252",					ENCODING_WINDOWS_1252}
+	};
+
+	auto lower = [](char8_t ch) {return ((ch >= LATIN_CAPITAL_LETTER_A) && (ch <= LATIN_CAPITAL_LETTER_Z)) ? static_cast<char8_t>(ch | 0x20) : ch;};
+	for(auto & [alias, encoding] : NAMES)
+		if(std::ranges::equal(name, alias, {}, lower))
+			return encoding;
+	return std::nullopt;
+}
+
+std::error_code
+Parser::append_name(char32_t ch, String & name)
+{
+	if(name.size() >= m_limits->max_name_bytes)
+	{
+		set_state(State::STATE_ERROR);
+		return adexml::Error::NAME_LIMIT_EXCEEDED;
+	}
+	adexml::unicode::u32_to_u8(ch,name);
+	return {};
+}
+
+//=============================================================================
+//
+//	FOOTPRINT
+//
+//	Scratch buffers are shared through a small per-thread free list. Buffers
+//	that grew large during a burst are shrunk before they are pooled so that
+//	one huge token does not pin memory for every connection afterwards.
+//
+//=============================================================================
+
+namespace
+{
+
+constexpr std::size_t	SCRATCH_POOL_SIZE 		= 16;
+constexpr std::size_t	SCRATCH_KEEP_CAPACITY	= 256;
+constexpr std::size_t	PATH_KEEP_CAPACITY		= 256;
+
+template<typename T>
+void
+shrink_string(T & str, std::size_t keep)
+{
+	if(str.capacity() > keep)
+	{
+		str.clear();
+		str.shrink_to_fit();
+	}
+}
+
+} // namespace
+
+std::vector<Parser::ScratchPtr> &
+Parser::scratch_pool()
+{
+	thread_local std::vector<ScratchPtr> pool;
+	return pool;
+}
+
+void
+Parser::acquire_scratch()
+{
+	if(m_scratch)
+		return;
+
+	if(m_b_compact)
+	{
+		auto & pool = scratch_pool();
+		if(!pool.empty() && (pool.back()->resource() == resource()))
+		{
+			m_scratch = std::move(pool.back());
+			pool.pop_back();
+			ADEXML_STATS(m_scratch->meter.reset());
+			return;
+		}
+	}
+
+	m_scratch = ScratchPtr(std::pmr::polymorphic_allocator<>(resource()).new_object<Scratch>(resource()));
+}
+
+void
+Parser::release_idle_scratch()
+{
+	if(!m_scratch || (!is_between_tokens() && (m_state != State::STATE_ERROR)))
+		return;
+
+	auto & pool = scratch_pool();
+
+#if ADEXML_ENABLE_STATS
+	m_stats.allocations 		+= m_scratch->meter.allocations();
+	m_stats.allocated_bytes	+= m_scratch->meter.bytes();
+#endif
+
+	// Only scratch from the default resource is shared. A caller supplied
+	// resource may be released as soon as this parser is finished with it.
+	if(!m_b_compact || (pool.size() >= SCRATCH_POOL_SIZE) || (resource() != std::pmr::get_default_resource()))
+	{
+		m_scratch.reset();
+		return;
+	}
+
+	m_scratch->clear();
+	m_scratch->shrink(SCRATCH_KEEP_CAPACITY);
+	pool.push_back(std::move(m_scratch));
+}
+
+void
+Parser::set_compact(bool b_compact)
+{
+	m_b_compact = b_compact;
+	if(m_b_compact)
+	{
+		shrink_to_fit();
+		release_idle_scratch();
+	}
+}
+
+void
+Parser::shrink_to_fit()
+{
+	m_element_pool.clear();
+	m_element_pool.shrink_to_fit();
+	m_element_stack.shrink_to_fit();
+	// The path is rebuilt from the first element of the next document.
+	shrink_string(m_stack_path, m_element_stack.empty() ? 0 : PATH_KEEP_CAPACITY);
+	if(m_scratch && is_between_tokens())
+		m_scratch->shrink(SCRATCH_KEEP_CAPACITY);
+}
+
+void
+Parser::Scratch::shrink(std::size_t keep)
+{
+	shrink_string(tag_name, keep);
+	shrink_string(tag_namespace, keep);
+	shrink_string(attr_name, keep);
+	shrink_string(attr_value, keep);
+	shrink_string(markup, keep);
+	shrink_string(entity_name, keep);
+}
+
+Parser::MemoryUsage
+Parser::memory_usage() const
+{
+	MemoryUsage usage;
+	usage.object_bytes 	= sizeof(Parser);
+	usage.scratch_bytes	= m_scratch ? m_scratch->bytes() : 0;
+	usage.heap_bytes		= m_resource.in_use();
+	return usage;
+}
+
+void
+Parser::reset()
+{
+	set_state(State::STATE_IDLE);
+
+	while(!m_element_stack.empty())
+		pop_element();
 
-	for(auto ch : data)
+	m_u8_parser 			= {};
+	m_entity_parser		= {};
+	m_entity_parser.set_max_name(m_limits->max_name_bytes);
+	m_encoding 				= ENCODING_UTF8;
+	if(m_extras)
 	{
-		switch(m_encoding)
+		m_encoding 				= m_extras->document_encoding;
+		m_extras->resume 	= {};
+		if(m_extras->doctype)
 		{
-			case Parser::ENCODING_PLAIN_TEXT : 	ec = put(static_cast<char32_t>(ch)); break;
-			case Parser::ENCODING_UTF8 : 				m_u8_parser.put(ch).and_then([&](char32_t u32)->std::optional<char32_t> {ec = put(u32); return std::nullopt;}); break;
-			default :														ec = std::make_error_code(std::errc::protocol_not_supported); break;
+			m_extras->doctype->clear();
+			m_extras->doctype->entities.set_budget(m_limits->max_entity_expansions, m_limits->max_entity_expansion_bytes);
+			m_entity_parser.set_table(&m_extras->doctype->entities);
 		}
-		if(ec)
-			break;
+		if(m_extras->validator)
+			m_extras->validator->reset();
+	}
+	if(m_scratch)
+	{
+		m_scratch->clear();
+		m_scratch->chunk = nullptr;
 	}
+	m_stack_path.clear();
+	m_position				= 0;
+	m_line						= 1;
+	m_column					= 1;
+	m_attr_delimeter	= 0;
+	m_markup_state		= 0;
+	m_b_paused				= false;
+	m_element_type		= ElementType::ELEMENT;
+	ADEXML_STATS(if(m_stats_hook) m_stats_next_sample = m_stats_interval);
+}
 
-	return ec;
+std::error_code
+Parser::finish() const
+{
+	if(m_state == State::STATE_ERROR)
+		return adexml::Error::FAILED;
+	if((m_state != State::STATE_IDLE) || !m_element_stack.empty())
+		return adexml::Error::INCOMPLETE_DOCUMENT;
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	Elements are recycled through m_element_pool rather than destroyed so that
+//	their strings and attribute maps keep their capacity between elements and
+//	between documents.
+//-----------------------------------------------------------------------------
+
+Element &
+Parser::push_element()
+{
+	ADEXML_STATS(m_stats.max_depth = std::max<std::uint64_t>(m_stats.max_depth, m_element_stack.size() + 1));
+	if(m_element_pool.empty())
+		return m_element_stack.emplace_back();
+
+	m_element_stack.push_back(std::move(m_element_pool.back()));
+	m_element_pool.pop_back();
+	auto & element = m_element_stack.back();
+	element.clear();
+	return element;
+}
+
+void
+Parser::pop_element()
+{
+	assert(!m_element_stack.empty());
+	m_element_pool.push_back(std::move(m_element_stack.back()));
+	m_element_stack.pop_back();
 }
 
 void
@@ -57,6 +944,7 @@ Parser::set_state(State state)
 	switch(state)
 	{
 		case STATE_IDLE : 										[[fallthrough]];
+		case STATE_ERROR : 										[[fallthrough]];
 		case STATE_ATTRIBUTE_VALUE_STRING :		m_entity_parser.reset(); break;
 		default: break;
 	}
@@ -75,9 +963,10 @@ Parser::do_state_idle(char32_t ch)
 	{
 		case adexml::LESS_THAN_SIGN :
 			set_state(State::STATE_TAG_START);
-			m_tag_name.clear();
-			m_tag_namespace.clear();
-			m_attr_name.clear();
+			m_scratch->tag_offset = m_position;
+			m_scratch->tag_name.clear();
+			m_scratch->tag_namespace.clear();
+			m_scratch->attr_name.clear();
 			m_element_type = ElementType::ELEMENT;
 			break;
 
@@ -91,14 +980,32 @@ Parser::do_state_idle(char32_t ch)
 			{
 				auto & element = m_element_stack.back();
 				if(!element.content.empty())
+				{
+					if(element.content.size() >= m_limits->max_content_bytes)
+					{
+						set_state(State::STATE_ERROR);
+						return adexml::Error::CONTENT_LIMIT_EXCEEDED;
+					}
 					adexml::unicode::u32_to_u8(ch,element.content);
+				}
 			}
 			break;
 
 		default :
 			if(!m_element_stack.empty())
-				return m_entity_parser.parse(ch, [&](char32_t decoded_ch)
-					{adexml::unicode::u32_to_u8(decoded_ch,m_element_stack.back().content);});
+			{
+				auto & content = m_element_stack.back().content;
+				if(content.size() >= m_limits->max_content_bytes)
+				{
+					set_state(State::STATE_ERROR);
+					return adexml::Error::CONTENT_LIMIT_EXCEEDED;
+				}
+				if(auto ec = m_entity_parser.parse(ch, content, m_scratch->entity_name, m_limits->max_content_bytes, adexml::Error::CONTENT_LIMIT_EXCEEDED))
+				{
+					set_state(State::STATE_ERROR);
+					return ec;
+				}
+			}
 			break;
 	}
 	return {};
@@ -121,6 +1028,16 @@ Parser::do_state_tag_start(char32_t ch)
 			m_element_type = ElementType::PI;
 			break;
 
+		case adexml::EXCLAMATION_MARK :
+			if(m_element_type != ElementType::ELEMENT)
+			{
+				set_state(State::STATE_ERROR);
+				return adexml::Error::INVALID_MARKUP_DECLARATION;
+			}
+			m_scratch->markup.clear();
+			set_state(State::STATE_MARKUP_DECL);
+			break;
+
 		case adexml::SPACE :	[[fallthrough]];
 		case adexml::CHARACTER_TABULATION :
 			break;
@@ -128,10 +1045,18 @@ Parser::do_state_tag_start(char32_t ch)
 		default :
 			if(is_name_start_char(ch))
 			{
-				adexml::unicode::u32_to_u8(ch,m_tag_name);
+				if(m_element_stack.size() >= m_limits->max_depth)
+				{
+					set_state(State::STATE_ERROR);
+					return adexml::Error::DEPTH_LIMIT_EXCEEDED;
+				}
+
+				adexml::unicode::u32_to_u8(ch,m_scratch->tag_name);
+				m_scratch->attr_count = 0;
 				set_state(State::STATE_START_TAG_NAME);
-				m_element_stack.push_back({});
-				m_element_stack.back().type = m_element_type;
+				auto & element 	= push_element();
+				element.type 		= m_element_type;
+				element.offset	= m_scratch->tag_offset;
 			}
 			else
 			{
@@ -154,12 +1079,21 @@ Parser::do_state_start_tag_name(char32_t ch)
 //	auto & element = m_element_stack.back();
 
 	if(is_name_char(ch))
-		adexml::unicode::u32_to_u8(ch,m_tag_name);
+		return append_name(ch,m_scratch->tag_name);
 	else 
 		switch(ch)
 		{
 			case adexml::GREATER_THAN_SIGN :
-				on_end_start_tag();
+				return on_end_start_tag();
+
+			case adexml::SOLIDUS :
+				if(m_element_type == ElementType::ELEMENT)
+					set_state(State::STATE_START_TAG_CLOSE);
+				else
+				{
+					set_state(State::STATE_ERROR);
+					return adexml::Error::START_TAG_SYNTAX_ERROR;
+				}
 				break;
 
 			case adexml::SPACE :	[[fallthrough]];
@@ -191,8 +1125,7 @@ Parser::do_state_start_tag_body(char32_t ch)
 		//-------------------------------------------------------------------------
 		case adexml::GREATER_THAN_SIGN :
 		//-------------------------------------------------------------------------
-			on_end_start_tag();
-			break;
+			return on_end_start_tag();
 
 		//-------------------------------------------------------------------------
 		case adexml::SOLIDUS :
@@ -209,7 +1142,7 @@ Parser::do_state_start_tag_body(char32_t ch)
 		//-------------------------------------------------------------------------
 		case adexml::EQUALS_SIGN :
 		//-------------------------------------------------------------------------
-			if(m_attr_name.empty())
+			if(m_scratch->attr_name.empty())
 			{
 				set_state(State::STATE_ERROR);
 				return adexml::Error::ATTRIBUTE_SYNTAX_ERROR;
@@ -234,13 +1167,13 @@ Parser::do_state_start_tag_body(char32_t ch)
 		//-------------------------------------------------------------------------
 			if(is_name_start_char(ch))
 			{
-				if(!m_attr_name.empty())
+				if(!m_scratch->attr_name.empty())
 				{
 					set_state(State::STATE_ERROR);
 					return adexml::Error::ATTRIBUTE_SYNTAX_ERROR;
 				}
 
-				adexml::unicode::u32_to_u8(ch,m_attr_name);
+				adexml::unicode::u32_to_u8(ch,m_scratch->attr_name);
 				set_state(State::STATE_ATTRIBUTE_NAME);
 			}
 			break;
@@ -261,7 +1194,7 @@ Parser::do_state_start_tag_close(char32_t ch)
 	if(ch == adexml::GREATER_THAN_SIGN)
 	{
 		element.b_closed = true;
-		on_end_start_tag();
+		return on_end_start_tag();
 	}
 	else
 	{
@@ -280,8 +1213,8 @@ Parser::do_state_end_tag(char32_t ch)
 {
 	if(is_name_start_char(ch))
 	{
-		m_tag_name.clear();
-		adexml::unicode::u32_to_u8(ch,m_tag_name);
+		m_scratch->tag_name.clear();
+		adexml::unicode::u32_to_u8(ch,m_scratch->tag_name);
 		set_state(State::STATE_END_TAG_NAME);
 	}
 	else 
@@ -308,7 +1241,7 @@ Parser::do_state_end_tag_name(char32_t ch)
 {
 
 	if(is_name_char(ch))
-		adexml::unicode::u32_to_u8(ch,m_tag_name);
+		return append_name(ch,m_scratch->tag_name);
 	else 
 		switch(ch)
 		{
@@ -380,7 +1313,7 @@ std::error_code
 Parser::do_state_attribute_name(char32_t ch)
 {
 	if(is_name_char(ch))
-		adexml::unicode::u32_to_u8(ch,m_attr_name);
+		return append_name(ch,m_scratch->attr_name);
 	else
 		switch(ch)
 		{
@@ -415,7 +1348,7 @@ Parser::do_state_attribute_expect_value(char32_t ch)
 		case adexml::QUOTATION_MARK :
 		case adexml::APOSTROPHE :
 			set_state(State::STATE_ATTRIBUTE_VALUE);
-			m_attr_delimeter = ch;
+			m_attr_delimeter = static_cast<char8_t>(ch);
 			break;
 
 		default :
@@ -434,18 +1367,40 @@ Parser::do_state_attribute_value(char32_t ch)
 {
 	if(ch==m_attr_delimeter)
 	{
-		//TODO(Ade): Add Attribute
 		assert(!m_element_stack.empty());
 		auto & element = m_element_stack.back();
-		if(element.attributes.count(m_attr_name) > 0)
+		if(element.attributes.count(m_scratch->attr_name) > 0)
 		{
 			set_state(State::STATE_ERROR);
 			return adexml::Error::ATTRIBUTE_DUPLICATE_NAME;
 		}
-		
-		element.attributes[m_attr_name] = m_attr_value;
-		m_attr_name.clear();
-		m_attr_value.clear();
+
+		if(++m_scratch->attr_count > m_limits->max_attributes)
+		{
+			set_state(State::STATE_ERROR);
+			return adexml::Error::ATTRIBUTE_LIMIT_EXCEEDED;
+		}
+
+		ADEXML_STATS(m_stats.max_attribute_value_bytes = std::max<std::uint64_t>(m_stats.max_attribute_value_bytes, m_scratch->attr_value.size()));
+
+		bool b_consumed = false;
+		if(m_extras && m_extras->attribute_hook)
+		{
+			ADEXML_STATS(auto group = stats_switch(Stats::GROUP_CALLBACK));
+			auto result = m_extras->attribute_hook(m_scratch->tag_name, m_element_stack.size(), m_scratch->attr_name, m_scratch->attr_value);
+			ADEXML_STATS(stats_switch(group));
+			if(!result)
+			{
+				set_state(State::STATE_ERROR);
+				return result.error();
+			}
+			b_consumed = *result;
+		}
+
+		if(!b_consumed)
+			element.attributes[m_scratch->attr_name] = m_scratch->attr_value;
+		m_scratch->attr_name.clear();
+		m_scratch->attr_value.clear();
 		set_state(State::STATE_START_TAG_BODY);
 	}
 	// else if((ch == adexml::LESS_THAN_SIGN) || (ch == adexml::AMPERSAND))
@@ -455,14 +1410,164 @@ Parser::do_state_attribute_value(char32_t ch)
 	// }
 	else
 	{
-		return m_entity_parser.parse(ch, [&](char32_t decoded_ch)
-			{adexml::unicode::u32_to_u8(decoded_ch,m_attr_value);});
+		if(m_scratch->attr_value.size() >= m_limits->max_attribute_value_bytes)
+		{
+			set_state(State::STATE_ERROR);
+			return adexml::Error::ATTRIBUTE_VALUE_LIMIT_EXCEEDED;
+		}
+		if(auto ec = m_entity_parser.parse(ch, m_scratch->attr_value, m_scratch->entity_name, m_limits->max_attribute_value_bytes, adexml::Error::ATTRIBUTE_VALUE_LIMIT_EXCEEDED))
+		{
+			set_state(State::STATE_ERROR);
+			return ec;
+		}
 	}
 	return {};
 }
 
+//-----------------------------------------------------------------------------
+//	STATE: MARKUP_DECL
+//	Collects the keyword following "<!" until it identifies a comment, a CDATA
+//	section or a document type declaration.
+//-----------------------------------------------------------------------------
 std::error_code
-Parser::put(char32_t ch)
+Parser::do_state_markup_decl(char32_t ch)
+{
+	auto & keyword = m_scratch->markup;
+	if(ch < 0x80)
+		keyword.push_back(static_cast<char8_t>(ch));
+
+	if(keyword == KEYWORD_COMMENT)
+	{
+		m_markup_state = 0;
+		set_state(State::STATE_COMMENT);
+	}
+	else if((keyword == KEYWORD_CDATA) && !m_element_stack.empty())
+	{
+		m_markup_state = 0;
+		set_state(State::STATE_CDATA);
+	}
+	else if((keyword == KEYWORD_DOCTYPE) && m_element_stack.empty() && !doctype())
+	{
+		keyword.clear();
+		m_markup_state 		= 0;
+		m_attr_delimeter 	= 0;
+		set_state(State::STATE_DOCTYPE);
+	}
+	else if((ch >= 0x80) || !(KEYWORD_COMMENT.starts_with(keyword) || KEYWORD_CDATA.starts_with(keyword) || KEYWORD_DOCTYPE.starts_with(keyword)))
+	{
+		set_state(State::STATE_ERROR);
+		return adexml::Error::INVALID_MARKUP_DECLARATION;
+	}
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	STATE: COMMENT
+//	m_markup_state counts the run of '-' preceding the current character.
+//-----------------------------------------------------------------------------
+std::error_code
+Parser::do_state_comment(char32_t ch)
+{
+	if(ch == adexml::HYPHEN_MINUS)
+		m_markup_state = std::min<std::uint8_t>(m_markup_state + 1, 2);
+	else if((ch == adexml::GREATER_THAN_SIGN) && (m_markup_state == 2))
+		set_state(State::STATE_IDLE);
+	else
+		m_markup_state = 0;
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	STATE: CDATA
+//	Characters are appended to the content verbatim. m_markup_state counts the
+//	run of ']' so that the "]]" of the terminating "]]>" can be removed again.
+//-----------------------------------------------------------------------------
+std::error_code
+Parser::do_state_cdata(char32_t ch)
+{
+	assert(!m_element_stack.empty());
+	auto & content = m_element_stack.back().content;
+
+	if((ch == adexml::GREATER_THAN_SIGN) && (m_markup_state == 2))
+	{
+		content.resize(content.size() - 2);
+		set_state(State::STATE_IDLE);
+		return {};
+	}
+
+	if(content.size() >= m_limits->max_content_bytes)
+	{
+		set_state(State::STATE_ERROR);
+		return adexml::Error::CONTENT_LIMIT_EXCEEDED;
+	}
+
+	m_markup_state = (ch == adexml::SQUARE_BRACKET_RIGHT) ? std::min<std::uint8_t>(m_markup_state + 1, 2) : 0;
+	adexml::unicode::u32_to_u8(ch,content);
+	return {};
+}
+
+//-----------------------------------------------------------------------------
+//	STATE: DOCTYPE
+//	The declaration is buffered up to its closing '>', which is the first '>'
+//	outside the internal subset, literals, comments and processing
+//	instructions, then parsed in one go.
+//-----------------------------------------------------------------------------
+std::error_code
+Parser::do_state_doctype(char32_t ch)
+{
+	auto & text = m_scratch->markup;
+	if(text.size() >= m_limits->max_dtd_bytes)
+	{
+		set_state(State::STATE_ERROR);
+		return adexml::Error::DTD_LIMIT_EXCEEDED;
+	}
+
+	if(m_markup_state & DOCTYPE_IN_COMMENT)
+	{
+		adexml::unicode::u32_to_u8(ch,text);
+		if(std::u8string_view(text).ends_with(u8"-->"))
+			m_markup_state &= ~DOCTYPE_IN_COMMENT;
+		return {};
+	}
+
+	if(m_markup_state & DOCTYPE_IN_PI)
+	{
+		adexml::unicode::u32_to_u8(ch,text);
+		if(std::u8string_view(text).ends_with(u8"?>"))
+			m_markup_state &= ~DOCTYPE_IN_PI;
+		return {};
+	}
+
+	if(m_attr_delimeter)
+	{
+		if(ch == m_attr_delimeter)
+			m_attr_delimeter = 0;
+		adexml::unicode::u32_to_u8(ch,text);
+		return {};
+	}
+
+	switch(ch)
+	{
+		case adexml::QUOTATION_MARK :				[[fallthrough]];
+		case adexml::APOSTROPHE :						m_attr_delimeter = static_cast<char8_t>(ch); break;
+		case adexml::SQUARE_BRACKET_LEFT :	m_markup_state |= DOCTYPE_IN_SUBSET; break;
+		case adexml::SQUARE_BRACKET_RIGHT :	m_markup_state &= ~DOCTYPE_IN_SUBSET; break;
+		case adexml::GREATER_THAN_SIGN :
+			if(!(m_markup_state & DOCTYPE_IN_SUBSET))
+				return on_doctype();
+			break;
+	}
+
+	adexml::unicode::u32_to_u8(ch,text);
+	if((ch == adexml::HYPHEN_MINUS) && std::u8string_view(text).ends_with(u8"<!--"))
+		m_markup_state |= DOCTYPE_IN_COMMENT;
+	else if((ch == adexml::QUESTION_MARK) && std::u8string_view(text).ends_with(u8"<?"))
+		m_markup_state |= DOCTYPE_IN_PI;
+	return {};
+}
+
+std::error_code
+Parser::parse_char(char32_t ch)
 {
 //	std::cout << std::format("U32: 0x{:08X}\n", (uint32_t)ch);
 	/*
@@ -495,6 +1600,14 @@ Parser::put(char32_t ch)
 			break;
 	}
 */
+#if ADEXML_ENABLE_STATS
+	++m_stats.code_points;
+	stats_switch(	!m_entity_parser.is_idle() 				? Stats::GROUP_ENTITY :
+								(m_state >= STATE_MARKUP_DECL) 		? Stats::GROUP_DECLARATION :
+								(m_state >= STATE_ATTRIBUTE_NAME) ? Stats::GROUP_ATTRIBUTE :
+								(m_state >= STATE_TAG_START) 			? Stats::GROUP_TAG : Stats::GROUP_CONTENT );
+#endif
+
 	switch(m_state)
 	{
 		case State::STATE_ERROR:										return adexml::Error::FAILED;
@@ -510,6 +1623,10 @@ Parser::put(char32_t ch)
 		case State::STATE_ATTRIBUTE_NAME:						return do_state_attribute_name(ch);
 		case State::STATE_ATTRIBUTE_EXPECT_VALUE:		return do_state_attribute_expect_value(ch);
 		case State::STATE_ATTRIBUTE_VALUE:					return do_state_attribute_value(ch);
+		case State::STATE_MARKUP_DECL:							return do_state_markup_decl(ch);
+		case State::STATE_COMMENT:									return do_state_comment(ch);
+		case State::STATE_CDATA:										return do_state_cdata(ch);
+		case State::STATE_DOCTYPE:									return do_state_doctype(ch);
 		default:														set_state(State::STATE_ERROR); return adexml::Error::INVALID_STATE;
 	}
 
@@ -519,6 +1636,7 @@ Parser::put(char32_t ch)
 void
 Parser::build_path_string()
 {
+	ADEXML_STATS(auto group = stats_switch(Stats::GROUP_PATH));
 	m_stack_path.clear();
 	for(auto & el : m_element_stack)
 	{
@@ -526,27 +1644,81 @@ Parser::build_path_string()
 			m_stack_path.push_back('/');
 		m_stack_path.append(el.name);
 	}
+	ADEXML_STATS(stats_switch(group));
 };
 
+//-----------------------------------------------------------------------------
+//	Deliver an event to the callback.
+//-----------------------------------------------------------------------------
+std::error_code
+Parser::notify(Action action)
+{
+	ADEXML_STATS(++m_stats.events[action]);
+	if(!m_callback)
+		return {};
+
+#if ADEXML_ENABLE_STATS
+	auto group 	= stats_switch(Stats::GROUP_CALLBACK);
+	auto ec 		= m_callback(action, m_stack_path, m_element_stack);
+	stats_switch(group);
+	return ec;
+#else
+	return m_callback(action, m_stack_path, m_element_stack);
+#endif
+}
+
 
+//-----------------------------------------------------------------------------
+//	Complete the fingerprint of the innermost element, whose children combine
+//	to 'children', and fold it into its parent's.
+//-----------------------------------------------------------------------------
 void
+Parser::add_fingerprint(std::uint64_t children)
+{
+	auto & element 			= m_element_stack.back();
+	element.fingerprint = fingerprint_element(element, children);
+
+	if(m_element_stack.size() > 1)
+	{
+		auto & parent 			= m_element_stack[m_element_stack.size() - 2];
+		parent.fingerprint 	= combine_fingerprints(parent.fingerprint, element.fingerprint);
+	}
+}
+
+std::error_code
 Parser::on_end_start_tag()
 {
 	set_state(State::STATE_IDLE);
 	assert(!m_element_stack.empty());
 	auto & element 			= m_element_stack.back();
-	element.name_space	= m_tag_namespace;
-	element.name 				= m_tag_name;
+	element.name_space	= m_scratch->tag_namespace;
+	element.name 				= m_scratch->tag_name;
 	if(!m_stack_path.empty())
 		m_stack_path.push_back('/');
-	m_stack_path.append(m_tag_name);
+	m_stack_path.append(m_scratch->tag_name);
+	ADEXML_STATS(m_stats.max_path_bytes = std::max<std::uint64_t>(m_stats.max_path_bytes, m_stack_path.size()));
+
+	if(m_extras && m_extras->validator)
+	{
+		auto ec = m_extras->validator->start_element(element);
+		if(!ec && element.b_closed)
+			ec = m_extras->validator->end_element(element);
+		if(ec)
+		{
+			set_state(State::STATE_ERROR);
+			return ec;
+		}
+	}
+
+	if(m_b_fingerprints && element.b_closed)
+		add_fingerprint(0);
 
 /*
 	std::cout << "START_TAG: ";
-	for(auto ch : m_tag_namespace) std::cout.put(ch);
-	if(!m_tag_namespace.empty())
+	for(auto ch : m_scratch->tag_namespace) std::cout.put(ch);
+	if(!m_scratch->tag_namespace.empty())
 		std::cout.put(':');
-	for(auto ch : m_tag_name)	std::cout.put(ch);
+	for(auto ch : m_scratch->tag_name)	std::cout.put(ch);
 
 	if(element.b_closed)
 		std::cout << " <end>";
@@ -566,39 +1738,42 @@ Parser::on_end_start_tag()
 	}
 */
 
-	if(m_callback)
-		m_callback(ACTION_START_ELEMENT, m_stack_path, m_element_stack);
+	if(auto ec = notify(ACTION_START_ELEMENT))
+		return ec;
 
 	if(element.b_closed)
 	{
-		m_element_stack.pop_back();
+		pop_element();
 		build_path_string();
 	}
 
+	return m_b_paused ? adexml::Error::PAUSED : std::error_code{};
 }
 
 std::error_code
 Parser::on_end_end_tag()
 {
 	set_state(State::STATE_IDLE);
-	assert(!m_element_stack.empty());
-	auto & element 			= m_element_stack.back();
 
 	//---------------------------------------------------------------------------
-	// Check whether the start and end tag names match
+	// Check whether the start and end tag names match. An end tag with no
+	// open element (after the root has closed) matches nothing.
 	//---------------------------------------------------------------------------
-	if(element.name != m_tag_name)
+	if(m_element_stack.empty() || m_element_stack.back().name != m_scratch->tag_name)
 	{
-		std::cout << "element.name: '";
-		for(auto ch : element.name) std::cout.put(ch);
-		std::cout << "' m_tag_name: '";
-		for(auto ch : m_tag_name) std::cout.put(ch);
-		std::cout << "'\n";
-
 		set_state(State::STATE_ERROR);
 		return adexml::Error::ELEMENT_TAG_MISMATCH;
 	}
 
+	auto & element = m_element_stack.back();
+
+	if(m_extras && m_extras->validator)
+		if(auto ec = m_extras->validator->end_element(element))
+		{
+			set_state(State::STATE_ERROR);
+			return ec;
+		}
+
 	//---------------------------------------------------------------------------
 	//	Report the end tag by calling the user provided callback.
 	//---------------------------------------------------------------------------
@@ -607,27 +1782,30 @@ Parser::on_end_end_tag()
 //	for(auto ch : element.content) std::cout.put(ch);
 //	std::cout << "'\n";
 
-	if(m_callback)
-		if(auto ec = m_callback(ACTION_END_ELEMENT, m_stack_path, m_element_stack))
-			return ec;
+	ADEXML_STATS(m_stats.max_content_bytes = std::max<std::uint64_t>(m_stats.max_content_bytes, element.content.size()));
+	if(m_b_fingerprints)
+		add_fingerprint(element.fingerprint);
+
+	if(auto ec = notify(ACTION_END_ELEMENT))
+		return ec;
 
 	//---------------------------------------------------------------------------
 	//	Remove the element from the element stack.
 	//---------------------------------------------------------------------------
-	m_element_stack.pop_back();
+	pop_element();
 	build_path_string();
 
 /*
 	std::cout << "END_TAG:   ";
-	for(auto ch : m_tag_namespace)
+	for(auto ch : m_scratch->tag_namespace)
 		std::cout.put(ch);
-	if(!m_tag_namespace.empty())
+	if(!m_scratch->tag_namespace.empty())
 		std::cout.put(':');
-	for(auto ch : m_tag_name)
+	for(auto ch : m_scratch->tag_name)
 		std::cout.put(ch);
 	std::cout.put('\n');
 */
-	return {};
+	return m_b_paused ? adexml::Error::PAUSED : std::error_code{};
 }
 
 std::error_code
@@ -636,8 +1814,21 @@ Parser::on_pi_tag()
 	set_state(State::STATE_IDLE);
 	assert(!m_element_stack.empty());
 	auto & element 			= m_element_stack.back();
-	element.name_space	= m_tag_namespace;
-	element.name 				= m_tag_name;
+	element.name_space	= m_scratch->tag_namespace;
+	element.name 				= m_scratch->tag_name;
+	ADEXML_STATS(++m_stats.events[ACTION_PI]);
+
+	//---------------------------------------------------------------------------
+	//	The XML declaration. It is ASCII, so the bytes after it are the first
+	//	to be read in the declared encoding.
+	//---------------------------------------------------------------------------
+	if((element.name == u8"xml") && (m_element_stack.size() == 1) && !(m_extras && m_extras->b_fixed_encoding))
+	{
+		auto declared = element.attributes.find(std::u8string_view(u8"encoding"));
+		if(declared != element.attributes.end())
+			if(auto encoding = encoding_from_name(declared->second))
+				m_encoding = *encoding;
+	}
 
 /*	
 	std::cout << "PI: ";
@@ -656,12 +1847,164 @@ Parser::on_pi_tag()
 	//---------------------------------------------------------------------------
 	//	Remove the element from the element stack.
 	//---------------------------------------------------------------------------
-	m_element_stack.pop_back();
+	pop_element();
 	build_path_string();
 
 	return {};
 }
 
+std::error_code
+Parser::on_doctype()
+{
+	set_state(State::STATE_IDLE);
+	ADEXML_STATS(m_stats.max_markup_bytes = std::max<std::uint64_t>(m_stats.max_markup_bytes, m_scratch->markup.size()));
+	if(auto ec = parse_doctype(m_scratch->markup, acquire_doctype()))
+	{
+		set_state(State::STATE_ERROR);
+		return ec;
+	}
+	return {};
+}
+
+//=============================================================================
+//
+//	STATISTICS
+//
+//=============================================================================
+
+#if ADEXML_ENABLE_STATS
+
+//-----------------------------------------------------------------------------
+//	stats_charge() adds the time since the last mark to the current group.
+//	stats_switch() does the same when the group changes and returns the
+//	previous group so that it can be restored.
+//-----------------------------------------------------------------------------
+void
+Parser::stats_charge()
+{
+	auto now = std::chrono::steady_clock::now();
+	m_stats.group_ns[m_stats_group] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_stats_mark).count();
+	m_stats_mark = now;
+}
+
+Parser::Stats::Group
+Parser::stats_switch(Stats::Group group)
+{
+	auto previous = m_stats_group;
+	if(group != previous)
+	{
+		stats_charge();
+		m_stats_group = group;
+	}
+	return previous;
+}
+
+void
+Parser::stats_sample()
+{
+	m_stats_next_sample = m_position + m_stats_interval;
+	if(!m_stats_hook)
+		return;
+
+	stats_charge();
+	auto snapshot = stats();
+	snapshot.bytes += m_position - m_scratch->chunk_offset;		// Not yet added by write_some()
+
+	m_stats_hook(snapshot);
+	m_stats_mark = std::chrono::steady_clock::now();
+}
+
+#endif
+
+Parser::Stats
+Parser::stats() const
+{
+#if ADEXML_ENABLE_STATS
+	auto snapshot 						= m_stats;
+	snapshot.allocations			+= m_resource.allocations() + (m_scratch ? m_scratch->meter.allocations() : 0);
+	snapshot.allocated_bytes	+= m_resource.bytes() + (m_scratch ? m_scratch->meter.bytes() : 0);
+	if(m_scratch && m_scratch->chunk)
+		snapshot.group_ns[m_stats_group] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_stats_mark).count();
+	return snapshot;
+#else
+	return {};
+#endif
+}
+
+void
+Parser::reset_stats()
+{
+#if ADEXML_ENABLE_STATS
+	m_stats = {};
+	m_resource.reset();
+	if(m_scratch)
+		m_scratch->meter.reset();
+#endif
+}
+
+void
+Parser::set_stats_hook([[maybe_unused]] StatsHook hook, [[maybe_unused]] std::uint64_t interval_bytes)
+{
+#if ADEXML_ENABLE_STATS
+	m_stats_hook 				= std::move(hook);
+	m_stats_interval 		= std::max<std::uint64_t>(interval_bytes, 1);
+	m_stats_next_sample	= m_stats_hook ? m_position + m_stats_interval : UINT64_MAX;
+#endif
+}
+
+//=============================================================================
+//
+//	DOCTYPE
+//
+//=============================================================================
+
+Doctype &
+Parser::acquire_doctype()
+{
+	auto & doctype = extras().doctype;
+	if(!doctype)
+	{
+		doctype = DoctypePtr(std::pmr::polymorphic_allocator<>(&m_resource).new_object<Doctype>(&m_resource));
+		doctype->entities.set_budget(m_limits->max_entity_expansions, m_limits->max_entity_expansion_bytes);
+		m_entity_parser.set_table(&doctype->entities);
+	}
+	return *doctype;
+}
+
+EntityTable &
+Parser::entities()
+{
+	return acquire_doctype().entities;
+}
+
+void
+Parser::set_schema(std::shared_ptr<const Schema> schema)
+{
+	if(!schema)
+	{
+		if(m_extras)
+			m_extras->validator.reset();
+		return;
+	}
+
+	auto & validator = extras().validator;
+	if(validator)
+		validator->set_schema(std::move(schema));
+	else
+		validator = ValidatorPtr(std::pmr::polymorphic_allocator<>(&m_resource).new_object<Validator>(std::move(schema), &m_resource));
+}
+
+Parser::Extras::Extras(std::pmr::memory_resource * resource) : memory(resource) {}
+Parser::Extras::~Extras() = default;
+
+Parser::Extras &
+Parser::extras()
+{
+	if(!m_extras)
+		m_extras = ExtrasPtr(std::pmr::polymorphic_allocator<>(&m_resource).new_object<Extras>(&m_resource));
+	return *m_extras;
+}
+
 
 
 } // namespace adexml
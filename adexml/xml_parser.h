@@ -15,17 +15,38 @@
 #ifndef GUARD_ADE_XML_PARSER_H
 #define GUARD_ADE_XML_PARSER_H
 
+//-----------------------------------------------------------------------------
+//	Set by the ADEXML_ENABLE_STATS CMake option. It changes the layout of
+//	Parser, so it must have the same value for the library and its users.
+//-----------------------------------------------------------------------------
+#ifndef ADEXML_ENABLE_STATS
+#define ADEXML_ENABLE_STATS 0
+#endif
+
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <map>
 #include <unordered_map>
 #include <string>
 #include <functional>
+#include <memory>
+#include <memory_resource>
 #include <expected>
 #include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
 #include <system_error>
+#include "charset.h"
+#include "strings.h"
 #include "unicode.h"
 #include "entity.h"
+#include "dtd.h"
+#include "convert.h"
+#include "memory.h"
 
 namespace adexml
 {
@@ -36,35 +57,141 @@ namespace adexml
 //
 //=============================================================================
 
-enum class ElementType
+enum class ElementType : std::uint8_t
 {
 	ELEMENT,
 	PI,
 	DTD
 };
 
+using AttributeMap	= std::pmr::unordered_map<String, String, StringHash, StringEqual>;
+
+//-----------------------------------------------------------------------------
+//	Output binding for Element::extract(), e.g. element.extract(attr(u8"x", x)).
+//	Attributes bound to a std::optional are not required to be present.
+//-----------------------------------------------------------------------------
+template<typename T>
+struct AttributeRef
+{
+	std::u8string_view	name;
+	T &									value;
+};
+
+template<typename T>	AttributeRef<T>	attr(std::u8string_view name, T & value)	{return {name, value};}
+
+struct Element;
+using ElementStack = std::pmr::vector<Element>;
+
 struct Element
 {
-	std::u8string																			name_space;
-	std::u8string																			name;
-	std::unordered_map<std::u8string, std::u8string>	attributes;
-	std::u8string																			content;
+	using allocator_type = std::pmr::polymorphic_allocator<>;
+
+	String																						name_space;
+	String																						name;
+	AttributeMap																			attributes;
+	String																						content;
+	std::uint64_t																			offset			= 0;		// Byte offset of the start tag's '<'
+	std::uint64_t																			fingerprint	= 0;		// See Parser::set_fingerprints()
 	ElementType																				type				= ElementType::ELEMENT;
 	bool																							b_closed 		= false;
 
+	Element() = default;
+	explicit Element(const allocator_type & alloc)
+		: name_space(alloc), name(alloc), attributes(alloc), content(alloc) {}
+	Element(const Element & other, const allocator_type & alloc = {})
+		: name_space(other.name_space, alloc), name(other.name, alloc), attributes(other.attributes, alloc), content(other.content, alloc)
+		, offset(other.offset), fingerprint(other.fingerprint), type(other.type), b_closed(other.b_closed) {}
+	Element(Element && other) noexcept = default;
+	Element(Element && other, const allocator_type & alloc)
+		: name_space(std::move(other.name_space), alloc), name(std::move(other.name), alloc), attributes(std::move(other.attributes), alloc)
+		, content(std::move(other.content), alloc), offset(other.offset), fingerprint(other.fingerprint), type(other.type), b_closed(other.b_closed) {}
+	Element & operator=(const Element &) = default;
+	Element & operator=(Element &&) = default;
+
+	allocator_type												get_allocator() const	{return name.get_allocator();}
+
+	void																	clear()
+																				{
+																					name_space.clear();
+																					name.clear();
+																					attributes.clear();
+																					content.clear();
+																					offset		= 0;
+																					fingerprint	= 0;
+																					type 			= ElementType::ELEMENT;
+																					b_closed 	= false;
+																				}
+
 	bool																	has_attribute(const std::u8string_view attr_mame) const	
 																				{
-																					auto ifind=attributes.find(std::u8string(attr_mame)); 
-																					return ifind != attributes.end();
+																					return attributes.find(attr_mame) != attributes.end();
 																				}
 																				
 	const std::optional<std::u8string> 		attribute(const std::u8string_view attr_mame) const			
 																				{
-																					auto ifind=attributes.find(std::u8string(attr_mame)); 
+																					auto ifind=attributes.find(attr_mame); 
 																					if(ifind != attributes.end()) 
-																						return ifind->second; 
+																						return std::u8string(ifind->second); 
 																					return {};
 																				} 
+
+	std::optional<std::u8string_view>			attribute_view(const std::u8string_view attr_name) const
+																				{
+																					auto ifind=attributes.find(attr_name);
+																					if(ifind != attributes.end())
+																						return ifind->second;
+																					return {};
+																				}
+
+	//---------------------------------------------------------------------------
+	//	Typed access. Integers, floating point, bool ("true"/"false"/"1"/"0")
+	//	and enumerations (by underlying value, or by name through a table) are
+	//	converted without allocating. A missing attribute is reported as
+	//	ATTRIBUTE_NOT_FOUND.
+	//---------------------------------------------------------------------------
+	template<typename T>
+	std::expected<T, std::error_code>			attribute_as(const std::u8string_view attr_name) const
+																				{
+																					auto value = attribute_view(attr_name);
+																					if(!value)
+																						return std::unexpected(make_error_code(adexml::Error::ATTRIBUTE_NOT_FOUND));
+																					T result{};
+																					if(auto ec = parse_value(*value, result))
+																						return std::unexpected(ec);
+																					return result;
+																				}
+
+	template<typename E>
+	std::expected<E, std::error_code>			attribute_as(const std::u8string_view attr_name, std::span<const std::pair<std::u8string_view, E>> names) const
+																				{
+																					auto value = attribute_view(attr_name);
+																					if(!value)
+																						return std::unexpected(make_error_code(adexml::Error::ATTRIBUTE_NOT_FOUND));
+																					E result{};
+																					if(auto ec = parse_enum(*value, names, result))
+																						return std::unexpected(ec);
+																					return result;
+																				}
+
+	//---------------------------------------------------------------------------
+	//	Resolve several attributes with a single pass over the attribute map.
+	//---------------------------------------------------------------------------
+	template<typename... T>
+	std::error_code												extract(AttributeRef<T>... refs) const
+																				{
+																					std::error_code ec;
+																					bool						found[sizeof...(T) + 1] = {};
+																					for(auto & [name, value] : attributes)
+																					{
+																						std::size_t index = 0;
+																						(void)((name == refs.name ? (found[index] = true, ec = parse_value(value, refs.value), true) : (++index, false)) || ...);
+																						if(ec)
+																							return ec;
+																					}
+																					std::size_t index = 0;
+																					(void)(((!found[index++] && !is_optional<T>::value) ? (ec = adexml::Error::ATTRIBUTE_NOT_FOUND, true) : false) || ...);
+																					return ec;
+																				}
 };
 
 //=============================================================================
@@ -73,6 +200,9 @@ struct Element
 //
 //=============================================================================
 
+class Schema;
+class Validator;
+
 class Parser
 {
 public:
@@ -83,22 +213,143 @@ public:
 		ACTION_PI
 	};
 
-	enum Encoding 
+	enum Encoding : std::uint8_t
 	{
 		ENCODING_PLAIN_TEXT,
 		ENCODING_UTF8,
 		ENCODING_UTF16_LITTLE_ENDIAN,
 		ENCODING_UTF16_BIG_ENDIAN,
 		ENCODING_UTF32_LITTLE_ENDIAN,
-		ENCODING_UTF32_BIG_ENDIAN
+		ENCODING_UTF32_BIG_ENDIAN,
+		ENCODING_ISO_8859_1,
+		ENCODING_ISO_8859_15,
+		ENCODING_WINDOWS_1252
 	};
 
 	using Callback = std::function<std::error_code (	adexml::Parser::Action 								action,
-																										const std::u8string &									path,
-																										const std::vector<adexml::Element> & 	element_stack )>;
+																										const adexml::String &								path,
+																										const adexml::ElementStack & 					element_stack )>;
+
+	//---------------------------------------------------------------------------
+	//	Called for each completed attribute before it is stored in the element.
+	//	'depth' is the depth of the element being started (the size of the
+	//	element stack once it has been pushed). Returning true consumes the
+	//	attribute so that it is not copied into Element::attributes.
+	//---------------------------------------------------------------------------
+	using AttributeHook = std::function<std::expected<bool, std::error_code> (	std::u8string_view	element_name,
+																																							std::size_t					depth,
+																																							std::u8string_view	name,
+																																							std::u8string_view	value )>;
+
+	//---------------------------------------------------------------------------
+	//	Bounds on everything an untrusted document can make the parser hold.
+	//	Each limit fails the parse with its own error code as soon as it is
+	//	crossed. The defaults are unlimited except for entity expansion, which
+	//	is bounded so that a few hundred bytes of DOCTYPE cannot expand to
+	//	gigabytes (billion laughs). untrusted() gives conservative values for
+	//	input from outside the process and unlimited() lifts every limit,
+	//	entity expansion included. Limits are only tested where a buffer, the
+	//	element stack or the input position grows. The entity limits count
+	//	references to declared entities, for each document; the predefined
+	//	entities and character references are ordinary text.
+	//---------------------------------------------------------------------------
+	struct Limits
+	{
+		std::uint64_t		max_document_bytes				= UINT64_MAX;		// DOCUMENT_LIMIT_EXCEEDED
+		std::uint64_t		max_content_bytes					= UINT64_MAX;		// CONTENT_LIMIT_EXCEEDED
+		std::uint64_t		max_attribute_value_bytes	= UINT64_MAX;		// ATTRIBUTE_VALUE_LIMIT_EXCEEDED
+		std::uint64_t		max_entity_expansions			= 1U << 20;			// ENTITY_LIMIT_EXCEEDED
+		std::uint64_t		max_entity_expansion_bytes	= 8U << 20;		// ENTITY_LIMIT_EXCEEDED
+		std::uint64_t		max_dtd_bytes							= UINT64_MAX;		// DTD_LIMIT_EXCEEDED
+		std::uint32_t		max_depth									= UINT32_MAX;		// DEPTH_LIMIT_EXCEEDED
+		std::uint32_t		max_attributes						= UINT32_MAX;		// ATTRIBUTE_LIMIT_EXCEEDED
+		std::uint32_t		max_name_bytes						= UINT32_MAX;		// NAME_LIMIT_EXCEEDED
+
+		static constexpr Limits	untrusted()
+		{
+			Limits limits;
+			limits.max_document_bytes 				= 1ULL << 30;
+			limits.max_content_bytes 					= 16U << 20;
+			limits.max_attribute_value_bytes 	= 1U << 20;
+			limits.max_entity_expansions 			= 1U << 20;
+			limits.max_entity_expansion_bytes	= 8U << 20;
+			limits.max_dtd_bytes 							= 1U << 20;
+			limits.max_depth 									= 256;
+			limits.max_attributes 						= 256;
+			limits.max_name_bytes 						= 1024;
+			return limits;
+		}
+
+		static constexpr Limits	unlimited()
+		{
+			Limits limits;
+			limits.max_entity_expansions 			= UINT64_MAX;
+			limits.max_entity_expansion_bytes	= UINT64_MAX;
+			return limits;
+		}
+
+		friend constexpr bool	operator==(const Limits &, const Limits &) = default;
+	};
+
+	//---------------------------------------------------------------------------
+	//	Statistics are only collected when the library is built with
+	//	ADEXML_ENABLE_STATS; otherwise the instrumentation is compiled out,
+	//	stats() returns zeros and the stats hook is never called.
+	//
+	//	Parse time is attributed to the group of the state being parsed. The
+	//	clock is only read when the group changes, and time spent in the
+	//	callback and attribute hook is kept separate from time in the parser.
+	//	Allocations count those made through the parser's memory resource.
+	//---------------------------------------------------------------------------
+	struct Stats
+	{
+		enum Group : std::uint8_t
+		{
+			GROUP_CONTENT,					// Character data
+			GROUP_TAG,							// Tag names and the space between attributes
+			GROUP_ATTRIBUTE,				// Attribute names and values
+			GROUP_ENTITY,						// Entity and character references
+			GROUP_DECLARATION,			// Comments, CDATA sections and the DOCTYPE
+			GROUP_PATH,							// Rebuilding the element path
+			GROUP_CALLBACK,					// Inside the callback or attribute hook
+			GROUP_COUNT
+		};
+
+		std::uint64_t														bytes											= 0;
+		std::uint64_t														code_points								= 0;
+		std::array<std::uint64_t, ACTION_PI + 1>	events 										= {};		// Indexed by Action
+		std::array<std::uint64_t, GROUP_COUNT>		group_ns 									= {};
+		std::uint64_t														allocations								= 0;
+		std::uint64_t														allocated_bytes						= 0;
+		std::uint64_t														max_depth									= 0;
+		std::uint64_t														max_content_bytes					= 0;
+		std::uint64_t														max_attribute_value_bytes	= 0;
+		std::uint64_t														max_path_bytes						= 0;
+		std::uint64_t														max_markup_bytes					= 0;
+
+		std::uint64_t		callback_ns() const		{return group_ns[GROUP_CALLBACK];}
+		std::uint64_t		parser_ns() const
+		{
+			std::uint64_t ns = 0;
+			for(std::size_t group = 0; group < GROUP_CALLBACK; ++group)
+				ns += group_ns[group];
+			return ns;
+		}
+
+		static constexpr std::string_view
+		group_name(Group group)
+		{
+			constexpr std::string_view NAMES[GROUP_COUNT] = {"content", "tag", "attribute", "entity", "declaration", "path", "callback"};
+			return group < GROUP_COUNT ? NAMES[group] : "unknown";
+		}
+	};
+
+	static constexpr bool STATS_ENABLED = (ADEXML_ENABLE_STATS != 0);
+
+	using StatsHook = std::function<void (const Stats & stats)>;
 
 private:
-	enum State
+	enum State : std::uint8_t
 	{
 		STATE_IDLE,
 		STATE_ERROR,
@@ -113,42 +364,297 @@ private:
 		STATE_ATTRIBUTE_NAME,
 		STATE_ATTRIBUTE_EXPECT_VALUE,
 		STATE_ATTRIBUTE_VALUE,
-		STATE_ATTRIBUTE_VALUE_STRING
+		STATE_ATTRIBUTE_VALUE_STRING,
+		STATE_MARKUP_DECL,
+		STATE_COMMENT,
+		STATE_CDATA,
+		STATE_DOCTYPE
+	};
+
+	//---------------------------------------------------------------------------
+	//	Buffers for the token currently being parsed. In compact mode these are
+	//	borrowed from a per-thread pool for the duration of a write() and given
+	//	back whenever the parser is idle between tokens. The buffers allocate
+	//	through their own counter so that whichever parser holds them can report
+	//	their size.
+	//---------------------------------------------------------------------------
+	struct Scratch
+	{
+		CountingResource						meter;					// Wraps the resource the Scratch was allocated from
+		String											tag_name;
+		String											tag_namespace;
+		String											attr_name;
+		String											attr_value;
+		String											markup;					// Keyword or DOCTYPE text after "<!"
+		String											entity_name;		// Reference being decoded by m_entity_parser
+		const char8_t *							chunk				= nullptr;		// Data passed to the write() in progress
+		std::uint64_t								chunk_offset	= 0;				// Offset of chunk in the input
+		std::uint64_t								tag_offset 		= 0;
+		std::uint32_t								attr_count 		= 0;
+
+		explicit Scratch(std::pmr::memory_resource * resource)
+			: meter(resource), tag_name(&meter), tag_namespace(&meter), attr_name(&meter), attr_value(&meter), markup(&meter), entity_name(&meter) {}
+		Scratch(const Scratch &) = delete;
+		Scratch & operator=(const Scratch &) = delete;
+
+		void	clear()			{tag_name.clear(); tag_namespace.clear(); attr_name.clear(); attr_value.clear(); markup.clear(); entity_name.clear();}
+		void	shrink(std::size_t keep);
+		std::size_t	bytes() const			{return sizeof(Scratch) + meter.in_use();}
+		std::pmr::memory_resource *	resource() const	{return meter.upstream();}
+	};
+
+	template<typename T>
+	struct ResourceDeleter
+	{
+		void	operator()(T * object) const	{std::pmr::polymorphic_allocator<>(object->resource()).delete_object(object);}
 	};
 
+	using ScratchPtr 	= std::unique_ptr<Scratch, ResourceDeleter<Scratch>>;
+	using DoctypePtr 	= std::unique_ptr<Doctype, ResourceDeleter<Doctype>>;
+	using ValidatorPtr	= std::unique_ptr<Validator, ResourceDeleter<Validator>>;
+
+	//---------------------------------------------------------------------------
+	//	Configuration and state that most parsers never use, allocated the
+	//	first time any of it is needed so that it costs an idle parser one
+	//	pointer.
+	//---------------------------------------------------------------------------
+	struct Extras
+	{
+		AttributeHook								attribute_hook;
+		DoctypePtr									doctype;					// Allocated on the first DOCTYPE or call to entities()
+		ValidatorPtr								validator;				// Only present while a schema is set
+		Limits											limits;						// Set by set_limits() unless they are the defaults
+		std::span<const char8_t>		resume;						// Unparsed remainder of a paused write
+		std::pmr::memory_resource *	memory;
+		Encoding										document_encoding = ENCODING_UTF8;	// Set by set_encoding(); each document starts in it
+		bool												b_fixed_encoding 	= false;
+
+		// Out of line because Validator is only complete in the .cpp.
+		explicit Extras(std::pmr::memory_resource * resource);
+		~Extras();
+
+		std::pmr::memory_resource *	resource() const	{return memory;}
+	};
+
+	using ExtrasPtr 	= std::unique_ptr<Extras, ResourceDeleter<Extras>>;
+
 	Callback											m_callback;
-	std::vector<Element>					m_element_stack;
+	CountingResource							m_resource;					// Wraps the caller's resource
+	ElementStack									m_element_stack;
+	ElementStack									m_element_pool;			// Retired elements kept for their string/map capacity.
 
-	Encoding											m_encoding = ENCODING_UTF8;
+	ScratchPtr										m_scratch;
+	ExtrasPtr											m_extras;
+	String												m_stack_path;
+	EntityParser									m_entity_parser;
 	adexml::unicode::U8Parser			m_u8_parser;
-	std::u32string								m_buffer_u32;
-	std::u8string									m_tag_name;
-	std::u8string									m_tag_namespace;
-	std::u8string									m_attr_name;
-	std::u8string									m_attr_value;
-	std::u8string									m_stack_path;
+	const Limits *								m_limits;						// The shared defaults or m_extras->limits
+	std::uint64_t									m_position			= 0;				// Offset of the byte being parsed
+	std::uint32_t									m_line					= 1;				// Location of the start of the write() in progress,
+	std::uint32_t									m_column				= 1;				// or of m_position between writes
+	Encoding											m_encoding = ENCODING_UTF8;
 	State													m_state = STATE_IDLE;
-	char32_t											m_last_char = 0;
-	char32_t 											m_attr_delimeter = 0;
+	char8_t 											m_attr_delimeter = 0;
+	std::uint8_t									m_markup_state = 0;	// Run of ']' or '-', or DOCTYPE_* flags
 	ElementType										m_element_type = ElementType::ELEMENT;
-	EntityParser									m_entity_parser;
+	bool													m_b_compact = false;
+	bool													m_b_fingerprints = false;
+	bool													m_b_paused = false;
+#if ADEXML_ENABLE_STATS
+	Stats													m_stats;
+	StatsHook											m_stats_hook;
+	std::uint64_t									m_stats_interval		= 0;
+	std::uint64_t									m_stats_next_sample	= UINT64_MAX;		// m_position at which the hook is next called
+	std::chrono::steady_clock::time_point	m_stats_mark;								// Start of the interval being timed
+	Stats::Group									m_stats_group				= Stats::GROUP_CONTENT;
+#endif
 
 public:
 	Parser() = delete;
-	Parser(Callback callback)	: m_callback(callback) {}
-	~Parser() = default;
+	//---------------------------------------------------------------------------
+	//	All allocations made by the parser and by the elements it creates come
+	//	from 'resource'. If the resource throws std::bad_alloc (for example a
+	//	BoundedResource whose budget is exhausted) the parse fails cleanly with
+	//	OUT_OF_MEMORY and the parser must be reset() before it is reused.
+	//---------------------------------------------------------------------------
+	Parser(Callback callback, std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+	Parser(const Parser &) = delete;
+	Parser & operator=(const Parser &) = delete;
+	~Parser();
 
-	std::error_code				write(std::span<char8_t> data);
+	std::pmr::memory_resource *	resource() const	{return m_resource.upstream();}
+
+	std::error_code				write(std::span<const char8_t> data);
 	std::error_code				put(char8_t	ch)										{return write({&ch,1U});}
 	std::error_code				put(char32_t ch);
 
+	//---------------------------------------------------------------------------
+	//	Backpressure. A callback may call pause() to stop the parse once the
+	//	current event has been delivered. write_some() then returns the number
+	//	of bytes it consumed and the parser accepts no more input (PAUSED)
+	//	until resume() is called. resume() continues with the unconsumed part
+	//	of the paused write's data, which must still be valid, and may itself be
+	//	paused again. write() reports a pause as PAUSED; this is not an error
+	//	and leaves the parser usable.
+	//---------------------------------------------------------------------------
+	struct WriteResult
+	{
+		std::size_t				consumed = 0;
+		std::error_code		ec;
+	};
+
+	WriteResult						write_some(std::span<const char8_t> data);
+	void									pause()							{m_b_paused = true;}
+	bool									is_paused() const		{return m_b_paused;}
+	WriteResult						resume();
+
+	//---------------------------------------------------------------------------
+	//	Checkpoints. checkpoint() serialises the complete parse state (position,
+	//	state machine, element stack, partial token, UTF-8 and entity decoders,
+	//	DOCTYPE and validator frames) into a compact blob. restore() rebuilds
+	//	that state in this parser, after which input continues from offset().
+	//	The callback, limits and schema are configuration and are not saved;
+	//	set the same schema before restoring a validating parse. Checkpoints may
+	//	be taken between writes or while paused, but not from inside a callback
+	//	of a write in progress (INVALID_STATE).
+	//---------------------------------------------------------------------------
+	std::expected<std::vector<std::byte>, std::error_code>	checkpoint() const;
+	std::error_code				restore(std::span<const std::byte> checkpoint);
+
+	//---------------------------------------------------------------------------
+	//	Return the parser to its initial state so that a new document can be
+	//	parsed. All string, stack and map capacity is retained so a reused parser
+	//	does not have to warm up again. This also recovers from STATE_ERROR.
+	//	finish() reports whether the input written so far formed a complete
+	//	document.
+	//---------------------------------------------------------------------------
+	void									reset();
+	std::error_code				finish() const;
+	void									set_callback(Callback callback)	{m_callback = std::move(callback);}
+	void									set_attribute_hook(AttributeHook hook);
+	void									set_limits(const Limits & limits);
+	const Limits &				limits() const	{return *m_limits;}
+
+	//---------------------------------------------------------------------------
+	//	The document type declaration, once one has been parsed (otherwise
+	//	null). entities() gives access to the general entity table so that
+	//	entities can be declared before a document is written. Both are cleared
+	//	by reset().
+	//---------------------------------------------------------------------------
+	const Doctype *				doctype() const	{return (m_extras && m_extras->doctype && !m_extras->doctype->name.empty()) ? m_extras->doctype.get() : nullptr;}
+	EntityTable &					entities();
+
+	//---------------------------------------------------------------------------
+	//	Validate each element against 'schema' as it is parsed. A validity
+	//	error fails the write() like any other error, so offset() and location()
+	//	give its position; Element::offset locates the offending start tag.
+	//	Pass nullptr to stop validating.
+	//---------------------------------------------------------------------------
+	void									set_schema(std::shared_ptr<const Schema> schema);
+
+	//---------------------------------------------------------------------------
+	//	Subtree fingerprints (see fingerprint.h). When enabled, an element's
+	//	Element::fingerprint holds the fingerprint of its whole subtree at its
+	//	END event, or at the START of a self-closed element. While it is open
+	//	the field accumulates the fingerprints of its children. Like limits,
+	//	this is configuration and is not saved in checkpoints.
+	//---------------------------------------------------------------------------
+	void									set_fingerprints(bool b_enable)	{m_b_fingerprints = b_enable;}
+	bool									fingerprints() const						{return m_b_fingerprints;}
+
+	//---------------------------------------------------------------------------
+	//	Character encoding. Documents are read as UTF-8 unless set_encoding()
+	//	says otherwise. An encoding="..." in the XML declaration that names
+	//	UTF-8, ISO-8859-1, ISO-8859-15 or Windows-1252 switches to it for the
+	//	rest of the document, unless 'b_fixed' is set because the encoding is
+	//	known from elsewhere (an HTTP charset, say). Other names are ignored.
+	//	reset() returns to the encoding given here. ENCODING_PLAIN_TEXT reads
+	//	each byte as the code point of the same value. The UTF-16 and UTF-32
+	//	encodings are not supported by write().
+	//---------------------------------------------------------------------------
+	void									set_encoding(Encoding encoding, bool b_fixed = false);
+	Encoding							encoding() const								{return m_encoding;}
+	static std::optional<Encoding>	encoding_from_name(std::u8string_view name);
+
+	//---------------------------------------------------------------------------
+	//	Input positions. offset() is the offset, in bytes passed to write(), of
+	//	the byte currently being parsed. During a callback this is the '>' that
+	//	completed the tag, and after a failed write() it is the byte that caused
+	//	the error. Lines are only counted once per write() (or on demand when
+	//	location() is called from a callback) so tracking costs nothing per
+	//	character. Lines and columns are 1-based and columns count bytes; both
+	//	stop at UINT32_MAX.
+	//---------------------------------------------------------------------------
+	struct Location
+	{
+		std::uint64_t	offset	= 0;
+		std::uint64_t	line		= 1;
+		std::uint64_t	column	= 1;
+	};
+
+	std::uint64_t					offset() const	{return m_position;}
+	Location							location() const;
+	static Location				locate(std::span<const char8_t> input, std::uint64_t offset);
+
+	//---------------------------------------------------------------------------
+	//	Compact mode is intended for large numbers of long lived, mostly idle
+	//	parsers (one per connection). Token buffers are only held while a token
+	//	is in flight and buffer capacity is released after bursts, at the cost of
+	//	some re-allocation. shrink_to_fit() releases spare capacity on demand.
+	//
+	//	memory_usage() reports the bytes actually allocated, as counted by the
+	//	resources the parser allocates through. Only scratch buffers from the
+	//	default resource are shared between parsers.
+	//---------------------------------------------------------------------------
+	struct MemoryUsage
+	{
+		std::size_t		object_bytes 		= 0;		// sizeof(Parser)
+		std::size_t		scratch_bytes		= 0;		// Token buffers currently held
+		std::size_t		heap_bytes			= 0;		// Open and recycled elements, path, DOCTYPE and validator
+
+		std::size_t		total() const		{return object_bytes + scratch_bytes + heap_bytes;}
+	};
+
+	void									set_compact(bool b_compact);
+	bool									is_compact() const	{return m_b_compact;}
+	void									shrink_to_fit();
+	MemoryUsage						memory_usage() const;
+
+	//---------------------------------------------------------------------------
+	//	stats() returns a snapshot of the counters, which accumulate across
+	//	reset() until reset_stats() is called. The stats hook is called from
+	//	write() with a snapshot each time another 'interval_bytes' of input has
+	//	been parsed, for export to a metrics system; time spent in the hook is
+	//	not counted.
+	//---------------------------------------------------------------------------
+	Stats									stats() const;
+	void									reset_stats();
+	void									set_stats_hook(StatsHook hook, std::uint64_t interval_bytes);
+
 private:
+	std::error_code				parse_char(char32_t ch);
+	static std::vector<ScratchPtr> &	scratch_pool();
+	void									acquire_scratch();
+	void									release_idle_scratch();
+	bool									is_between_tokens() const		{return (m_state == STATE_IDLE) && m_entity_parser.is_idle();}
+	Extras &							extras();
+	void									count_lines();
+	std::error_code				append_name(char32_t ch, String & name);
 	void									set_state(State state);
+	Element &							push_element();
+	void									pop_element();
 
 	void									on_start_tag();
-	void									on_end_start_tag();
+	std::error_code				on_end_start_tag();
 	std::error_code				on_end_end_tag();
 	std::error_code				on_pi_tag();
+	std::error_code				notify(Action action);
+	void									add_fingerprint(std::uint64_t children);
+#if ADEXML_ENABLE_STATS
+	void									stats_charge();
+	Stats::Group					stats_switch(Stats::Group group);
+	void									stats_sample();
+#endif
 
 	std::error_code				do_state_idle(char32_t ch);
 	std::error_code				do_state_tag_start(char32_t ch);
@@ -162,29 +668,17 @@ private:
 	std::error_code				do_state_attribute_name(char32_t ch);
 	std::error_code				do_state_attribute_expect_value(char32_t ch);
 	std::error_code				do_state_attribute_value(char32_t ch);
+	std::error_code				do_state_markup_decl(char32_t ch);
+	std::error_code				do_state_comment(char32_t ch);
+	std::error_code				do_state_cdata(char32_t ch);
+	std::error_code				do_state_doctype(char32_t ch);
+	std::error_code				on_doctype();
+	Doctype &							acquire_doctype();
 
 	void									build_path_string();
 
-	static constexpr bool	is_name_start_char(char32_t ch)	{	return 	(ch==adexml::COLON) || (ch==adexml::LOW_LINE) || isalpha(ch) ||
-																																	((ch>=0xC0) && (ch<=0xD6)) ||
-																																	((ch>=0xD8) && (ch<=0xF6)) ||
-																																	((ch>=0xF8) && (ch<=0x02FF)) ||
-																																	((ch>=0x0370) && (ch<=0x037D)) ||
-																																	((ch>=0x037F) && (ch<=0x1FFF)) ||
-																																	((ch>=0x200C) && (ch<=0x200D)) ||
-																																	((ch>=0x2070) && (ch<=0x218F)) ||
-																																	((ch>=0x2C00) && (ch<=0x2FEF)) ||
-																																	((ch>=0x3001) && (ch<=0xD7FF)) ||
-																																	((ch>=0xF900) && (ch<=0xFDCF)) ||
-																																	((ch>=0xFDF0) && (ch<=0xFFFD)) ||
-																																	((ch>=0x10000) && (ch<=0xEFFFF)); }
-
-	static constexpr bool is_name_char(char32_t ch)				{	return 	is_name_start_char(ch) || 
-																																	(ch==adexml::HYPHEN_MINUS) || (ch==adexml::FULL_STOP) ||
-																																	isdigit(ch) || (ch==0xB7) ||
-																																	((ch>=0x0300) && (ch<=0x036F)) ||
-																																	((ch>=0x203F) && (ch<=0x2040)); }
-																																	
+	static constexpr bool	is_name_start_char(char32_t ch)	{return is_xml_name_start_char(ch);}
+	static constexpr bool	is_name_char(char32_t ch)				{return is_xml_name_char(ch);}
 };
 
 } // namespace adexml
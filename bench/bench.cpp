@@ -0,0 +1,333 @@
+//=============================================================================
+//	FILE:					bench.cpp
+//	SYSTEM:				
+//	DESCRIPTION:	Parser throughput benchmark with JSON output
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	USAGE:
+//		adexml_bench [--size MB] [--iterations N] [--seed N]
+//								 [--corpus NAME]... [--config NAME]... [FILE.xml]...
+//
+//		Parses each corpus with each parser configuration and writes one JSON
+//		document to stdout. Corpora are generated in memory (see corpus.h)
+//		unless files are given. --corpus and --config restrict the run to the
+//		named entries and may be repeated.
+//
+//		Throughput is taken from the median of the timed iterations, after one
+//		untimed warm-up. Allocations are counted by replacing the global
+//		operator new and cover the timed iterations only. peak_rss_bytes is
+//		the process high-water mark when the run finished, so it only grows
+//		from one result to the next.
+//=============================================================================
+#include <sys/resource.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+#include "adexml/xml_parser.h"
+#include "corpus.h"
+
+//=============================================================================
+//
+//	ALLOCATION COUNTING
+//
+//=============================================================================
+
+namespace
+{
+std::atomic<std::uint64_t>	g_allocations = 0;
+}
+
+void *
+operator new(std::size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	if(auto ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void *
+operator new(std::size_t size, std::align_val_t alignment)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void *));
+	if(auto ptr = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void *	operator new[](std::size_t size)																			{return ::operator new(size);}
+void *	operator new[](std::size_t size, std::align_val_t alignment)					{return ::operator new(size, alignment);}
+void		operator delete(void * ptr) noexcept																	{std::free(ptr);}
+void		operator delete(void * ptr, std::size_t) noexcept											{std::free(ptr);}
+void		operator delete(void * ptr, std::align_val_t) noexcept								{std::free(ptr);}
+void		operator delete(void * ptr, std::size_t, std::align_val_t) noexcept		{std::free(ptr);}
+void		operator delete[](void * ptr) noexcept																{std::free(ptr);}
+void		operator delete[](void * ptr, std::size_t) noexcept										{std::free(ptr);}
+void		operator delete[](void * ptr, std::align_val_t) noexcept							{std::free(ptr);}
+void		operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept	{std::free(ptr);}
+
+namespace
+{
+
+//=============================================================================
+//
+//	CONFIGURATIONS
+//
+//=============================================================================
+
+struct Input
+{
+	std::string						name;
+	std::u8string					text;
+};
+
+struct Run
+{
+	std::uint64_t					events = 0;
+	std::error_code				ec;
+};
+
+//-----------------------------------------------------------------------------
+//	A configuration prepares its parser once and then parses the input once
+//	per call, so per-parser setup is excluded from the timings unless the
+//	configuration is about that setup.
+//-----------------------------------------------------------------------------
+struct Config
+{
+	const char *	name;
+	std::function<std::function<Run (const std::u8string &)> ()>	prepare;
+};
+
+adexml::Parser::Callback
+counter(std::uint64_t & events)
+{
+	return [&events](adexml::Parser::Action, const adexml::String &, const adexml::ElementStack &) -> std::error_code
+		{
+			++events;
+			return {};
+		};
+}
+
+std::error_code
+parse(adexml::Parser & parser, const std::u8string & text, std::size_t chunk)
+{
+	parser.reset();
+	for(std::size_t pos = 0; pos < text.size(); pos += chunk)
+		if(auto ec = parser.write({text.data() + pos, std::min(chunk, text.size() - pos)}))
+			return ec;
+	return parser.finish();
+}
+
+//-----------------------------------------------------------------------------
+//	A reused parser with the given limits and memory resource.
+//-----------------------------------------------------------------------------
+std::function<std::function<Run (const std::u8string &)> ()>
+reused(std::size_t chunk, adexml::Parser::Limits limits = {}, bool b_pool = false)
+{
+	return [=]()
+		{
+			struct State
+			{
+				std::pmr::unsynchronized_pool_resource	pool;
+				std::uint64_t														events = 0;
+				adexml::Parser													parser;
+
+				State(bool b_pool) : parser(nullptr, b_pool ? &pool : std::pmr::get_default_resource()) {parser.set_callback(counter(events));}
+			};
+
+			auto state = std::make_shared<State>(b_pool);
+			state->parser.set_limits(limits);
+
+			return [=](const std::u8string & text)
+				{
+					state->events = 0;
+					auto ec = parse(state->parser, text, chunk);
+					return Run{state->events, ec};
+				};
+		};
+}
+
+const Config	CONFIGS[] =
+{
+	{"default",				reused(SIZE_MAX)},
+	{"chunked_4k",		reused(4096)},
+	{"untrusted",			reused(SIZE_MAX, adexml::Parser::Limits::untrusted())},
+	{"pool_resource",	reused(SIZE_MAX, {}, true)},
+	{"fresh_parser",	[]()
+		{
+			return std::function<Run (const std::u8string &)>([](const std::u8string & text)
+				{
+					Run run;
+					adexml::Parser parser(counter(run.events));
+					run.ec = parse(parser, text, SIZE_MAX);
+					return run;
+				});
+		}},
+};
+
+//=============================================================================
+//
+//	OUTPUT
+//
+//=============================================================================
+
+std::uint64_t
+peak_rss_bytes()
+{
+	rusage usage {};
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+void
+print_json_string(std::string_view text)
+{
+	std::putchar('"');
+	for(unsigned char ch : text)
+	{
+		if(ch == '"' || ch == '\\')
+			std::printf("\\%c", ch);
+		else if(ch < 0x20)
+			std::printf("\\u%04x", ch);
+		else
+			std::putchar(ch);
+	}
+	std::putchar('"');
+}
+
+bool
+selected(const std::vector<std::string> & names, std::string_view name)
+{
+	return names.empty() || std::ranges::find(names, name) != names.end();
+}
+
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+	using namespace adexml::bench;
+
+	std::size_t								size				= 16;
+	std::size_t								iterations	= 5;
+	std::uint64_t							seed				= 1;
+	std::vector<std::string>	corpus_names;
+	std::vector<std::string>	config_names;
+	std::vector<std::string>	files;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		bool b_value = (i + 1 < argc);
+
+		if(arg == "--size" && b_value)
+			size = std::strtoul(argv[++i], nullptr, 10);
+		else if(arg == "--iterations" && b_value)
+			iterations = std::max(1UL, std::strtoul(argv[++i], nullptr, 10));
+		else if(arg == "--seed" && b_value)
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		else if(arg == "--corpus" && b_value)
+			corpus_names.emplace_back(argv[++i]);
+		else if(arg == "--config" && b_value)
+			config_names.emplace_back(argv[++i]);
+		else if(arg.starts_with("--"))
+		{
+			std::fprintf(stderr, "usage: %s [--size MB] [--iterations N] [--seed N] [--corpus NAME]... [--config NAME]... [FILE.xml]...\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		else
+			files.emplace_back(arg);
+	}
+
+	std::vector<Input> inputs;
+	if(files.empty())
+	{
+		for(auto corpus : ALL_CORPORA)
+			if(selected(corpus_names, corpus_name(corpus)))
+				inputs.push_back({std::string(corpus_name(corpus)), generate_corpus(corpus, size << 20, seed)});
+	}
+	else
+	{
+		for(auto & file : files)
+		{
+			std::ifstream stream(file, std::ios::binary);
+			if(!stream)
+			{
+				std::fprintf(stderr, "%s: cannot open\n", file.c_str());
+				return EXIT_FAILURE;
+			}
+			Input input {std::filesystem::path(file).stem().string(), {}};
+			input.text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+			inputs.push_back(std::move(input));
+		}
+	}
+
+	std::printf("{\n\t\"benchmark\": \"adexml\",\n\t\"size_mb\": %zu,\n\t\"iterations\": %zu,\n\t\"seed\": %llu,\n\t\"results\": [",
+							size, iterations, static_cast<unsigned long long>(seed));
+
+	bool b_first = true;
+	for(auto & input : inputs)
+	{
+		for(auto & config : CONFIGS)
+		{
+			if(!selected(config_names, config.name))
+				continue;
+
+			auto parse_once = config.prepare();
+			auto run 				= parse_once(input.text);		// Warm-up
+
+			std::vector<double> seconds;
+			auto allocations = g_allocations.load(std::memory_order_relaxed);
+			for(std::size_t i = 0; i < iterations && !run.ec; ++i)
+			{
+				auto start 	= std::chrono::steady_clock::now();
+				run 				= parse_once(input.text);
+				seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			}
+			allocations = g_allocations.load(std::memory_order_relaxed) - allocations;
+
+			std::ranges::sort(seconds);
+			double median = seconds.empty() ? 0.0 : seconds[seconds.size() / 2];
+			double total_events = static_cast<double>(run.events) * static_cast<double>(seconds.size());
+
+			std::printf("%s\n\t\t{\"corpus\": ", b_first ? "" : ",");
+			print_json_string(input.name);
+			std::printf(", \"config\": ");
+			print_json_string(config.name);
+			std::printf(", \"bytes\": %zu, \"events\": %llu", input.text.size(), static_cast<unsigned long long>(run.events));
+
+			if(run.ec)
+			{
+				std::printf(", \"error\": ");
+				print_json_string(run.ec.message());
+			}
+			else
+			{
+				std::printf(", \"median_seconds\": %.6f, \"min_seconds\": %.6f, \"mb_per_s\": %.2f, \"events_per_s\": %.0f, \"allocations_per_event\": %.4f",
+										median, seconds.front(), (static_cast<double>(input.text.size()) / median) / (1024.0 * 1024.0),
+										static_cast<double>(run.events) / median, total_events > 0 ? static_cast<double>(allocations) / total_events : 0.0);
+			}
+			std::printf(", \"peak_rss_bytes\": %llu}", static_cast<unsigned long long>(peak_rss_bytes()));
+			std::fflush(stdout);
+			b_first = false;
+		}
+	}
+
+	std::printf("\n\t]\n}\n");
+	return EXIT_SUCCESS;
+}
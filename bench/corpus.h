@@ -0,0 +1,312 @@
+//=============================================================================
+//	FILE:					corpus.h
+//	SYSTEM:
+//	DESCRIPTION:	Deterministic synthetic XML corpora for the benchmarks
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Each corpus is a single well formed document of roughly the requested
+//		size. The output depends only on the kind, size and seed; randomness
+//		comes from splitmix64 rather than <random> distributions, whose output
+//		differs between standard libraries.
+//
+//		Every corpus stays inside Parser::Limits::untrusted() so that all
+//		benchmark configurations parse the same input.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_BENCH_CORPUS_H
+#define GUARD_ADE_XML_BENCH_CORPUS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace adexml::bench
+{
+
+enum class Corpus
+{
+	DEEP,
+	WIDE_ATTRIBUTES,
+	LARGE_TEXT,
+	ENTITIES,
+	UTF8,
+	TINY_ELEMENTS,
+	RECORDS
+};
+
+inline constexpr std::array<Corpus, 7>	ALL_CORPORA = {	Corpus::DEEP, Corpus::WIDE_ATTRIBUTES, Corpus::LARGE_TEXT, Corpus::ENTITIES,
+																												Corpus::UTF8, Corpus::TINY_ELEMENTS, Corpus::RECORDS };
+
+inline constexpr std::string_view
+corpus_name(Corpus corpus)
+{
+	switch(corpus)
+	{
+		case Corpus::DEEP :							return "deep";
+		case Corpus::WIDE_ATTRIBUTES :	return "wide_attributes";
+		case Corpus::LARGE_TEXT :				return "large_text";
+		case Corpus::ENTITIES :					return "entities";
+		case Corpus::UTF8 :							return "utf8";
+		case Corpus::TINY_ELEMENTS :		return "tiny_elements";
+		case Corpus::RECORDS :					return "records";
+	}
+	return "unknown";
+}
+
+inline std::optional<Corpus>
+corpus_from_name(std::string_view name)
+{
+	for(auto corpus : ALL_CORPORA)
+		if(corpus_name(corpus) == name)
+			return corpus;
+	return std::nullopt;
+}
+
+//-----------------------------------------------------------------------------
+//	splitmix64
+//-----------------------------------------------------------------------------
+class Random
+{
+private:
+	std::uint64_t		m_state;
+
+public:
+	explicit Random(std::uint64_t seed) : m_state(seed) {}
+
+	std::uint64_t
+	next()
+	{
+		auto z = (m_state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	std::uint32_t		below(std::uint32_t limit)	{return static_cast<std::uint32_t>(next() % limit);}
+};
+
+namespace detail
+{
+
+inline void
+append(std::u8string & out, std::string_view text)
+{
+	out.append(text.begin(), text.end());
+}
+
+inline void
+append_number(std::u8string & out, std::uint64_t value)
+{
+	append(out, std::to_string(value));
+}
+
+inline void
+append_word(std::u8string & out, Random & random)
+{
+	static constexpr std::string_view WORDS[] = {	"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+																								"india", "juliet", "kilo", "lima", "mike", "november", "oscar", "papa" };
+	append(out, WORDS[random.below(std::size(WORDS))]);
+}
+
+inline void
+append_text(std::u8string & out, Random & random, std::size_t words)
+{
+	for(std::size_t i = 0; i < words; ++i)
+	{
+		if(i)
+			out.push_back(u8' ');
+		append_word(out, random);
+	}
+}
+
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+//	Generate a corpus of approximately 'size' bytes.
+//-----------------------------------------------------------------------------
+inline std::u8string
+generate_corpus(Corpus corpus, std::size_t size, std::uint64_t seed = 1)
+{
+	using namespace detail;
+
+	Random 				random(seed ^ (static_cast<std::uint64_t>(corpus) << 56));
+	std::u8string out;
+	out.reserve(size + 4096);
+
+	append(out, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+
+	switch(corpus)
+	{
+		//-------------------------------------------------------------------------
+		//	Repeated chains of nested elements, each up to 200 deep.
+		//-------------------------------------------------------------------------
+		case Corpus::DEEP :
+			append(out, "<deep>");
+			while(out.size() < size)
+			{
+				auto depth = 100 + random.below(100);
+				for(std::uint32_t i = 0; i < depth; ++i)
+				{
+					append(out, "<n");
+					append_number(out, i % 10);
+					append(out, ">");
+				}
+				append_word(out, random);
+				for(std::uint32_t i = depth; i-- > 0;)
+				{
+					append(out, "</n");
+					append_number(out, i % 10);
+					append(out, ">");
+				}
+				out.push_back(u8'\n');
+			}
+			append(out, "</deep>\n");
+			break;
+
+		//-------------------------------------------------------------------------
+		//	Empty elements carrying 32 to 64 attributes each.
+		//-------------------------------------------------------------------------
+		case Corpus::WIDE_ATTRIBUTES :
+			append(out, "<wide>\n");
+			while(out.size() < size)
+			{
+				auto count = 32 + random.below(33);
+				append(out, "<item");
+				for(std::uint32_t i = 0; i < count; ++i)
+				{
+					append(out, " attribute_");
+					append_number(out, i);
+					append(out, "=\"");
+					append_word(out, random);
+					append_number(out, random.below(100000));
+					out.push_back(u8'"');
+				}
+				append(out, "/>\n");
+			}
+			append(out, "</wide>\n");
+			break;
+
+		//-------------------------------------------------------------------------
+		//	Few elements with 64KiB to 1MiB of text content.
+		//-------------------------------------------------------------------------
+		case Corpus::LARGE_TEXT :
+			append(out, "<documents>\n");
+			while(out.size() < size)
+			{
+				auto target = out.size() + (64U << 10) + random.below(960U << 10);
+				append(out, "<text>");
+				while(out.size() < target)
+				{
+					append_text(out, random, 12);
+					append(out, ".\n");
+				}
+				append(out, "</text>\n");
+			}
+			append(out, "</documents>\n");
+			break;
+
+		//-------------------------------------------------------------------------
+		//	Text dense with predefined, character and internal subset entities.
+		//-------------------------------------------------------------------------
+		case Corpus::ENTITIES :
+			append(out, "<!DOCTYPE entities [\n"
+									"<!ENTITY company \"Example &amp; Sons Ltd\">\n"
+									"<!ENTITY copy \"&#169; &company;\">\n"
+									"]>\n<entities>\n");
+			while(out.size() < size)
+			{
+				static constexpr std::string_view REFERENCES[] = {"&amp;", "&lt;", "&gt;", "&quot;", "&apos;", "&#65;", "&#x263A;", "&company;", "&copy;"};
+				append(out, "<p note=\"");
+				append(out, REFERENCES[random.below(std::size(REFERENCES))]);
+				append(out, "\">");
+				for(int i = 0; i < 16; ++i)
+				{
+					append_word(out, random);
+					append(out, REFERENCES[random.below(std::size(REFERENCES))]);
+				}
+				append(out, "</p>\n");
+			}
+			append(out, "</entities>\n");
+			break;
+
+		//-------------------------------------------------------------------------
+		//	Names, attribute values and text in two, three and four byte UTF-8.
+		//-------------------------------------------------------------------------
+		case Corpus::UTF8 :
+			append(out, "<текст>\n");
+			while(out.size() < size)
+			{
+				static constexpr std::string_view PHRASES[] = {	"Grüße aus München", "Привет, мир", "こんにちは世界", "你好，世界",
+																												"مرحبا بالعالم", "Γειά σου Κόσμε", "🎉 emoji 🚀 text 🌍", "naïve café déjà vu" };
+				append(out, "<запись язык=\"");
+				append(out, PHRASES[random.below(std::size(PHRASES))]);
+				append(out, "\">");
+				for(int i = 0; i < 4; ++i)
+				{
+					append(out, PHRASES[random.below(std::size(PHRASES))]);
+					out.push_back(u8' ');
+				}
+				append(out, "</запись>\n");
+			}
+			append(out, "</текст>\n");
+			break;
+
+		//-------------------------------------------------------------------------
+		//	Very many short elements with little or no content.
+		//-------------------------------------------------------------------------
+		case Corpus::TINY_ELEMENTS :
+			append(out, "<t>");
+			while(out.size() < size)
+			{
+				switch(random.below(4))
+				{
+					case 0 : 	append(out, "<a/>"); break;
+					case 1 : 	append(out, "<b>1</b>"); break;
+					case 2 : 	append(out, "<c x=\"1\"/>"); break;
+					default : append(out, "<d><e/></d>"); break;
+				}
+			}
+			append(out, "</t>\n");
+			break;
+
+		//-------------------------------------------------------------------------
+		//	A stream of flat, uniformly shaped records.
+		//-------------------------------------------------------------------------
+		case Corpus::RECORDS :
+			append(out, "<records>\n");
+			for(std::uint64_t id = 0; out.size() < size; ++id)
+			{
+				append(out, "  <record id=\"");
+				append_number(out, id);
+				append(out, "\" type=\"");
+				append_word(out, random);
+				append(out, "\"><name>");
+				append_text(out, random, 2);
+				append(out, "</name><quantity>");
+				append_number(out, random.below(1000));
+				append(out, "</quantity><price>");
+				append_number(out, random.below(100000) / 100);
+				out.push_back(u8'.');
+				append_number(out, 10 + random.below(90));
+				append(out, "</price><active>");
+				append(out, random.below(2) ? "true" : "false");
+				append(out, "</active></record>\n");
+			}
+			append(out, "</records>\n");
+			break;
+	}
+
+	return out;
+}
+
+} // namespace adexml::bench
+
+#endif // ! defined GUARD_ADE_XML_BENCH_CORPUS_H
@@ -0,0 +1,78 @@
+//=============================================================================
+//	FILE:					corpus_gen.cpp
+//	SYSTEM:				
+//	DESCRIPTION:	Writes the synthetic benchmark corpora to disk
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	USAGE:
+//		adexml_corpus_gen <output_directory> [size_mb] [seed] [corpus...]
+//
+//		Writes <output_directory>/<corpus>.xml for each named corpus, or for
+//		all of them when none are named. The same arguments always produce
+//		the same files.
+//=============================================================================
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "corpus.h"
+
+int
+main(int argc, char * argv[])
+{
+	using namespace adexml::bench;
+
+	if(argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <output_directory> [size_mb] [seed] [corpus...]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::filesystem::path	directory	= argv[1];
+	std::size_t						size			= ((argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 16) << 20;
+	std::uint64_t					seed			= (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 1;
+
+	std::vector<Corpus> corpora;
+	for(int i = 4; i < argc; ++i)
+	{
+		auto corpus = corpus_from_name(argv[i]);
+		if(!corpus)
+		{
+			std::fprintf(stderr, "unknown corpus '%s'\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+		corpora.push_back(*corpus);
+	}
+	if(corpora.empty())
+		corpora.assign(ALL_CORPORA.begin(), ALL_CORPORA.end());
+
+	std::error_code ec;
+	std::filesystem::create_directories(directory, ec);
+	if(ec)
+	{
+		std::fprintf(stderr, "%s: %s\n", directory.c_str(), ec.message().c_str());
+		return EXIT_FAILURE;
+	}
+
+	for(auto corpus : corpora)
+	{
+		auto text = generate_corpus(corpus, size, seed);
+		auto path = directory / (std::string(corpus_name(corpus)) + ".xml");
+
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char *>(text.data()), static_cast<std::streamsize>(text.size()));
+		if(!stream)
+		{
+			std::fprintf(stderr, "%s: write failed\n", path.c_str());
+			return EXIT_FAILURE;
+		}
+		std::printf("%s %zu\n", path.c_str(), text.size());
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+//=============================================================================
+//	FILE:					parse_many_bench.cpp
+//	SYSTEM:				
+//	DESCRIPTION:	Thread scaling benchmark for adexml::parse_many()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	USAGE:
+//		adexml_parse_many_bench [documents] [max_threads]
+//=============================================================================
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "adexml/parse_many.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+//	Each worker counts into its own cache line so that the benchmark measures
+//	parse_many() rather than contention on a shared counter.
+//-----------------------------------------------------------------------------
+struct alignas(64) WorkerCount
+{
+	std::size_t		elements = 0;
+};
+
+std::vector<std::u8string>
+make_documents(std::size_t count)
+{
+	std::vector<std::u8string> documents;
+	documents.reserve(count);
+
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		auto id = std::to_string(i);
+		std::u8string doc = u8"<message id=\"";
+		doc.append(id.begin(), id.end());
+		doc.append(u8"\" type=\"chat\"><from>alice@example.com</from><to>bob@example.com</to><body>Hello &amp; welcome, message ");
+		doc.append(id.begin(), id.end());
+		doc.append(u8"</body></message>");
+		documents.push_back(std::move(doc));
+	}
+
+	return documents;
+}
+
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+	std::size_t	count 			= (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+	unsigned		max_threads = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : std::max(1U, std::thread::hardware_concurrency());
+
+	auto documents = make_documents(count);
+
+	std::size_t total_bytes = 0;
+	for(auto & doc : documents)
+		total_bytes += doc.size();
+
+	std::printf("%8s %12s %12s %10s %8s %12s\n", "threads", "docs/s", "MB/s", "speedup", "errors", "elements");
+
+	double baseline = 0.0;
+	for(unsigned threads = 1; threads <= max_threads; threads = (threads < max_threads) ? std::min(threads * 2, max_threads) : threads + 1)
+	{
+		std::vector<WorkerCount> counts(threads);
+
+		adexml::ParseManyOptions options;
+		options.threads = threads;
+
+		auto start 		= std::chrono::steady_clock::now();
+		auto results 	= adexml::parse_many(documents, [&](const adexml::DocumentContext & context) -> adexml::Parser::Callback
+			{
+				auto & count = counts[context.worker];
+				return [&count](adexml::Parser::Action action, const adexml::String &, const adexml::ElementStack &) -> std::error_code
+					{
+						if(action == adexml::Parser::ACTION_END_ELEMENT)
+							++count.elements;
+						return {};
+					};
+			}, options);
+		auto seconds 	= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::size_t errors = 0;
+		for(auto & ec : results)
+			errors += ec ? 1 : 0;
+
+		std::size_t elements = 0;
+		for(auto & worker : counts)
+			elements += worker.elements;
+
+		double docs_per_second = static_cast<double>(count) / seconds;
+		if(threads == 1)
+			baseline = docs_per_second;
+
+		std::printf("%8u %12.0f %12.2f %9.2fx %8zu %12zu\n", threads, docs_per_second, (total_bytes / seconds) / (1024.0 * 1024.0), docs_per_second / baseline, errors, elements);
+	}
+
+	return 0;
+}
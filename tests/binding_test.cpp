@@ -0,0 +1,132 @@
+//=============================================================================
+//	FILE:					binding_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::bind
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <string>
+#include <vector>
+#include "adexml/binding.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+struct Point
+{
+	int							x = 0;
+	double					y = 0.0;
+	std::u8string		label;
+	std::u8string		note;
+	std::optional<int>	z;
+};
+
+constexpr auto point_binding = adexml::bind::record<Point>(u8"point",
+	adexml::bind::attribute(u8"x", &Point::x),
+	adexml::bind::attribute(u8"y", &Point::y),
+	adexml::bind::element(u8"label", &Point::label),
+	adexml::bind::text(&Point::note),
+	adexml::bind::attribute(u8"z", &Point::z) );
+
+//-----------------------------------------------------------------------------
+//	An attribute and a child element may share a name; they are different
+//	fields and must hash apart.
+//-----------------------------------------------------------------------------
+struct Wide
+{
+	int		a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0, i = 0, j = 0;
+	int		a_element = 0;
+};
+
+constexpr auto wide_binding = adexml::bind::record<Wide>(u8"wide",
+	adexml::bind::attribute(u8"a", &Wide::a),
+	adexml::bind::attribute(u8"b", &Wide::b),
+	adexml::bind::attribute(u8"c", &Wide::c),
+	adexml::bind::attribute(u8"d", &Wide::d),
+	adexml::bind::attribute(u8"e", &Wide::e),
+	adexml::bind::attribute(u8"f", &Wide::f),
+	adexml::bind::attribute(u8"g", &Wide::g),
+	adexml::bind::attribute(u8"h", &Wide::h),
+	adexml::bind::attribute(u8"i", &Wide::i),
+	adexml::bind::attribute(u8"j", &Wide::j),
+	adexml::bind::element(u8"a", &Wide::a_element) );
+
+template<typename R>
+std::error_code
+read(const R & binding, std::string_view document, std::vector<typename R::object_type> & out)
+{
+	adexml::bind::Reader reader(binding, [&](auto && object) -> std::error_code
+		{
+			out.push_back(std::move(object));
+			return {};
+		});
+	adexml::Parser parser(reader.callback());
+	reader.attach(parser);
+	if(auto ec = parser.write(u8(document)); ec)
+		return ec;
+	return parser.finish();
+}
+
+void
+test_records()
+{
+	std::vector<Point> points;
+	CHECK(!read(point_binding,
+		"<points>"
+			"<point x=\"1\" y=\"2.5\" other=\"ignored\"><label>first</label>text</point>"
+			"<point x=\"-3\" y=\"0\" z=\"7\"/>"
+		"</points>", points));
+
+	CHECK(points.size() == 2);
+	if(points.size() != 2)
+		return;
+	CHECK(points[0].x == 1 && points[0].y == 2.5);
+	CHECK(points[0].label == u8"first" && points[0].note == u8"text");
+	CHECK(!points[0].z);
+	CHECK(points[1].x == -3 && points[1].z == 7);
+	CHECK(points[1].label.empty());
+}
+
+void
+test_field_lookup()
+{
+	Point point;
+	CHECK(point_binding.assign(point, adexml::bind::FieldKind::ATTRIBUTE, u8"x", u8"42") == std::error_code{});
+	CHECK(point.x == 42);
+	CHECK(!point_binding.assign(point, adexml::bind::FieldKind::ATTRIBUTE, u8"label", u8"no"));
+	CHECK(!point_binding.assign(point, adexml::bind::FieldKind::ELEMENT, u8"x", u8"1"));
+	CHECK(!point_binding.assign(point, adexml::bind::FieldKind::ATTRIBUTE, u8"missing", u8"1"));
+
+	Wide wide;
+	const char8_t * names[] = {u8"a", u8"b", u8"c", u8"d", u8"e", u8"f", u8"g", u8"h", u8"i", u8"j"};
+	int value = 1;
+	for(auto name : names)
+		CHECK(wide_binding.assign(wide, adexml::bind::FieldKind::ATTRIBUTE, name, u8(std::to_string(value++))) == std::error_code{});
+	CHECK(wide_binding.assign(wide, adexml::bind::FieldKind::ELEMENT, u8"a", u8"99") == std::error_code{});
+	CHECK(wide.a == 1 && wide.e == 5 && wide.j == 10 && wide.a_element == 99);
+}
+
+void
+test_conversion_error()
+{
+	std::vector<Point> points;
+	CHECK(read(point_binding, "<point x=\"one\"/>", points) == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(points.empty());
+}
+
+} // namespace
+
+int
+main()
+{
+	test_records();
+	test_field_lookup();
+	test_conversion_error();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,155 @@
+//=============================================================================
+//	FILE:					charset_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for the single-byte character sets and encoding
+//								selection
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <string>
+#include "adexml/charset.h"
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+using Parser = adexml::Parser;
+
+static_assert(adexml::charset::ISO_8859_1[0xE9] == U'é');
+static_assert(adexml::charset::ISO_8859_15[0xA4] == U'€');
+static_assert(adexml::charset::WINDOWS_1252[0x80] == U'€');
+
+void
+test_tables()
+{
+	for(std::uint32_t byte = 0; byte < 0x80; ++byte)
+	{
+		CHECK(adexml::charset::ISO_8859_1[byte] == byte);
+		CHECK(adexml::charset::ISO_8859_15[byte] == byte);
+		CHECK(adexml::charset::WINDOWS_1252[byte] == byte);
+	}
+
+	// Latin-9 differs from Latin-1 in exactly eight places.
+	int differences = 0;
+	for(std::uint32_t byte = 0; byte < 256; ++byte)
+		differences += (adexml::charset::ISO_8859_15[byte] != adexml::charset::ISO_8859_1[byte]);
+	CHECK(differences == 8);
+	CHECK(adexml::charset::ISO_8859_15[0xBD] == U'œ');
+
+	// Windows-1252 keeps Latin-1 from 0xA0 and maps its undefined bytes to C1.
+	for(std::uint32_t byte = 0xA0; byte < 256; ++byte)
+		CHECK(adexml::charset::WINDOWS_1252[byte] == byte);
+	for(std::uint32_t byte : {0x81, 0x8D, 0x8F, 0x90, 0x9D})
+		CHECK(adexml::charset::WINDOWS_1252[byte] == byte);
+	CHECK(adexml::charset::WINDOWS_1252[0x93] == U'“' && adexml::charset::WINDOWS_1252[0x9F] == U'Ÿ');
+}
+
+void
+test_names()
+{
+	CHECK(Parser::encoding_from_name(u8"UTF-8") == Parser::ENCODING_UTF8);
+	CHECK(Parser::encoding_from_name(u8"ISO-8859-1") == Parser::ENCODING_ISO_8859_1);
+	CHECK(Parser::encoding_from_name(u8"Latin1") == Parser::ENCODING_ISO_8859_1);
+	CHECK(Parser::encoding_from_name(u8"iso-8859-15") == Parser::ENCODING_ISO_8859_15);
+	CHECK(Parser::encoding_from_name(u8"Windows-1252") == Parser::ENCODING_WINDOWS_1252);
+	CHECK(Parser::encoding_from_name(u8"CP1252") == Parser::ENCODING_WINDOWS_1252);
+	CHECK(!Parser::encoding_from_name(u8"shift_jis"));
+	CHECK(!Parser::encoding_from_name(u8"utf-8 "));
+}
+
+//-----------------------------------------------------------------------------
+//	Element content and one attribute value, as UTF-8.
+//-----------------------------------------------------------------------------
+struct Decoded
+{
+	std::error_code		error;
+	std::u8string			content;
+	std::u8string			attribute;
+};
+
+Decoded
+decode(Parser & parser, std::string_view document)
+{
+	Decoded decoded;
+	parser.set_callback([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			if(action == Parser::ACTION_END_ELEMENT)
+			{
+				decoded.content = stack.back().content;
+				if(auto value = stack.back().attribute_view(u8"v"))
+					decoded.attribute = *value;
+			}
+			return {};
+		});
+	decoded.error = parser.write(u8(document));
+	if(!decoded.error)
+		decoded.error = parser.finish();
+	return decoded;
+}
+
+void
+test_declared_encoding()
+{
+	Parser parser(Parser::Callback{});
+
+	auto result = decode(parser, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?><a v=\"caf\xE9\">\xE0 la carte \xA4</a>");
+	CHECK(!result.error);
+	CHECK(result.content == u8"à la carte ¤");
+	CHECK(result.attribute == u8"café");
+	CHECK(parser.encoding() == Parser::ENCODING_ISO_8859_1);
+
+	// reset() goes back to UTF-8, the encoding set for the parser.
+	parser.reset();
+	CHECK(parser.encoding() == Parser::ENCODING_UTF8);
+	result = decode(parser, "<?xml version=\"1.0\" encoding=\"iso-8859-15\"?><a>\xA4\xBD</a>");
+	CHECK(result.content == u8"€œ");
+
+	parser.reset();
+	result = decode(parser, "<?xml version=\"1.0\" encoding=\"windows-1252\"?><a>\x93quoted\x94 \x80</a>");
+	CHECK(result.content == u8"“quoted” €");
+
+	// Unknown names are ignored and the document stays UTF-8.
+	parser.reset();
+	result = decode(parser, "<?xml version=\"1.0\" encoding=\"x-unknown\"?><a>caf\xC3\xA9</a>");
+	CHECK(!result.error && result.content == u8"café");
+}
+
+void
+test_set_encoding()
+{
+	Parser parser(Parser::Callback{});
+
+	parser.set_encoding(Parser::ENCODING_WINDOWS_1252);
+	auto result = decode(parser, "<a>\x80</a>");
+	CHECK(result.content == u8"€");
+
+	// A fixed encoding wins over the declaration.
+	parser.reset();
+	parser.set_encoding(Parser::ENCODING_ISO_8859_1, true);
+	result = decode(parser, "<?xml version=\"1.0\" encoding=\"UTF-8\"?><a>\xE9</a>");
+	CHECK(!result.error && result.content == u8"é");
+	parser.reset();
+	CHECK(parser.encoding() == Parser::ENCODING_ISO_8859_1);
+
+	parser.set_encoding(Parser::ENCODING_UTF8);
+	parser.reset();
+	result = decode(parser, "<a>\xE9</a>");
+	CHECK(result.error);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_tables();
+	test_names();
+	test_declared_encoding();
+	test_set_encoding();
+	return adexml::test::check_result();
+}
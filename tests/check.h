@@ -0,0 +1,63 @@
+//=============================================================================
+//	FILE:					check.h
+//	SYSTEM:
+//	DESCRIPTION:	Minimal checks for the adexml test programs
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Each test is a program that runs its checks and returns
+//		check_result() from main(), so a failed check fails the ctest run.
+//		A failed check is reported and the test carries on.
+//=============================================================================
+
+#ifndef GUARD_ADE_XML_TESTS_CHECK_H
+#define GUARD_ADE_XML_TESTS_CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace adexml::test
+{
+
+inline int &
+failures()
+{
+	static int count = 0;
+	return count;
+}
+
+inline void
+check(bool b_passed, const char * expression, const char * file, int line)
+{
+	if(!b_passed)
+	{
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+		++failures();
+	}
+}
+
+inline int
+check_result()
+{
+	if(failures() != 0)
+		std::fprintf(stderr, "%d check(s) failed\n", failures());
+	return (failures() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+inline std::u8string_view
+u8(std::string_view text)
+{
+	return {reinterpret_cast<const char8_t *>(text.data()), text.size()};
+}
+
+} // namespace adexml::test
+
+#define CHECK(...)	::adexml::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+#endif // ! defined GUARD_ADE_XML_TESTS_CHECK_H
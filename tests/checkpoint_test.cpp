@@ -0,0 +1,201 @@
+//=============================================================================
+//	FILE:					checkpoint_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for Parser::checkpoint() and restore()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		The document is split at every byte. The first part is written to one
+//		parser, which is checkpointed and thrown away, and the rest is written
+//		to a new parser restored from the checkpoint. The events seen must be
+//		the same as those of an uninterrupted parse, so every state, partial
+//		token and decoder is covered.
+//=============================================================================
+#include <memory>
+#include <string>
+#include "adexml/schema.h"
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view DOCUMENT =
+	"<?xml version=\"1.0\"?>\n"
+	"<!DOCTYPE doc [\n"
+	"  <!ELEMENT doc (item*)>\n"
+	"  <!ELEMENT item (#PCDATA)>\n"
+	"  <!ATTLIST item id ID #REQUIRED kind CDATA \"plain\" note CDATA #IMPLIED>\n"
+	"  <!ENTITY who \"caf\xC3\xA9 &amp; bar\">\n"
+	"]>\n"
+	"<doc>\n"
+	"  <item id=\"a\" note='&who;'>one &who; &#x263A;</item>\n"
+	"  <!-- comment -->\n"
+	"  <item id=\"b\"><![CDATA[<raw>]]>\xE2\x82\xAC</item>\n"
+	"</doc>";
+
+std::shared_ptr<const adexml::Schema>
+make_schema()
+{
+	adexml::Parser	parser(adexml::Parser::Callback{});
+	CHECK(!parser.write(u8(DOCUMENT)));
+	auto schema = adexml::Schema::compile(*parser.doctype());
+	return std::make_shared<const adexml::Schema>(std::move(*schema));
+}
+
+class Recorder
+{
+public:
+	std::u8string		events;
+
+	adexml::Parser::Callback
+	callback(const adexml::Parser & parser)
+	{
+		return [this, &parser](auto action, auto &, auto & stack) -> std::error_code
+			{
+				const auto & element = stack.back();
+				events.push_back(u8'|');
+				events.push_back(static_cast<char8_t>(u8'0' + action));
+				events.append(element.name);
+				events.push_back(u8':');
+				events.append(element.content);
+				for(auto name : {u8"kind", u8"note"})
+					if(auto value = element.attribute_view(name))
+						events.append(u8" ").append(name).append(u8"=").append(*value);
+				events.append(u8" @").append(u8(std::to_string(parser.location().line)));
+				return {};
+			};
+	}
+};
+
+void
+test_round_trip_at_every_offset()
+{
+	const auto input 	= u8(DOCUMENT);
+	const auto schema	= make_schema();
+
+	Recorder				whole;
+	adexml::Parser	reference(adexml::Parser::Callback{});
+	reference.set_callback(whole.callback(reference));
+	reference.set_schema(schema);
+	CHECK(!reference.write(input));
+	CHECK(!reference.finish());
+	CHECK(whole.events.find(u8" kind=plain note=caf\u00E9 & bar") != std::u8string::npos);
+
+	int failures = 0;
+	for(std::size_t split = 0; split <= input.size(); ++split)
+	{
+		Recorder				split_events;
+		adexml::Parser	first(adexml::Parser::Callback{});
+		first.set_callback(split_events.callback(first));
+		first.set_schema(schema);
+		if(first.write(input.substr(0, split)))
+		{
+			++failures;
+			continue;
+		}
+
+		auto checkpoint = first.checkpoint();
+		if(!checkpoint)
+		{
+			++failures;
+			continue;
+		}
+
+		adexml::Parser second(adexml::Parser::Callback{});
+		second.set_callback(split_events.callback(second));
+		second.set_schema(schema);
+		if(second.restore(*checkpoint) || (second.offset() != split) || second.write(input.substr(split)) || second.finish())
+			++failures;
+		else if(split_events.events != whole.events)
+			++failures;
+	}
+	CHECK(failures == 0);
+}
+
+void
+test_checkpoint_while_paused()
+{
+	adexml::Parser parser(adexml::Parser::Callback{});
+	int items = 0;
+	parser.set_callback([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			if((action == adexml::Parser::ACTION_START_ELEMENT) && (stack.back().name == u8"item"))
+			{
+				++items;
+				parser.pause();
+			}
+			return {};
+		});
+
+	const auto input 	= u8(DOCUMENT);
+	const auto result	= parser.write_some(input);
+	CHECK(parser.is_paused() && (items == 1));
+
+	auto checkpoint = parser.checkpoint();
+	CHECK(checkpoint.has_value());
+
+	adexml::Parser restored(adexml::Parser::Callback{});
+	restored.set_callback([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			items += (action == adexml::Parser::ACTION_START_ELEMENT) && (stack.back().name == u8"item");
+			return {};
+		});
+	CHECK(checkpoint && !restored.restore(*checkpoint));
+	CHECK(restored.offset() == result.consumed);
+	CHECK(!restored.write(input.substr(result.consumed)));
+	CHECK(!restored.finish());
+	CHECK(items == 2);
+}
+
+void
+test_invalid_checkpoints()
+{
+	adexml::Parser parser(adexml::Parser::Callback{});
+	CHECK(!parser.write(u8("<a><b x=\"1\">text")));
+	auto checkpoint = parser.checkpoint();
+	CHECK(checkpoint.has_value());
+	if(!checkpoint)
+		return;
+
+	adexml::Parser target(adexml::Parser::Callback{});
+	CHECK(target.restore({}) == adexml::Error::INVALID_CHECKPOINT);
+	CHECK(target.restore(std::span(*checkpoint).first(checkpoint->size() / 2)) == adexml::Error::INVALID_CHECKPOINT);
+
+	auto corrupt = *checkpoint;
+	corrupt[0] ^= std::byte{0xFF};
+	CHECK(target.restore(corrupt) == adexml::Error::INVALID_CHECKPOINT);
+
+	CHECK(!target.restore(*checkpoint));
+	CHECK(!target.write(u8("</b></a>")));
+	CHECK(!target.finish());
+
+	// Not from inside the callback of a write in progress.
+	std::error_code inside;
+	adexml::Parser busy(adexml::Parser::Callback{});
+	busy.set_callback([&](auto, auto &, auto &) -> std::error_code
+		{
+			if(auto result = busy.checkpoint(); !result)
+				inside = result.error();
+			return {};
+		});
+	CHECK(!busy.write(u8("<a/>")));
+	CHECK(inside == adexml::Error::INVALID_STATE);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_round_trip_at_every_offset();
+	test_checkpoint_while_paused();
+	test_invalid_checkpoints();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,135 @@
+//=============================================================================
+//	FILE:					columnar_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::ColumnExtractor and export_to_arrow()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <cstring>
+#include "adexml/columnar.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view ROWS =
+	"<rows>"
+		"<row id=\"1\" ok=\"true\"><name lang=\"en\">alpha</name><score>1.5</score></row>"
+		"<row id=\"2\"><score>-2</score></row>"
+		"<row id=\"3\" ok=\"false\"><name>gamma</name>note</row>"
+	"</rows>";
+
+const std::vector<adexml::ColumnSpec> SCHEMA =
+{
+	{u8"id",		u8"@id",				adexml::ColumnType::INT64},
+	{u8"ok",		u8"@ok",				adexml::ColumnType::BOOL},
+	{u8"name",	u8"name",				adexml::ColumnType::UTF8},
+	{u8"lang",	u8"name/@lang",	adexml::ColumnType::UTF8},
+	{u8"score",	u8"score",			adexml::ColumnType::FLOAT64},
+	{u8"text",	u8".",					adexml::ColumnType::UTF8}
+};
+
+adexml::ColumnTable
+extract(std::string_view document)
+{
+	adexml::ColumnExtractor extractor(u8"/rows/row", SCHEMA);
+	adexml::Parser parser(extractor.callback());
+	CHECK(!parser.write(u8(document)));
+	CHECK(!parser.finish());
+	return extractor.take();
+}
+
+void
+test_columns()
+{
+	const auto table = extract(ROWS);
+	CHECK(table.rows == 3);
+	CHECK(table.columns.size() == SCHEMA.size());
+	if(table.columns.size() != SCHEMA.size())
+		return;
+
+	const auto & id = table.columns[0];
+	CHECK(id.size() == 3 && id.null_count() == 0);
+	CHECK(id.int64_values()[0] == 1 && id.int64_values()[2] == 3);
+
+	const auto & ok = table.columns[1];
+	CHECK(ok.null_count() == 1);
+	CHECK(ok.is_valid(0) && ok.bool_value(0));
+	CHECK(!ok.is_valid(1));
+	CHECK(ok.is_valid(2) && !ok.bool_value(2));
+
+	const auto & name = table.columns[2];
+	CHECK(name.string_value(0) == u8"alpha");
+	CHECK(!name.is_valid(1) && name.string_value(1).empty());
+	CHECK(name.string_value(2) == u8"gamma");
+
+	const auto & lang = table.columns[3];
+	CHECK(lang.null_count() == 2 && lang.string_value(0) == u8"en");
+
+	const auto & score = table.columns[4];
+	CHECK(score.float64_values()[0] == 1.5 && score.float64_values()[1] == -2.0);
+	CHECK(!score.is_valid(2));
+
+	const auto & text = table.columns[5];
+	CHECK(text.string_value(2) == u8"note");
+}
+
+void
+test_conversion_error()
+{
+	adexml::ColumnExtractor extractor(u8"rows/row", SCHEMA);
+	adexml::Parser parser(extractor.callback());
+	CHECK(parser.write(u8("<rows><row id=\"x\"/></rows>")) == adexml::Error::VALUE_CONVERSION_ERROR);
+}
+
+void
+test_arrow_export()
+{
+	ArrowArray	array{};
+	ArrowSchema	schema{};
+	adexml::export_to_arrow(extract(ROWS), &array, &schema);
+
+	CHECK(std::strcmp(schema.format, "+s") == 0);
+	CHECK(schema.n_children == static_cast<std::int64_t>(SCHEMA.size()));
+	CHECK(array.length == 3 && array.n_children == schema.n_children);
+	if(array.n_children != static_cast<std::int64_t>(SCHEMA.size()))
+		return;
+
+	CHECK(std::strcmp(schema.children[0]->name, "id") == 0);
+	CHECK(std::strcmp(schema.children[0]->format, "l") == 0);
+	CHECK(std::strcmp(schema.children[2]->format, "u") == 0);
+
+	const ArrowArray * id = array.children[0];
+	CHECK(id->length == 3 && id->null_count == 0 && id->n_buffers == 2);
+	CHECK(static_cast<const std::int64_t *>(id->buffers[1])[1] == 2);
+
+	const ArrowArray * name = array.children[2];
+	CHECK(name->n_buffers == 3 && name->null_count == 1);
+	const auto * offsets 	= static_cast<const std::int32_t *>(name->buffers[1]);
+	const auto * bytes		= static_cast<const char *>(name->buffers[2]);
+	CHECK(std::string_view(bytes + offsets[2], offsets[3] - offsets[2]) == "gamma");
+
+	// Children outlive the parent array once moved out of it.
+	ArrowArray child = *array.children[4];
+	array.children[4]->release = nullptr;
+	array.release(&array);
+	CHECK(static_cast<const double *>(child.buffers[1])[0] == 1.5);
+	child.release(&child);
+	schema.release(&schema);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_columns();
+	test_conversion_error();
+	test_arrow_export();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,115 @@
+//=============================================================================
+//	FILE:					compact_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for Parser compact mode and Parser::memory_usage()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		The footprint targets are for an idle parser, one per connection, so
+//		the object and everything it holds between documents must stay under
+//		256 bytes.
+//=============================================================================
+#include <string>
+#include "adexml/memory.h"
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+std::string
+make_document()
+{
+	std::string document = "<root>";
+	for(int i = 0; i < 50; ++i)
+		document += "<item name=\"" + std::string(100, 'n') + "\">" + std::string(200, 't') + "</item>";
+	return document + "</root>";
+}
+
+void
+test_idle_footprint()
+{
+	// The statistics counters enlarge the parser, so the size bound only
+	// holds in the default configuration.
+#if !ADEXML_ENABLE_STATS
+	CHECK(sizeof(adexml::Parser) < 256);
+#endif
+
+	adexml::Parser parser(adexml::Parser::Callback{});
+	parser.set_compact(true);
+	const auto usage = parser.memory_usage();
+	CHECK(usage.object_bytes == sizeof(adexml::Parser));
+	CHECK(usage.scratch_bytes == 0);
+	CHECK(usage.heap_bytes == 0);
+#if !ADEXML_ENABLE_STATS
+	CHECK(usage.total() < 256);
+#endif
+}
+
+void
+test_compact_releases_buffers()
+{
+	const auto document = make_document();
+
+	int ends = 0;
+	adexml::Parser parser([&](auto action, auto &, auto &) -> std::error_code
+		{
+			ends += (action == adexml::Parser::ACTION_END_ELEMENT);
+			return {};
+		});
+	parser.set_compact(true);
+	CHECK(parser.is_compact());
+
+	// Write up to the middle of the second item's content; a token is in flight.
+	const auto split = document.find("</item>") + 20;
+	CHECK(!parser.write(u8(document).substr(0, split)));
+	const auto busy = parser.memory_usage();
+	CHECK(busy.scratch_bytes > 0);
+	CHECK(busy.heap_bytes > 0);
+
+	CHECK(!parser.write(u8(document).substr(split)));
+	CHECK(!parser.finish());
+	CHECK(ends == 51);
+
+	const auto idle = parser.memory_usage();
+	CHECK(idle.scratch_bytes == 0);
+	parser.shrink_to_fit();
+	CHECK(parser.memory_usage().total() < busy.total());
+}
+
+void
+test_resource_accounting()
+{
+	const auto document = make_document();
+
+	adexml::CountingResource counter;
+	{
+		adexml::Parser parser(adexml::Parser::Callback{}, &counter);
+		CHECK(parser.resource() == &counter);
+		CHECK(!parser.write(u8(document)));
+
+		// Everything the parser holds came from the caller's resource.
+		const auto usage = parser.memory_usage();
+		CHECK(counter.in_use() > 0);
+		CHECK(usage.scratch_bytes + usage.heap_bytes == counter.in_use());
+		CHECK(!parser.finish());
+	}
+	CHECK(counter.in_use() == 0);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_idle_footprint();
+	test_compact_releases_buffers();
+	test_resource_accounting();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,114 @@
+//=============================================================================
+//	FILE:					convert_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::parse_value() and the typed attribute
+//								accessors of adexml::Element
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <array>
+#include <cstdint>
+#include "adexml/convert.h"
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+enum class Colour : int
+{
+	RED 	= 1,
+	GREEN	= 2
+};
+
+template<typename T>
+bool
+converts(std::u8string_view text, T expected)
+{
+	T value{};
+	return !adexml::parse_value(text, value) && (value == expected);
+}
+
+template<typename T>
+std::error_code
+convert_error(std::u8string_view text)
+{
+	T value{};
+	return adexml::parse_value(text, value);
+}
+
+void
+test_numbers()
+{
+	CHECK(converts<int>(u8"42", 42));
+	CHECK(converts<int>(u8" -7\n", -7));
+	CHECK(converts<int>(u8"+5", 5));
+	CHECK(converts<double>(u8"+.5", 0.5));
+	CHECK(converts<double>(u8"1e3", 1000.0));
+	CHECK(converts<std::uint8_t>(u8"255", 255));
+
+	CHECK(convert_error<int>(u8"") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(convert_error<int>(u8"+") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(convert_error<int>(u8"+-5") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(convert_error<int>(u8"++5") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(convert_error<int>(u8"+.5") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(convert_error<int>(u8"12abc") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(convert_error<double>(u8"+-1.0") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(convert_error<std::uint8_t>(u8"256") == adexml::Error::VALUE_OUT_OF_RANGE);
+	CHECK(convert_error<unsigned>(u8"-1") == adexml::Error::VALUE_CONVERSION_ERROR);
+}
+
+void
+test_other_types()
+{
+	CHECK(converts<bool>(u8"true", true));
+	CHECK(converts<bool>(u8" 0 ", false));
+	CHECK(convert_error<bool>(u8"yes") == adexml::Error::VALUE_CONVERSION_ERROR);
+	CHECK(converts<Colour>(u8"2", Colour::GREEN));
+	CHECK(converts<std::u8string>(u8" kept as is ", std::u8string(u8" kept as is ")));
+	CHECK(converts<std::optional<int>>(u8"3", std::optional<int>(3)));
+}
+
+void
+test_element_accessors()
+{
+	adexml::Element element;
+	element.attributes.emplace(u8"count", u8"12");
+	element.attributes.emplace(u8"ratio", u8"0.25");
+	element.attributes.emplace(u8"colour", u8"red");
+	element.attributes.emplace(u8"bad", u8"x");
+
+	CHECK(element.attribute_view(u8"count") == std::u8string_view(u8"12"));
+	CHECK(!element.attribute_view(u8"missing"));
+	CHECK(element.attribute_as<int>(u8"count") == 12);
+	CHECK(element.attribute_as<int>(u8"missing").error() == adexml::Error::ATTRIBUTE_NOT_FOUND);
+	CHECK(element.attribute_as<int>(u8"bad").error() == adexml::Error::VALUE_CONVERSION_ERROR);
+
+	constexpr std::array<std::pair<std::u8string_view, Colour>, 2> COLOURS{{{u8"red", Colour::RED}, {u8"green", Colour::GREEN}}};
+	CHECK(element.attribute_as<Colour>(u8"colour", COLOURS) == Colour::RED);
+	CHECK(!element.attribute_as<Colour>(u8"bad", COLOURS));
+
+	int										count = 0;
+	double								ratio = 0.0;
+	std::optional<int>		absent;
+	CHECK(!element.extract(adexml::attr(u8"count", count), adexml::attr(u8"ratio", ratio), adexml::attr(u8"absent", absent)));
+	CHECK(count == 12 && ratio == 0.25 && !absent);
+
+	int required = 0;
+	CHECK(element.extract(adexml::attr(u8"count", count), adexml::attr(u8"required", required)) == adexml::Error::ATTRIBUTE_NOT_FOUND);
+	CHECK(element.extract(adexml::attr(u8"bad", required)) == adexml::Error::VALUE_CONVERSION_ERROR);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_numbers();
+	test_other_types();
+	test_element_accessors();
+	return adexml::test::check_result();
+}
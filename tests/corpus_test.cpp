@@ -0,0 +1,75 @@
+//=============================================================================
+//	FILE:					corpus_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for the benchmark corpus generator
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Benchmark results are only comparable if every run parses the same
+//		bytes, so the generator must be deterministic, and every corpus must
+//		parse under the untrusted limits that some configurations use.
+//=============================================================================
+#include <string>
+#include "adexml/xml_parser.h"
+#include "bench/corpus.h"
+#include "check.h"
+
+namespace
+{
+
+constexpr std::size_t SIZE = 64 * 1024;
+
+void
+test_names()
+{
+	for(auto corpus : adexml::bench::ALL_CORPORA)
+		CHECK(adexml::bench::corpus_from_name(adexml::bench::corpus_name(corpus)) == corpus);
+	CHECK(!adexml::bench::corpus_from_name("unknown"));
+}
+
+void
+test_deterministic()
+{
+	for(auto corpus : adexml::bench::ALL_CORPORA)
+	{
+		const auto document = adexml::bench::generate_corpus(corpus, SIZE, 7);
+		CHECK(document == adexml::bench::generate_corpus(corpus, SIZE, 7));
+		CHECK(document.size() >= SIZE);
+	}
+	CHECK(adexml::bench::generate_corpus(adexml::bench::Corpus::RECORDS, SIZE, 1) != adexml::bench::generate_corpus(adexml::bench::Corpus::RECORDS, SIZE, 2));
+}
+
+void
+test_parses_under_untrusted_limits()
+{
+	for(auto corpus : adexml::bench::ALL_CORPORA)
+	{
+		std::size_t			elements = 0;
+		adexml::Parser	parser([&](auto action, auto &, auto &) -> std::error_code
+			{
+				elements += (action == adexml::Parser::ACTION_START_ELEMENT);
+				return {};
+			});
+		parser.set_limits(adexml::Parser::Limits::untrusted());
+
+		const auto document = adexml::bench::generate_corpus(corpus, SIZE);
+		CHECK(!parser.write(document));
+		CHECK(!parser.finish());
+		CHECK(elements > 0);
+	}
+}
+
+} // namespace
+
+int
+main()
+{
+	test_names();
+	test_deterministic();
+	test_parses_under_untrusted_limits();
+	return adexml::test::check_result();
+}
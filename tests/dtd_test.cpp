@@ -0,0 +1,163 @@
+//=============================================================================
+//	FILE:					dtd_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for DOCTYPE parsing and entity expansion
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <string>
+#include "adexml/dtd.h"
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+struct Result
+{
+	std::error_code		error;
+	std::u8string			content;
+	std::u8string			attribute;
+};
+
+Result
+parse(std::string_view document)
+{
+	Result result;
+	adexml::Parser parser([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			if((action == adexml::Parser::ACTION_END_ELEMENT) && (stack.size() == 1))
+				result.content = stack.back().content;
+			if((action == adexml::Parser::ACTION_START_ELEMENT) && (stack.size() == 1))
+				if(auto value = stack.back().attribute_view(u8"v"))
+					result.attribute = *value;
+			return {};
+		});
+	result.error = parser.write(u8(document));
+	if(!result.error)
+		result.error = parser.finish();
+	return result;
+}
+
+void
+test_declarations()
+{
+	adexml::Doctype doctype;
+	CHECK(!adexml::parse_doctype(u8(
+		" book PUBLIC \"-//Example//Book\" \"book.dtd\" ["
+			"<!ELEMENT book (title, chapter*)>"
+			"<!ELEMENT title (#PCDATA)>"
+			"<!ATTLIST book lang CDATA #IMPLIED kind (novel|poem) \"novel\" id ID #REQUIRED>"
+			"<!ENTITY author \"A. Writer\">"
+			"<!ENTITY % param \"ignored\">"
+			"<!-- a comment -->"
+		"] "), doctype));
+
+	CHECK(doctype.name == u8"book");
+	CHECK(doctype.public_id == u8"-//Example//Book");
+	CHECK(doctype.system_id == u8"book.dtd");
+	CHECK(doctype.elements.size() == 2);
+	CHECK(doctype.elements.size() == 2 && doctype.elements[0].content == u8"(title, chapter*)");
+	CHECK(doctype.entities.size() == 1 && doctype.entities.contains(u8"author"));
+
+	CHECK(doctype.attributes.size() == 3);
+	if(doctype.attributes.size() == 3)
+	{
+		const auto & kind = doctype.attributes[1];
+		CHECK(kind.element == u8"book" && kind.name == u8"kind");
+		CHECK(kind.type == adexml::AttributeType::ENUMERATION);
+		CHECK(kind.values.size() == 2 && kind.presence == adexml::AttributeDefault::VALUE && kind.value == u8"novel");
+		CHECK(doctype.attributes[2].type == adexml::AttributeType::ID);
+		CHECK(doctype.attributes[2].presence == adexml::AttributeDefault::REQUIRED);
+	}
+
+	adexml::Doctype broken;
+	CHECK(adexml::parse_declarations(u8("<!ENTITY unterminated \"value>"), broken));
+}
+
+void
+test_expansion()
+{
+	const auto result = parse(
+		"<!DOCTYPE a ["
+			"<!ENTITY inner \"in&amp;ner\">"
+			"<!ENTITY outer \"[&inner;]\">"
+			"<!ENTITY first \"1\">"
+			"<!ENTITY first \"2\">"
+		"]>"
+		"<a v=\"&outer;&first;\">&outer; &first;</a>");
+
+	CHECK(!result.error);
+	CHECK(result.content == u8"[in&ner] 1");
+	CHECK(result.attribute == u8"[in&ner]1");
+
+	adexml::Parser parser(adexml::Parser::Callback{});
+	CHECK(!parser.write(u8("<!DOCTYPE a SYSTEM \"a.dtd\"><a/>")));
+	CHECK(parser.doctype() && parser.doctype()->system_id == u8"a.dtd");
+	parser.reset();
+	CHECK(!parser.doctype());
+
+	// Entities can be declared before the document is written.
+	parser.entities().declare(u8"name", u8"value");
+	std::u8string content;
+	parser.set_callback([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			if(action == adexml::Parser::ACTION_END_ELEMENT)
+				content = stack.back().content;
+			return {};
+		});
+	CHECK(!parser.write(u8("<a>&name;</a>")));
+	CHECK(content == u8"value");
+}
+
+void
+test_subset_markup()
+{
+	// Brackets, quotes and '>' inside comments and processing instructions
+	// do not end the internal subset.
+	auto result = parse("<!DOCTYPE r [<?pi x]?><!ENTITY e \"v\">]><r>&e;</r>");
+	CHECK(!result.error);
+	CHECK(result.content == u8"v");
+
+	result = parse("<!DOCTYPE r [<!-- ]> --><?pi '>?><!ENTITY e \"w\">]><r>&e;</r>");
+	CHECK(!result.error);
+	CHECK(result.content == u8"w");
+}
+
+void
+test_bad_entities()
+{
+	CHECK(parse("<a>&undeclared;</a>").error == adexml::Error::UNKNOWN_ENTITY);
+	CHECK(parse("<!DOCTYPE a [<!ENTITY x \"&y;\"><!ENTITY y \"&x;\">]><a>&x;</a>").error == adexml::Error::RECURSIVE_ENTITY);
+	CHECK(parse("<!DOCTYPE a [<!ENTITY e SYSTEM \"file.txt\">]><a>&e;</a>").error == adexml::Error::UNKNOWN_ENTITY);
+
+	// Billion laughs is stopped by the default limits.
+	std::string laughs = "<!DOCTYPE a [<!ENTITY l0 \"lol\">";
+	for(int i = 1; i < 10; ++i)
+	{
+		const auto previous = "&l" + std::to_string(i - 1) + ";";
+		laughs += "<!ENTITY l" + std::to_string(i) + " \"";
+		for(int j = 0; j < 10; ++j)
+			laughs += previous;
+		laughs += "\">";
+	}
+	laughs += "]><a>&l9;</a>";
+	CHECK(parse(laughs).error == adexml::Error::ENTITY_LIMIT_EXCEEDED);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_declarations();
+	test_expansion();
+	test_subset_markup();
+	test_bad_entities();
+	return adexml::test::check_result();
+}
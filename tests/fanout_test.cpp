@@ -0,0 +1,153 @@
+//=============================================================================
+//	FILE:					fanout_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::FanOut
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <chrono>
+#include <string>
+#include <thread>
+#include "adexml/fanout.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+std::string
+make_document()
+{
+	std::string document = "<root>";
+	for(int i = 0; i < 1000; ++i)
+		document += "<item n=\"" + std::to_string(i) + "\"><value>" + std::to_string(i * 3) + "</value></item>";
+	return document + "</root>";
+}
+
+//-----------------------------------------------------------------------------
+//	Sums the values and checks that every <value> arrives inside an <item>
+//	with the path the parser gave it.
+//-----------------------------------------------------------------------------
+struct Summer
+{
+	std::uint64_t		sum 				= 0;
+	std::uint64_t		events			= 0;
+	bool						b_bad_stack	= false;
+
+	adexml::Parser::Callback
+	callback()
+	{
+		return [this](auto action, auto & path, auto & stack) -> std::error_code
+			{
+				++events;
+				if((action == adexml::Parser::ACTION_END_ELEMENT) && (stack.back().name == u8"value"))
+				{
+					if((stack.size() != 3) || (path != u8"root/item/value") || !stack[1].attribute_view(u8"n"))
+						b_bad_stack = true;
+					sum += std::stoull(std::string(stack.back().content.begin(), stack.back().content.end()));
+				}
+				return {};
+			};
+	}
+};
+
+constexpr std::uint64_t	EXPECTED_SUM		= 3 * 999 * 1000 / 2;
+constexpr std::uint64_t	EXPECTED_EVENTS	= 2 * (1 + 2 * 1000);
+
+void
+test_every_consumer_sees_every_event()
+{
+	const auto document = make_document();
+
+	Summer					summers[3];
+	adexml::FanOut	fanout({.batch_events = 64});
+	for(auto & summer : summers)
+		fanout.add_consumer(summer.callback(), {.queue_batches = 2});
+	CHECK(fanout.consumer_count() == 3);
+
+	adexml::Parser parser(fanout.callback());
+	const auto input = u8(document);
+	for(std::size_t i = 0; i < input.size(); i += 1000)
+		CHECK(!parser.write(input.substr(i, 1000)));
+	CHECK(!parser.finish());
+
+	const auto results = fanout.finish();
+	CHECK(results.size() == 3);
+	for(auto & result : results)
+		CHECK(!result.error && (result.delivered_events == EXPECTED_EVENTS) && (result.dropped_events == 0));
+	for(auto & summer : summers)
+		CHECK(!summer.b_bad_stack && (summer.sum == EXPECTED_SUM) && (summer.events == EXPECTED_EVENTS));
+}
+
+void
+test_slow_consumer_drops()
+{
+	const auto document = make_document();
+
+	Summer					fast;
+	Summer					slow;
+	auto						slow_callback = slow.callback();
+	adexml::FanOut	fanout({.batch_events = 16});
+	fanout.add_consumer(fast.callback());
+	fanout.add_consumer([&](auto action, auto & path, auto & stack) -> std::error_code
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+			return slow_callback(action, path, stack);
+		}, {.queue_batches = 1, .backpressure = adexml::Backpressure::DROP});
+
+	adexml::Parser parser(fanout.callback());
+	CHECK(!parser.write(u8(document)));
+	CHECK(!parser.finish());
+	const auto results = fanout.finish();
+
+	CHECK(results.size() == 2);
+	if(results.size() != 2)
+		return;
+	CHECK(results[0].delivered_events == EXPECTED_EVENTS && fast.sum == EXPECTED_SUM);
+	CHECK(results[1].dropped_events > 0);
+	CHECK(results[1].delivered_events + results[1].dropped_events == EXPECTED_EVENTS);
+
+	// Missed batches do not leave the slow consumer with a wrong stack.
+	CHECK(!results[1].error && !slow.b_bad_stack);
+	CHECK(slow.events == results[1].delivered_events);
+}
+
+void
+test_failed_consumer_stops_alone()
+{
+	const auto document = make_document();
+
+	Summer					healthy;
+	std::uint64_t		seen = 0;
+	adexml::FanOut	fanout({.batch_events = 32});
+	fanout.add_consumer([&](auto, auto &, auto &) -> std::error_code
+		{
+			return (++seen == 100) ? adexml::Error::FAILED : std::error_code{};
+		});
+	fanout.add_consumer(healthy.callback());
+
+	adexml::Parser parser(fanout.callback());
+	CHECK(!parser.write(u8(document)));
+	CHECK(!parser.finish());
+	const auto results = fanout.finish();
+
+	CHECK(results.size() == 2);
+	CHECK(results.size() == 2 && results[0].error == adexml::Error::FAILED);
+	CHECK(seen == 100);
+	CHECK(healthy.sum == EXPECTED_SUM);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_every_consumer_sees_every_event();
+	test_slow_consumer_drops();
+	test_failed_consumer_stops_alone();
+	return adexml::test::check_result();
+}
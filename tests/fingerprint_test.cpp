@@ -0,0 +1,127 @@
+//=============================================================================
+//	FILE:					fingerprint_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for subtree fingerprints
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <map>
+#include <string>
+#include "adexml/fingerprint.h"
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view ORIGINAL =
+	"<orders><order id=\"1\" status=\"open\"><line sku=\"A\">two  words</line><line sku=\"B\"/></order>"
+	"<order id=\"2\"><line sku=\"C\">x</line></order></orders>";
+
+//-----------------------------------------------------------------------------
+//	The fingerprint of each element by path and id, taken at its END (or its
+//	START when self-closed), and of the whole document.
+//-----------------------------------------------------------------------------
+std::map<std::u8string, std::uint64_t>
+fingerprints(std::string_view document)
+{
+	std::map<std::u8string, std::uint64_t> out;
+	adexml::Parser parser([&](auto action, auto & path, auto & stack) -> std::error_code
+		{
+			const auto & element = stack.back();
+			if((action == adexml::Parser::ACTION_END_ELEMENT) || ((action == adexml::Parser::ACTION_START_ELEMENT) && element.b_closed))
+			{
+				std::u8string key(path);
+				if(auto id = element.attribute_view(u8"id"))
+					key.append(u8"#").append(*id);
+				out[key] = element.fingerprint;
+			}
+			return {};
+		});
+	parser.set_fingerprints(true);
+	CHECK(parser.fingerprints());
+	CHECK(!parser.write(u8(document)));
+	CHECK(!parser.finish());
+	return out;
+}
+
+void
+test_reformatting_is_ignored()
+{
+	const auto original = fingerprints(ORIGINAL);
+	CHECK(original.size() == 4);
+
+	const auto reformatted = fingerprints(
+		"<?xml version=\"1.0\"?>\n"
+		"<orders>\n"
+		"  <!-- first -->\n"
+		"  <order status=\"open\" id=\"1\">\n"
+		"    <line sku=\"A\">  two\n\twords </line>\n"
+		"    <line sku=\"B\"></line>\n"
+		"  </order>\n"
+		"  <order id=\"2\"><line sku=\"C\">x</line></order>\n"
+		"</orders>\n");
+	CHECK(reformatted == original);
+}
+
+void
+test_changes_are_detected()
+{
+	const auto original = fingerprints(ORIGINAL);
+	const auto changed 	= fingerprints(
+		"<orders><order id=\"1\" status=\"closed\"><line sku=\"A\">two  words</line><line sku=\"B\"/></order>"
+		"<order id=\"2\"><line sku=\"C\">x</line></order></orders>");
+
+	// Only the changed record and its ancestors differ.
+	CHECK(changed.at(u8"orders/order#1") != original.at(u8"orders/order#1"));
+	CHECK(changed.at(u8"orders") != original.at(u8"orders"));
+	CHECK(changed.at(u8"orders/order#2") == original.at(u8"orders/order#2"));
+
+	const char * variants[] =
+	{
+		"<orders><order id=\"1\" status=\"open\"><line sku=\"B\"/><line sku=\"A\">two  words</line></order><order id=\"2\"><line sku=\"C\">x</line></order></orders>",
+		"<orders><order id=\"1\" status=\"open\"><line sku=\"A\">two words.</line><line sku=\"B\"/></order><order id=\"2\"><line sku=\"C\">x</line></order></orders>",
+		"<orders><order id=\"1\" status=\"open\"><item sku=\"A\">two  words</item><line sku=\"B\"/></order><order id=\"2\"><line sku=\"C\">x</line></order></orders>",
+		"<orders><order id=\"1\" status=\"open\"><line sku=\"A\">two  words</line></order><order id=\"2\"><line sku=\"C\">x</line></order></orders>"
+	};
+	for(auto variant : variants)
+		CHECK(fingerprints(variant).at(u8"orders/order#1") != original.at(u8"orders/order#1"));
+}
+
+void
+test_streaming_hash()
+{
+	const std::u8string text = u8"The quick brown fox jumps over the lazy dog";
+
+	adexml::Fingerprint whole;
+	whole.update(text);
+
+	for(std::size_t split = 0; split <= text.size(); ++split)
+	{
+		adexml::Fingerprint pieces;
+		pieces.update(std::u8string_view(text).substr(0, split));
+		pieces.update(std::u8string_view(text).substr(split));
+		CHECK(pieces.value() == whole.value());
+	}
+
+	adexml::Fingerprint seeded(1);
+	seeded.update(text);
+	CHECK(seeded.value() != whole.value());
+	CHECK(adexml::combine_fingerprints(adexml::combine_fingerprints(0, 1), 2) != adexml::combine_fingerprints(adexml::combine_fingerprints(0, 2), 1));
+}
+
+} // namespace
+
+int
+main()
+{
+	test_reformatting_is_ignored();
+	test_changes_are_detected();
+	test_streaming_hash();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,222 @@
+//=============================================================================
+//	FILE:					incremental_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::IncrementalDocument
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		After an edit the tree is compared with a document loaded from the
+//		edited text, which checks that merging the reparsed subtree and
+//		shifting the offsets around it give the same tree a full parse does.
+//=============================================================================
+#include <algorithm>
+#include <string>
+#include "adexml/incremental.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+using Document 	= adexml::IncrementalDocument;
+using NodeId		= Document::NodeId;
+
+constexpr std::string_view TEXT =
+	"<!DOCTYPE doc [<!ENTITY e \"entity\">]>\n"
+	"<doc>\n"
+	"  <head title=\"t\">Heading</head>\n"
+	"  <body>\n"
+	"    <p id=\"1\">First &e;</p>\n"
+	"    <p id=\"2\">Second</p>\n"
+	"  </body>\n"
+	"  <foot/>\n"
+	"</doc>\n";
+
+//-----------------------------------------------------------------------------
+//	Everything about a subtree except node ids, with absolute offsets.
+//-----------------------------------------------------------------------------
+std::u8string
+describe(const Document & document, NodeId id)
+{
+	const auto & node = document.node(id);
+	std::u8string out = node.name;
+	for(auto & [name, value] : node.attributes)
+		out.append(u8" ").append(name).append(u8"=").append(value);
+	out.append(u8" [").append(node.content).append(u8"] ");
+	out.append(u8(std::to_string(document.begin(id)) + "-" + std::to_string(document.end(id))));
+	out.append(u8" {");
+	for(auto child : node.children)
+	{
+		if(document.node(child).parent != id)
+			out.append(u8"BAD PARENT ");
+		out.append(describe(document, child));
+	}
+	out.append(u8"}");
+	return out;
+}
+
+bool
+matches_full_parse(const Document & document)
+{
+	Document fresh;
+	if(fresh.load(std::u8string(document.text())))
+		return false;
+	return describe(document, document.root()) == describe(fresh, fresh.root());
+}
+
+//-----------------------------------------------------------------------------
+//	The first node in document order with the name (and "id" attribute).
+//-----------------------------------------------------------------------------
+NodeId
+find(const Document & document, std::u8string_view name, std::u8string_view id = {}, NodeId from = Document::NO_NODE)
+{
+	if(from == Document::NO_NODE)
+		from = document.root();
+
+	const auto & node = document.node(from);
+	if((node.name == name) && (id.empty() || std::ranges::any_of(node.attributes, [&](auto & a) {return a.first == u8"id" && a.second == id;})))
+		return from;
+	for(auto child : node.children)
+		if(auto found = find(document, name, id, child); found != Document::NO_NODE)
+			return found;
+	return Document::NO_NODE;
+}
+
+std::uint64_t
+offset_of(const Document & document, std::string_view text)
+{
+	return document.text().find(u8(text));
+}
+
+void
+test_load()
+{
+	Document document;
+	CHECK(!document.load(std::u8string(u8(TEXT))));
+	CHECK(document.is_valid());
+	CHECK(document.node_count() == 6);
+	CHECK(document.node(document.root()).name == u8"doc");
+
+	const auto first = find(document, u8"p", u8"1");
+	CHECK(document.node(first).content == u8"First entity");
+	CHECK(document.text().substr(document.begin(first), document.node(first).length) == u8"<p id=\"1\">First &e;</p>");
+	CHECK(matches_full_parse(document));
+}
+
+void
+test_edit_inside_element()
+{
+	Document document;
+	CHECK(!document.load(std::u8string(u8(TEXT))));
+	const auto first 	= find(document, u8"p", u8"1");
+	const auto second	= find(document, u8"p", u8"2");
+	const auto foot		= find(document, u8"foot");
+	const auto foot_at	= document.begin(foot);
+
+	const auto result = document.edit({.offset = offset_of(document, "First") + 5, .removed = 0, .inserted = u8" and longer"});
+	CHECK(!result.error);
+	CHECK(result.reparsed == first);
+	CHECK(result.reparsed_bytes < 40);
+	CHECK(result.changed == std::vector<NodeId>{first});
+	CHECK(result.added.empty() && result.removed.empty());
+
+	// Ids are kept and later nodes move.
+	CHECK(document.node(first).content == u8"First and longer entity");
+	CHECK(find(document, u8"p", u8"2") == second);
+	CHECK(document.begin(foot) == foot_at + 11);
+	CHECK(matches_full_parse(document));
+}
+
+void
+test_edit_structure()
+{
+	Document document;
+	CHECK(!document.load(std::u8string(u8(TEXT))));
+	const auto body 	= find(document, u8"body");
+	const auto second	= find(document, u8"p", u8"2");
+
+	// A new child is confined to its parent.
+	auto result = document.edit({.offset = offset_of(document, "Second"), .removed = 0, .inserted = u8"<b>bold</b>"});
+	CHECK(!result.error);
+	CHECK(result.reparsed == second);
+	CHECK(result.added.size() == 1);
+	CHECK(result.changed == std::vector<NodeId>{second});
+	CHECK(matches_full_parse(document));
+
+	// Splitting <p> in two cannot be confined to it, so <body> is reparsed.
+	result = document.edit({.offset = offset_of(document, "Second"), .removed = 0, .inserted = u8"</p><p id=\"3\">"});
+	CHECK(!result.error);
+	CHECK(result.reparsed == body);
+	CHECK(find(document, u8"p", u8"3") != Document::NO_NODE);
+	CHECK(matches_full_parse(document));
+
+	// Removing the first paragraph removes its node.
+	const auto first 	= find(document, u8"p", u8"1");
+	const auto begin	= document.begin(first);
+	result = document.edit({.offset = begin, .removed = document.end(first) - begin, .inserted = {}});
+	CHECK(!result.error);
+	CHECK(result.removed == std::vector<NodeId>{first});
+	CHECK(matches_full_parse(document));
+
+	// Changing the DOCTYPE parses in full and picks up the new entity text.
+	result = document.edit({.offset = offset_of(document, "entity\""), .removed = 6, .inserted = u8"ENTITY"});
+	CHECK(!result.error);
+	CHECK(matches_full_parse(document));
+}
+
+void
+test_malformed_edit()
+{
+	Document document;
+	CHECK(!document.load(std::u8string(u8(TEXT))));
+	const auto close = offset_of(document, "</head>");
+
+	auto result = document.edit({.offset = close, .removed = 1, .inserted = {}});
+	CHECK(result.error);
+	CHECK(!document.is_valid());
+	CHECK(document.node(find(document, u8"head")).content == u8"Heading");
+
+	result = document.edit({.offset = close, .removed = 0, .inserted = u8"<"});
+	CHECK(!result.error);
+	CHECK(document.is_valid());
+	CHECK(document.text() == u8(TEXT));
+	CHECK(matches_full_parse(document));
+}
+
+void
+test_insert_everywhere()
+{
+	Document document;
+	CHECK(!document.load(std::u8string(u8(TEXT))));
+
+	int mismatches = 0;
+	const auto root_begin = offset_of(document, "<doc>");
+	for(std::uint64_t offset = root_begin; offset <= TEXT.size(); ++offset)
+	{
+		auto result = document.edit({.offset = offset, .removed = 0, .inserted = u8"x"});
+		if(!result.error && !matches_full_parse(document))
+			++mismatches;
+		result = document.edit({.offset = offset, .removed = 1, .inserted = {}});
+		if(result.error || !matches_full_parse(document))
+			++mismatches;
+	}
+	CHECK(mismatches == 0);
+	CHECK(document.text() == u8(TEXT));
+}
+
+} // namespace
+
+int
+main()
+{
+	test_load();
+	test_edit_inside_element();
+	test_edit_structure();
+	test_malformed_edit();
+	test_insert_everywhere();
+	return adexml::test::check_result();
+}
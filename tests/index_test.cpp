@@ -0,0 +1,118 @@
+//=============================================================================
+//	FILE:					index_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::IndexBuilder and adexml::ElementIndex
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "adexml/index.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view EXPORT =
+	"<export>\n"
+	"  <customer id=\"C2\"><name>Second</name></customer>\n"
+	"  <customer id=\"C1\"><name>First</name><order id=\"O1\"/></customer>\n"
+	"  <customer><name>No key</name></customer>\n"
+	"  <customer id=\"C2\"><name>Again</name></customer>\n"
+	"</export>";
+
+//-----------------------------------------------------------------------------
+//	Files are written to the temporary directory and removed with the object.
+//-----------------------------------------------------------------------------
+struct TempFile
+{
+	std::filesystem::path		path;
+
+	explicit TempFile(std::string_view name) : path(std::filesystem::temp_directory_path() / ("adexml_index_test_" + std::string(name))) {}
+	~TempFile()		{std::error_code ec; std::filesystem::remove(path, ec);}
+
+	void	write(std::string_view text) const	{std::ofstream(path, std::ios::binary).write(text.data(), text.size());}
+};
+
+void
+test_build_and_find()
+{
+	TempFile xml("export.xml");
+	TempFile idx("export.xml.idx");
+	xml.write(EXPORT);
+
+	adexml::IndexBuilder builder({{u8"export/customer", u8"id"}, {u8"export/customer/order", u8"id"}});
+	adexml::Parser parser(adexml::Parser::Callback{});
+	builder.attach(parser);
+	CHECK(!parser.write(u8(EXPORT)));
+	CHECK(!parser.finish());
+	CHECK(builder.size() == 4);
+	CHECK(!builder.save(idx.path));
+
+	auto index = adexml::ElementIndex::open(idx.path);
+	CHECK(index.has_value());
+	if(!index)
+		return;
+	CHECK(index->size() == 4);
+	CHECK(index->specs().size() == 2);
+
+	auto first = index->find(u8"export/customer", u8"C1");
+	CHECK(first.has_value());
+	if(!first)
+		return;
+	CHECK(first->depth == 2);
+	CHECK(EXPORT.substr(first->begin, first->size()) == "<customer id=\"C1\"><name>First</name><order id=\"O1\"/></customer>");
+
+	auto order = index->find(u8"export/customer/order", u8"O1");
+	CHECK(order && EXPORT.substr(order->begin, order->size()) == "<order id=\"O1\"/>");
+
+	auto repeated = index->find_all(u8"export/customer", u8"C2");
+	CHECK(repeated.size() == 2);
+	CHECK(repeated.size() == 2 && repeated[0].begin < repeated[1].begin);
+	CHECK(index->find(u8"export/customer", u8"C2")->begin == repeated[0].begin);
+
+	CHECK(!index->find(u8"export/customer", u8"C3"));
+	CHECK(!index->find(u8"export/order", u8"O1"));
+
+	// Records are read back and parsed on their own.
+	auto bytes = adexml::read_record(xml.path, *first);
+	CHECK(bytes && bytes->size() == first->size());
+
+	std::u8string name;
+	adexml::Parser record(adexml::Parser::Callback{});
+	record.set_callback([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			if((action == adexml::Parser::ACTION_END_ELEMENT) && (stack.back().name == u8"name"))
+				name = stack.back().content;
+			return {};
+		});
+	CHECK(!adexml::parse_record(xml.path, *first, record));
+	CHECK(name == u8"First");
+}
+
+void
+test_open_errors()
+{
+	TempFile bad("bad.idx");
+	bad.write("not an index");
+	CHECK(adexml::ElementIndex::open(bad.path).error() == adexml::Error::INVALID_INDEX);
+
+	TempFile missing("missing.idx");
+	CHECK(!adexml::ElementIndex::open(missing.path));
+}
+
+} // namespace
+
+int
+main()
+{
+	test_build_and_find();
+	test_open_errors();
+	return adexml::test::check_result();
+}
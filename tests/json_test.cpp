@@ -0,0 +1,132 @@
+//=============================================================================
+//	FILE:					json_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::JsonConverter
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <string>
+#include "adexml/json.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+std::u8string
+convert(std::string_view document, adexml::JsonOptions options = {})
+{
+	adexml::JsonConverter	converter(std::move(options));
+	adexml::Parser				parser(converter.callback());
+	CHECK(!parser.write(u8(document)));
+	CHECK(!parser.finish());
+	CHECK(!converter.finish());
+	return std::u8string(converter.output());
+}
+
+void
+test_mapping_rules()
+{
+	// The example from json.h.
+	CHECK(convert("<item id=\"7\"><name>Bolt</name><tag>a</tag><tag>b</tag></item>")
+		== u8"{\"item\":{\"@id\":\"7\",\"name\":\"Bolt\",\"tag\":[\"a\",\"b\"]}}\n");
+
+	// Leaves are their text, or null when empty.
+	CHECK(convert("<a>text</a>") == u8"{\"a\":\"text\"}\n");
+	CHECK(convert("<a/>") == u8"{\"a\":null}\n");
+	CHECK(convert("<a><b></b></a>") == u8"{\"a\":{\"b\":null}}\n");
+
+	// Text beside attributes or children goes under text_key, trimmed.
+	CHECK(convert("<a x=\"1\">text  </a>") == u8"{\"a\":{\"@x\":\"1\",\"#text\":\"text\"}}\n");
+	CHECK(convert("<a>\n  <b>1</b>\n</a>") == u8"{\"a\":{\"b\":\"1\"}}\n");
+
+	// Siblings separated by another element repeat the key.
+	CHECK(convert("<a><b>1</b><c>2</c><b>3</b></a>") == u8"{\"a\":{\"b\":\"1\",\"c\":\"2\",\"b\":\"3\"}}\n");
+
+	// Arrays of objects and nested arrays.
+	CHECK(convert("<a><b x=\"1\"/><b x=\"2\"><c>3</c><c>4</c></b></a>")
+		== u8"{\"a\":{\"b\":[{\"@x\":\"1\"},{\"@x\":\"2\",\"c\":[\"3\",\"4\"]}]}}\n");
+
+	// Namespace prefixes are kept in names.
+	CHECK(convert("<p:a xmlns:p=\"urn:p\"><p:b>1</p:b></p:a>") == u8"{\"p:a\":{\"@xmlns:p\":\"urn:p\",\"p:b\":\"1\"}}\n");
+}
+
+void
+test_options()
+{
+	adexml::JsonOptions repeated;
+	repeated.b_auto_arrays = false;
+	CHECK(convert("<a><b>1</b><b>2</b></a>", repeated) == u8"{\"a\":{\"b\":\"1\",\"b\":\"2\"}}\n");
+
+	adexml::JsonOptions always;
+	always.array_paths = {u8"a/b"};
+	CHECK(convert("<a><b>1</b></a>", always) == u8"{\"a\":{\"b\":[\"1\"]}}\n");
+
+	adexml::JsonOptions renamed;
+	renamed.attribute_prefix 	= u8"_";
+	renamed.text_key 					= u8"value";
+	CHECK(convert("<a x=\"1\">t</a>", renamed) == u8"{\"a\":{\"_x\":\"1\",\"value\":\"t\"}}\n");
+}
+
+void
+test_escaping()
+{
+	std::u8string out;
+	adexml::append_json_escaped(out, u8"quote\" back\\ nl\n tab\t ctl\x01 café");
+	CHECK(out == u8"quote\\\" back\\\\ nl\\n tab\\t ctl\\u0001 café");
+
+	CHECK(convert("<a>&lt;&quot;&amp;</a>") == u8"{\"a\":\"<\\\"&\"}\n");
+}
+
+void
+test_records()
+{
+	constexpr std::string_view DOCUMENT =
+		"<export><meta>skipped</meta>"
+		"<rows><row id=\"1\"><v>a</v></row><row id=\"2\"/></rows>"
+		"</export>";
+
+	adexml::JsonOptions options;
+	options.record_path = u8"export/rows/row";
+	options.flush_bytes = 4;
+
+	std::u8string 				lines;
+	int										sink_calls = 0;
+	adexml::JsonConverter	converter(options, [&](std::u8string_view json) -> std::error_code
+		{
+			++sink_calls;
+			lines.append(json);
+			return {};
+		});
+	adexml::Parser parser(converter.callback());
+	CHECK(!parser.write(u8(DOCUMENT)));
+	CHECK(!parser.finish());
+	CHECK(!converter.finish());
+
+	// Each record is written as its value, one per line.
+	CHECK(converter.lines() == 2);
+	CHECK(lines == u8"{\"@id\":\"1\",\"v\":\"a\"}\n{\"@id\":\"2\"}\n");
+	CHECK(sink_calls >= 2);
+	CHECK(converter.output().empty());
+
+	// A sink error stops the parse.
+	adexml::JsonConverter failing({}, [](std::u8string_view) -> std::error_code {return adexml::Error::FAILED;});
+	adexml::Parser failing_parser(failing.callback());
+	CHECK(failing_parser.write(u8("<a>1</a>")) == adexml::Error::FAILED);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_mapping_rules();
+	test_options();
+	test_escaping();
+	test_records();
+	return adexml::test::check_result();
+}
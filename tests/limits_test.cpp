@@ -0,0 +1,178 @@
+//=============================================================================
+//	FILE:					limits_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for Parser::Limits
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Each limit is checked at its boundary: a document that just fits
+//		parses and one a byte (or an element) over fails with the limit's
+//		error code.
+//=============================================================================
+#include <string>
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+using Limits = adexml::Parser::Limits;
+
+std::error_code
+parse(const Limits & limits, std::string_view document)
+{
+	adexml::Parser parser(adexml::Parser::Callback{});
+	parser.set_limits(limits);
+	if(auto ec = parser.write(u8(document)))
+		return ec;
+	return parser.finish();
+}
+
+std::string
+nested(int depth)
+{
+	std::string document;
+	for(int i = 0; i < depth; ++i)
+		document += "<a>";
+	for(int i = 0; i < depth; ++i)
+		document += "</a>";
+	return document;
+}
+
+void
+test_boundaries()
+{
+	Limits limits;
+	limits.max_depth = 3;
+	CHECK(!parse(limits, nested(3)));
+	CHECK(parse(limits, nested(4)) == adexml::Error::DEPTH_LIMIT_EXCEEDED);
+
+	limits = {};
+	limits.max_attributes = 2;
+	CHECK(!parse(limits, "<a x=\"1\" y=\"2\"/>"));
+	CHECK(parse(limits, "<a x=\"1\" y=\"2\" z=\"3\"/>") == adexml::Error::ATTRIBUTE_LIMIT_EXCEEDED);
+
+	limits = {};
+	limits.max_name_bytes = 4;
+	CHECK(!parse(limits, "<abcd/>"));
+	CHECK(parse(limits, "<abcde/>") == adexml::Error::NAME_LIMIT_EXCEEDED);
+
+	limits = {};
+	limits.max_attribute_value_bytes = 3;
+	CHECK(!parse(limits, "<a x=\"123\"/>"));
+	CHECK(parse(limits, "<a x=\"1234\"/>") == adexml::Error::ATTRIBUTE_VALUE_LIMIT_EXCEEDED);
+
+	limits = {};
+	limits.max_content_bytes = 5;
+	CHECK(!parse(limits, "<a>12345</a>"));
+	CHECK(parse(limits, "<a>123456</a>") == adexml::Error::CONTENT_LIMIT_EXCEEDED);
+
+	limits = {};
+	limits.max_document_bytes = 12;
+	CHECK(!parse(limits, "<a>12345</a>"));
+	CHECK(parse(limits, "<a>123456</a>") == adexml::Error::DOCUMENT_LIMIT_EXCEEDED);
+
+	limits = {};
+	limits.max_dtd_bytes = 16;
+	CHECK(parse(limits, "<!DOCTYPE a [<!ENTITY e \"a long replacement\">]><a/>") == adexml::Error::DTD_LIMIT_EXCEEDED);
+}
+
+void
+test_entity_limits()
+{
+	constexpr std::string_view DOCUMENT = "<!DOCTYPE a [<!ENTITY e \"0123456789\">]><a>&e;&e;&e;</a>";
+
+	Limits limits;
+	limits.max_entity_expansions = 3;
+	CHECK(!parse(limits, DOCUMENT));
+	limits.max_entity_expansions = 2;
+	CHECK(parse(limits, DOCUMENT) == adexml::Error::ENTITY_LIMIT_EXCEEDED);
+
+	limits = {};
+	limits.max_entity_expansion_bytes = 29;
+	CHECK(parse(limits, DOCUMENT) == adexml::Error::ENTITY_LIMIT_EXCEEDED);
+
+	// An expansion may not overshoot the content limit either.
+	limits = {};
+	limits.max_content_bytes = 25;
+	CHECK(parse(limits, DOCUMENT) == adexml::Error::CONTENT_LIMIT_EXCEEDED);
+
+	// Predefined entities are ordinary text and are not counted.
+	limits = {};
+	limits.max_entity_expansions = 0;
+	CHECK(!parse(limits, "<a>&amp;&lt;&#65;</a>"));
+}
+
+//-----------------------------------------------------------------------------
+//	Parses a document that fails while expanding an entity, then checks that
+//	the parser stays failed: a further write reports FAILED without raising
+//	any events.
+//-----------------------------------------------------------------------------
+bool
+stays_failed(const Limits & limits, std::string_view document, adexml::Error expected)
+{
+	int events = 0;
+	adexml::Parser parser([&](auto, auto &, auto &) -> std::error_code {++events; return {};});
+	parser.set_limits(limits);
+	if(parser.write(u8(document)) != expected)
+		return false;
+
+	events = 0;
+	return (parser.write(u8("<b>ok</b>")) == adexml::Error::FAILED) && (events == 0) && (parser.finish() == adexml::Error::FAILED);
+}
+
+void
+test_entity_failures()
+{
+	constexpr std::string_view DOCUMENT = "<!DOCTYPE a [<!ENTITY e \"0123456789\">]><a x=\"&e;&e;\">&e;&e;&e;</a>";
+
+	Limits limits;
+	limits.max_content_bytes = 25;
+	CHECK(stays_failed(limits, DOCUMENT, adexml::Error::CONTENT_LIMIT_EXCEEDED));
+
+	limits = {};
+	limits.max_attribute_value_bytes = 15;
+	CHECK(stays_failed(limits, DOCUMENT, adexml::Error::ATTRIBUTE_VALUE_LIMIT_EXCEEDED));
+
+	limits = {};
+	limits.max_entity_expansions = 2;
+	CHECK(stays_failed(limits, DOCUMENT, adexml::Error::ENTITY_LIMIT_EXCEEDED));
+
+	CHECK(stays_failed({}, "<a>&undeclared;</a>", adexml::Error::UNKNOWN_ENTITY));
+	CHECK(stays_failed({}, "<a x=\"&undeclared;\"/>", adexml::Error::UNKNOWN_ENTITY));
+	CHECK(stays_failed({}, "<!DOCTYPE a [<!ENTITY x \"&y;\"><!ENTITY y \"&x;\">]><a>&x;</a>", adexml::Error::RECURSIVE_ENTITY));
+}
+
+void
+test_configuration()
+{
+	adexml::Parser parser(adexml::Parser::Callback{});
+	CHECK(parser.limits() == Limits{});
+
+	parser.set_limits(Limits::untrusted());
+	CHECK(parser.limits() == Limits::untrusted());
+	parser.reset();
+	CHECK(parser.limits() == Limits::untrusted());
+
+	parser.set_limits({});
+	CHECK(parser.limits() == Limits{});
+	CHECK(Limits::unlimited().max_entity_expansions == UINT64_MAX);
+	CHECK(Limits{}.max_entity_expansions < UINT64_MAX);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_boundaries();
+	test_entity_limits();
+	test_entity_failures();
+	test_configuration();
+	return adexml::test::check_result();
+}
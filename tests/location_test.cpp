@@ -0,0 +1,110 @@
+//=============================================================================
+//	FILE:					location_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for Parser::offset(), location() and locate()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Lines are counted once per write(), so every check is repeated with
+//		the document split into chunks of several sizes.
+//=============================================================================
+#include <string>
+#include <vector>
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view DOCUMENT =
+	"<root>\n"
+	"  <a x=\"1\">text\n"
+	"more</a>\n"
+	"\t<b/>\n"
+	"</root>";
+
+constexpr std::size_t CHUNK_SIZES[] = {1, 2, 3, 5, 7, 100};
+
+void
+test_callback_locations()
+{
+	for(auto chunk : CHUNK_SIZES)
+	{
+		std::vector<adexml::Parser::Location> starts;
+		adexml::Parser parser(adexml::Parser::Callback{});
+		parser.set_callback([&](auto action, auto &, auto &) -> std::error_code
+			{
+				if(action == adexml::Parser::ACTION_START_ELEMENT)
+					starts.push_back(parser.location());
+				return {};
+			});
+
+		const auto input = u8(DOCUMENT);
+		for(std::size_t i = 0; i < input.size(); i += chunk)
+			CHECK(!parser.write(input.substr(i, chunk)));
+		CHECK(!parser.finish());
+
+		// Each start is reported at the '>' that completes its tag.
+		CHECK(starts.size() == 3);
+		if(starts.size() != 3)
+			continue;
+		for(auto & start : starts)
+		{
+			const auto expected = adexml::Parser::locate(input, start.offset);
+			CHECK(input[start.offset] == u8'>');
+			CHECK(start.line == expected.line && start.column == expected.column);
+		}
+		CHECK(starts[0].line == 1 && starts[0].column == 6);
+		CHECK(starts[1].line == 2 && starts[1].column == 11);
+		CHECK(starts[2].line == 4 && starts[2].column == 5);
+		CHECK(parser.location().line == 5);
+	}
+}
+
+void
+test_error_location()
+{
+	constexpr std::string_view BAD = "<root>\n<a>\n</b>\n</root>";
+	for(auto chunk : CHUNK_SIZES)
+	{
+		adexml::Parser parser(adexml::Parser::Callback{});
+		const auto input = u8(BAD);
+
+		std::error_code ec;
+		for(std::size_t i = 0; (i < input.size()) && !ec; i += chunk)
+			ec = parser.write(input.substr(i, chunk));
+
+		CHECK(ec == adexml::Error::ELEMENT_TAG_MISMATCH);
+		const auto location = parser.location();
+		CHECK(location.offset == parser.offset());
+		CHECK(location.line == 3);
+		CHECK(location.column == adexml::Parser::locate(input, location.offset).column);
+	}
+}
+
+void
+test_locate()
+{
+	const auto input = u8("ab\ncd\n\nef");
+	CHECK(adexml::Parser::locate(input, 0).line == 1);
+	CHECK(adexml::Parser::locate(input, 4).line == 2 && adexml::Parser::locate(input, 4).column == 2);
+	CHECK(adexml::Parser::locate(input, 7).line == 4 && adexml::Parser::locate(input, 7).column == 1);
+	CHECK(adexml::Parser::locate(input, 1000).offset == input.size());
+}
+
+} // namespace
+
+int
+main()
+{
+	test_callback_locations();
+	test_error_location();
+	test_locate();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,87 @@
+//=============================================================================
+//	FILE:					memory_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for parsing through caller supplied memory resources
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <string>
+#include "adexml/memory.h"
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+std::string
+make_document(int depth)
+{
+	std::string document;
+	for(int i = 0; i < depth; ++i)
+		document += "<level attribute=\"value\">";
+	for(int i = 0; i < depth; ++i)
+		document += "</level>";
+	return document;
+}
+
+void
+test_budget_exhausted()
+{
+	adexml::BoundedResource budget(4 * 1024);
+	adexml::Parser parser(adexml::Parser::Callback{}, &budget);
+
+	CHECK(parser.write(u8(make_document(500))) == adexml::Error::OUT_OF_MEMORY);
+	CHECK(budget.peak() <= budget.budget());
+
+	// The failed parse leaves the parser usable once the budget allows it.
+	budget.set_budget(1024 * 1024);
+	parser.reset();
+	CHECK(!parser.write(u8(make_document(500))));
+	CHECK(!parser.finish());
+	CHECK(budget.peak() > 4 * 1024);
+}
+
+void
+test_arena()
+{
+	std::pmr::monotonic_buffer_resource	arena(64 * 1024);
+	adexml::CountingResource						counter(&arena);
+	std::size_t													elements = 0;
+
+	{
+		adexml::Parser parser([&](auto action, auto &, auto & stack) -> std::error_code
+			{
+				if(action == adexml::Parser::ACTION_START_ELEMENT)
+				{
+					++elements;
+					// Elements handed to the callback allocate through the parser, not
+					// from the default resource.
+					if(stack.back().name.get_allocator().resource() == std::pmr::get_default_resource())
+						return adexml::Error::FAILED;
+				}
+				return {};
+			}, &counter);
+
+		CHECK(!parser.write(u8(make_document(20))));
+		CHECK(!parser.finish());
+	}
+
+	CHECK(elements == 20);
+	CHECK(counter.allocations() > 0);
+	CHECK(counter.in_use() == 0);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_budget_exhausted();
+	test_arena();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,109 @@
+//=============================================================================
+//	FILE:					parse_many_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::parse_many()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Small batches are used so that several workers each get many batches
+//		and idle workers have something to steal.
+//=============================================================================
+#include <atomic>
+#include <string>
+#include <vector>
+#include "adexml/parse_many.h"
+#include "check.h"
+
+namespace
+{
+
+std::vector<std::string>
+make_documents(std::size_t count)
+{
+	std::vector<std::string> documents;
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		std::string document = "<doc>";
+		for(std::size_t item = 0; item < i % 7; ++item)
+			document += "<item/>";
+		document += (i % 13 == 5) ? "</bad>" : "</doc>";
+		documents.push_back(std::move(document));
+	}
+	return documents;
+}
+
+void
+test_results_in_input_order()
+{
+	constexpr unsigned THREADS = 4;
+	const auto documents = make_documents(500);
+
+	std::vector<int>	elements(documents.size(), 0);
+	std::atomic<bool>	b_bad_context{false};
+	const auto results = adexml::parse_many(documents,
+		[&](const adexml::DocumentContext & context) -> adexml::Parser::Callback
+		{
+			if((context.worker >= THREADS) || (context.resource == nullptr) || (context.document >= documents.size()))
+				b_bad_context = true;
+			return [&elements, index = context.document](auto action, auto &, auto &) -> std::error_code
+				{
+					elements[index] += (action == adexml::Parser::ACTION_START_ELEMENT);
+					return {};
+				};
+		},
+		{.threads = THREADS, .batch_bytes = 256, .batch_documents = 3});
+
+	CHECK(!b_bad_context);
+	CHECK(results.size() == documents.size());
+	for(std::size_t i = 0; i < documents.size(); ++i)
+	{
+		CHECK(static_cast<bool>(results[i]) == (i % 13 == 5));
+		if(i % 13 != 5)
+			CHECK(elements[i] == static_cast<int>(1 + i % 7));
+	}
+}
+
+void
+test_callback_error_stops_one_document()
+{
+	const std::vector<std::string> documents{"<a/>", "<stop/>", "<a><b/></a>", "<a>"};
+	const auto results = adexml::parse_many(documents,
+		[](const adexml::DocumentContext &) -> adexml::Parser::Callback
+		{
+			return [](auto action, auto &, auto & stack) -> std::error_code
+				{
+					if((action == adexml::Parser::ACTION_START_ELEMENT) && (stack.back().name == u8"stop"))
+						return adexml::Error::FAILED;
+					return {};
+				};
+		},
+		{.threads = 2});
+
+	CHECK(results.size() == 4);
+	CHECK(!results[0]);
+	CHECK(results[1] == adexml::Error::FAILED);
+	CHECK(!results[2]);
+	CHECK(results[3] == adexml::Error::INCOMPLETE_DOCUMENT);
+}
+
+void
+test_no_documents()
+{
+	const std::vector<std::string> documents;
+	CHECK(adexml::parse_many(documents, [](const adexml::DocumentContext &) { return adexml::Parser::Callback{}; }).empty());
+}
+
+} // namespace
+
+int
+main()
+{
+	test_results_in_input_order();
+	test_callback_error_stops_one_document();
+	test_no_documents();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,156 @@
+//=============================================================================
+//	FILE:					parser_pool_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for Parser::reset() and adexml::ParserPool
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "adexml/parser_pool.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+void
+test_reset_reuses_parser()
+{
+	int starts = 0;
+	adexml::Parser parser([&](auto action, auto &, auto &) -> std::error_code
+		{
+			starts += (action == adexml::Parser::ACTION_START_ELEMENT);
+			return {};
+		});
+
+	CHECK(parser.write(u8("<a><b></c>")) == adexml::Error::ELEMENT_TAG_MISMATCH);
+	CHECK(parser.finish() == adexml::Error::FAILED);
+
+	parser.reset();
+	starts = 0;
+	CHECK(!parser.write(u8("<a><b/><b/></a>")));
+	CHECK(!parser.finish());
+	CHECK(starts == 3);
+	CHECK(parser.offset() == 15);
+
+	// A half written document is discarded by reset().
+	parser.reset();
+	CHECK(!parser.write(u8("<a><b>")));
+	CHECK(parser.finish() == adexml::Error::INCOMPLETE_DOCUMENT);
+	parser.reset();
+	CHECK(!parser.finish());
+	CHECK(parser.offset() == 0);
+}
+
+void
+test_pool_overflow()
+{
+	adexml::ParserPool pool(2);
+	CHECK(pool.capacity() == 2);
+
+	auto first 	= pool.acquire({});
+	auto second	= pool.acquire({});
+	auto third 	= pool.acquire({});
+	CHECK(first.is_pooled() && second.is_pooled());
+	CHECK(first.get() != second.get());
+	CHECK(third && !third.is_pooled());
+
+	// A released parser comes back reset, with the new callback.
+	CHECK(!first->write(u8("<a><b>")));
+	auto * parser = first.get();
+	first.release();
+	CHECK(!first);
+
+	int starts = 0;
+	auto again = pool.acquire([&](auto, auto &, auto &) -> std::error_code {++starts; return {};});
+	CHECK(again.get() == parser);
+	CHECK(!again->finish());
+	CHECK(!again->write(u8("<x/>")));
+	CHECK(starts == 1);
+
+	auto moved = std::move(again);
+	CHECK(!again && moved.is_pooled());
+}
+
+//-----------------------------------------------------------------------------
+//	Threads check parsers in and out as fast as they can. A free list that
+//	lost an ABA race would hand one parser to two threads at once, which the
+//	per-parser owner flags catch.
+//-----------------------------------------------------------------------------
+void
+test_pool_threads()
+{
+	constexpr std::size_t	CAPACITY 		= 3;
+	constexpr int					THREADS 		= 6;
+	constexpr int					ITERATIONS	= 5000;
+
+	adexml::ParserPool			pool(CAPACITY);
+	std::vector<std::unique_ptr<std::atomic<bool>>>	in_use;
+	std::vector<adexml::Parser *>										parsers;
+	for(std::size_t i = 0; i < CAPACITY; ++i)
+	{
+		in_use.push_back(std::make_unique<std::atomic<bool>>(false));
+		auto lease = pool.acquire({});
+		parsers.push_back(lease.get());
+		lease.release();
+	}
+
+	std::atomic<int>	shared{0};
+	std::atomic<int>	failed{0};
+	std::atomic<int>	pooled{0};
+	std::vector<std::thread>	threads;
+	for(int t = 0; t < THREADS; ++t)
+		threads.emplace_back([&]
+			{
+				for(int i = 0; i < ITERATIONS; ++i)
+				{
+					int elements = 0;
+					auto lease = pool.acquire([&](auto action, auto &, auto &) -> std::error_code
+						{
+							elements += (action == adexml::Parser::ACTION_START_ELEMENT);
+							return {};
+						});
+
+					std::atomic<bool> * owner = nullptr;
+					for(std::size_t p = 0; p < CAPACITY; ++p)
+						if(parsers[p] == lease.get())
+							owner = in_use[p].get();
+					if(owner)
+					{
+						++pooled;
+						if(owner->exchange(true))
+							++shared;
+					}
+
+					if(lease->write(u8("<a><b/><c/></a>")) || lease->finish() || (elements != 3))
+						++failed;
+
+					if(owner)
+						owner->store(false);
+				}
+			});
+	for(auto & thread : threads)
+		thread.join();
+
+	CHECK(shared == 0);
+	CHECK(failed == 0);
+	CHECK(pooled > 0);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_reset_reuses_parser();
+	test_pool_overflow();
+	test_pool_threads();
+	return adexml::test::check_result();
+}
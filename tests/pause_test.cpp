@@ -0,0 +1,102 @@
+//=============================================================================
+//	FILE:					pause_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for Parser::pause() and resume()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <string>
+#include <vector>
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view DOCUMENT = "<list><item n=\"1\"/><item n=\"2\">two</item><item n=\"3\"/></list>";
+
+void
+test_pause_on_each_item()
+{
+	std::vector<std::u8string> seen;
+	adexml::Parser parser(adexml::Parser::Callback{});
+	parser.set_callback([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			if((action == adexml::Parser::ACTION_START_ELEMENT) && (stack.back().name == u8"item"))
+			{
+				seen.push_back(*stack.back().attribute(u8"n"));
+				parser.pause();
+			}
+			return {};
+		});
+
+	const auto input = u8(DOCUMENT);
+	auto result = parser.write_some(input);
+	CHECK(!result.ec);
+	CHECK(parser.is_paused());
+	CHECK(seen.size() == 1);
+	CHECK(input.substr(0, result.consumed) == u8"<list><item n=\"1\"/>");
+
+	// No input is accepted while paused.
+	CHECK(parser.write(u8("<x/>")) == adexml::Error::PAUSED);
+	CHECK(seen.size() == 1);
+
+	std::size_t consumed	= result.consumed;
+	int					pauses		= 1;
+	while(parser.is_paused())
+	{
+		result = parser.resume();
+		CHECK(!result.ec);
+		consumed 	+= result.consumed;
+		pauses 		+= parser.is_paused();
+	}
+
+	CHECK(pauses == 3);
+	CHECK(consumed == input.size());
+	CHECK(seen == std::vector<std::u8string>{u8"1", u8"2", u8"3"});
+	CHECK(!parser.finish());
+}
+
+void
+test_resume_without_pause()
+{
+	adexml::Parser parser(adexml::Parser::Callback{});
+	CHECK(!parser.is_paused());
+	const auto result = parser.resume();
+	CHECK(result.consumed == 0);
+
+	// A write that is not paused consumes everything.
+	const auto written = parser.write_some(u8(DOCUMENT));
+	CHECK(!written.ec && written.consumed == DOCUMENT.size());
+	CHECK(!parser.finish());
+}
+
+void
+test_reset_clears_pause()
+{
+	adexml::Parser parser(adexml::Parser::Callback{});
+	parser.set_callback([&](auto, auto &, auto &) -> std::error_code {parser.pause(); return {};});
+	CHECK(parser.write(u8(DOCUMENT)) == adexml::Error::PAUSED);
+	parser.reset();
+	CHECK(!parser.is_paused());
+
+	parser.set_callback({});
+	CHECK(!parser.write(u8(DOCUMENT)));
+	CHECK(!parser.finish());
+}
+
+} // namespace
+
+int
+main()
+{
+	test_pause_on_each_item();
+	test_resume_without_pause();
+	test_reset_clears_pause();
+	return adexml::test::check_result();
+}
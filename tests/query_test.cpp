@@ -0,0 +1,158 @@
+//=============================================================================
+//	FILE:					query_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::QuerySet
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <string>
+#include <vector>
+#include "adexml/query.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view LIBRARY =
+	"<library>"
+		"<shelf id=\"a\">"
+			"<book lang=\"en\"><title>One</title></book>"
+			"<book lang=\"fr\"><title>Deux</title></book>"
+		"</shelf>"
+		"<shelf id=\"b\">"
+			"<book lang=\"en\"><title>Three</title><note><title>Inner</title></note></book>"
+		"</shelf>"
+	"</library>";
+
+struct Hit
+{
+	std::size_t						query;
+	adexml::QueryResult		result;
+	std::u8string					value;
+};
+
+std::vector<Hit>
+run(adexml::QuerySet & queries, std::string_view document)
+{
+	std::vector<Hit> hits;
+	queries.set_handler([&](const adexml::QueryMatch & match) -> std::error_code
+		{
+			hits.push_back({match.query, match.result, std::u8string(match.value)});
+			return {};
+		});
+
+	adexml::Parser parser(queries.callback());
+	CHECK(!parser.write(u8(document)));
+	CHECK(!parser.finish());
+	return hits;
+}
+
+std::vector<std::u8string>
+values_of(const std::vector<Hit> & hits, std::size_t query)
+{
+	std::vector<std::u8string> values;
+	for(auto & hit : hits)
+		if(hit.query == query)
+			values.push_back(hit.value);
+	return values;
+}
+
+void
+test_child_and_descendant_steps()
+{
+	adexml::QuerySet queries;
+	const auto child 			= queries.add(u8"/library/shelf/book/title/text()");
+	const auto descendant	= queries.add(u8"//title/text()");
+	const auto attribute 	= queries.add(u8"/library/shelf/@id");
+	CHECK(child && descendant && attribute);
+	CHECK(queries.size() == 3);
+
+	const auto hits = run(queries, LIBRARY);
+	CHECK(values_of(hits, *child) == std::vector<std::u8string>{u8"One", u8"Deux", u8"Three"});
+	CHECK(values_of(hits, *descendant) == std::vector<std::u8string>{u8"One", u8"Deux", u8"Three", u8"Inner"});
+	CHECK(values_of(hits, *attribute) == std::vector<std::u8string>{u8"a", u8"b"});
+	for(auto & hit : hits)
+		CHECK(hit.result == ((hit.query == *attribute) ? adexml::QueryResult::ATTRIBUTE : adexml::QueryResult::TEXT));
+}
+
+void
+test_predicates()
+{
+	adexml::QuerySet queries;
+	const auto by_value		= queries.add(u8"//book[@lang='fr']/title/text()");
+	const auto by_position	= queries.add(u8"/library/shelf[2]/book[1]/title/text()");
+	const auto wildcard		= queries.add(u8"/library/*[@id='a']/book[2]/@lang");
+	CHECK(by_value && by_position && wildcard);
+
+	const auto hits = run(queries, LIBRARY);
+	CHECK(values_of(hits, *by_value) == std::vector<std::u8string>{u8"Deux"});
+	CHECK(values_of(hits, *by_position) == std::vector<std::u8string>{u8"Three"});
+	CHECK(values_of(hits, *wildcard) == std::vector<std::u8string>{u8"fr"});
+}
+
+void
+test_predicate_order()
+{
+	// The position counts siblings that pass the name test; attribute
+	// predicates that follow it filter the sibling at that position.
+	const std::string_view items = "<r><i k=\"a\" n=\"1\"/><i k=\"b\" n=\"2\"/><i k=\"a\" n=\"3\"/></r>";
+
+	adexml::QuerySet queries;
+	const auto second	= queries.add(u8"/r/i[2][@k='a']/@n");
+	const auto third	= queries.add(u8"/r/i[3][@k='a']/@n");
+	CHECK(second && third);
+
+	const auto hits = run(queries, items);
+	CHECK(values_of(hits, *second).empty());
+	CHECK(values_of(hits, *third) == std::vector<std::u8string>{u8"3"});
+
+	// A position that follows an attribute predicate is not supported.
+	CHECK(!queries.add(u8"/r/i[@k='a'][2]"));
+	CHECK(queries.size() == 2);
+}
+
+void
+test_element_capture()
+{
+	adexml::QuerySet queries;
+	const auto note = queries.add(u8"//note");
+	CHECK(note);
+
+	const auto hits = run(queries, LIBRARY);
+	CHECK(hits.size() == 1);
+	CHECK(hits.size() == 1 && hits[0].result == adexml::QueryResult::ELEMENT);
+	CHECK(hits.size() == 1 && hits[0].value == u8"<note><title>Inner</title></note>");
+
+	// Evaluation state is per document; the same set runs again after reset().
+	queries.reset();
+	CHECK(run(queries, LIBRARY).size() == 1);
+}
+
+void
+test_invalid_expressions()
+{
+	adexml::QuerySet queries;
+	CHECK(!queries.add(u8""));
+	CHECK(!queries.add(u8"/a/"));
+	CHECK(!queries.add(u8"/a[@b"));
+	CHECK(!queries.add(u8"/a[0]"));
+	CHECK(queries.size() == 0);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_child_and_descendant_steps();
+	test_predicates();
+	test_predicate_order();
+	test_element_capture();
+	test_invalid_expressions();
+	return adexml::test::check_result();
+}
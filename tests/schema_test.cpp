@@ -0,0 +1,128 @@
+//=============================================================================
+//	FILE:					schema_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::Schema and validation while parsing
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+#include <memory>
+#include <string>
+#include "adexml/schema.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view DECLARATIONS =
+	"<!ELEMENT doc (head?, (p | list)+, foot)>"
+	"<!ELEMENT head (#PCDATA)>"
+	"<!ELEMENT p (#PCDATA | b)*>"
+	"<!ELEMENT b (#PCDATA)>"
+	"<!ELEMENT list (item, item*)>"
+	"<!ELEMENT item EMPTY>"
+	"<!ELEMENT foot ((x, y) | (x, z))>"
+	"<!ELEMENT x EMPTY>"
+	"<!ELEMENT y EMPTY>"
+	"<!ELEMENT z EMPTY>"
+	"<!ATTLIST doc version CDATA #FIXED \"1\" lang CDATA \"en\">"
+	"<!ATTLIST item id ID #REQUIRED kind (one | two) \"one\">";
+
+std::shared_ptr<const adexml::Schema>
+make_schema()
+{
+	auto schema = adexml::Schema::parse(u8(DECLARATIONS), u8"doc");
+	CHECK(schema.has_value());
+	return schema ? std::make_shared<const adexml::Schema>(std::move(*schema)) : nullptr;
+}
+
+std::error_code
+validate(std::string_view body, adexml::Element * out_root = nullptr)
+{
+	adexml::Parser parser([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			if(out_root && (action == adexml::Parser::ACTION_START_ELEMENT) && (stack.size() == 1))
+				*out_root = stack.back();
+			return {};
+		});
+	parser.set_schema(make_schema());
+	if(auto ec = parser.write(u8(body)))
+		return ec;
+	return parser.finish();
+}
+
+void
+test_content_models()
+{
+	CHECK(make_schema()->declares(u8"foot"));
+	CHECK(!make_schema()->declares(u8"missing"));
+
+	CHECK(!validate("<doc><p>text <b>bold</b></p><foot><x/><y/></foot></doc>"));
+	CHECK(!validate("<doc><head>h</head><list><item id=\"a\"/><item id=\"b\"/></list><p/><foot><x/><z/></foot></doc>"));
+
+	// Not 1-unambiguous, so the automaton must be determinised to accept both.
+	CHECK(!validate("<doc><p/><foot><x/><z/></foot></doc>"));
+
+	CHECK(validate("<doc><foot><x/><y/></foot></doc>") == adexml::Error::INVALID_CONTENT);
+	CHECK(validate("<doc><p/><foot><x/></foot></doc>") == adexml::Error::INVALID_CONTENT);
+	CHECK(validate("<doc><p/><foot><y/></foot></doc>") == adexml::Error::INVALID_CONTENT);
+	CHECK(validate("<doc><list/><p/><foot><x/><y/></foot></doc>") == adexml::Error::INVALID_CONTENT);
+	CHECK(validate("<doc><p/><foot><x/><y/></foot>text</doc>") == adexml::Error::INVALID_CONTENT);
+	CHECK(validate("<doc><p><i/></p><foot><x/><y/></foot></doc>") == adexml::Error::UNDECLARED_ELEMENT);
+	CHECK(validate("<p/>") == adexml::Error::INVALID_CONTENT);
+}
+
+void
+test_attributes()
+{
+	adexml::Element root;
+	CHECK(!validate("<doc><p/><foot><x/><y/></foot></doc>", &root));
+	CHECK(root.attribute_view(u8"version") == std::u8string_view(u8"1"));
+	CHECK(root.attribute_view(u8"lang") == std::u8string_view(u8"en"));
+
+	CHECK(validate("<doc version=\"2\"><p/><foot><x/><y/></foot></doc>") == adexml::Error::INVALID_ATTRIBUTE_VALUE);
+	CHECK(validate("<doc colour=\"red\"><p/><foot><x/><y/></foot></doc>") == adexml::Error::UNDECLARED_ATTRIBUTE);
+	CHECK(validate("<doc><list><item/></list><foot><x/><y/></foot></doc>") == adexml::Error::MISSING_ATTRIBUTE);
+	CHECK(validate("<doc><list><item id=\"a\" kind=\"three\"/></list><foot><x/><y/></foot></doc>") == adexml::Error::INVALID_ATTRIBUTE_VALUE);
+	CHECK(validate("<doc><list><item id=\"a\"/><item id=\"a\"/></list><foot><x/><y/></foot></doc>") == adexml::Error::DUPLICATE_ID);
+}
+
+void
+test_compile_errors()
+{
+	CHECK(adexml::Schema::parse(u8("<!ELEMENT a (b, c>")).error() == adexml::Error::DTD_SYNTAX_ERROR);
+	CHECK(adexml::Schema::parse(u8("<!ELEMENT a (b | c, d)>")).error() == adexml::Error::DTD_SYNTAX_ERROR);
+
+	// (a|b)*, a, (a|b) x N needs 2^N deterministic states, which is refused.
+	std::string model = "<!ELEMENT r ((a | b)*, a";
+	for(int i = 0; i < 12; ++i)
+		model += ", (a | b)";
+	model += ")>";
+	CHECK(adexml::Schema::parse(u8(model)).error() == adexml::Error::DTD_LIMIT_EXCEEDED);
+}
+
+void
+test_internal_subset()
+{
+	adexml::Doctype doctype;
+	CHECK(!adexml::parse_doctype(u8(" r [<!ELEMENT r (s*)><!ELEMENT s EMPTY>]"), doctype));
+	auto schema = adexml::Schema::compile(doctype);
+	CHECK(schema.has_value());
+	CHECK(schema && schema->state_count() > 0);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_content_models();
+	test_attributes();
+	test_compile_errors();
+	test_internal_subset();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,168 @@
+//=============================================================================
+//	FILE:					source_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for input sources, codecs and parse_source()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Compressed input is built by hand as a gzip member holding stored
+//		(uncompressed) deflate blocks, so the test needs no compressor. The
+//		GZIP checks only run when zlib was built in.
+//=============================================================================
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "adexml/source.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+std::string
+make_document()
+{
+	std::string document = "<root>";
+	for(int i = 0; i < 2000; ++i)
+		document += "<item n=\"" + std::to_string(i) + "\">value</item>";
+	return document + "</root>";
+}
+
+std::uint32_t
+crc32(std::string_view data)
+{
+	std::uint32_t crc = 0xFFFFFFFF;
+	for(unsigned char byte : data)
+	{
+		crc ^= byte;
+		for(int bit = 0; bit < 8; ++bit)
+			crc = (crc >> 1) ^ (0xEDB88320 & (0U - (crc & 1)));
+	}
+	return ~crc;
+}
+
+void
+put_le(std::u8string & out, std::uint32_t value, int bytes)
+{
+	for(int i = 0; i < bytes; ++i)
+		out.push_back(static_cast<char8_t>(value >> (8 * i)));
+}
+
+std::u8string
+make_gzip(std::string_view data)
+{
+	std::u8string out = {0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF};
+	constexpr std::size_t BLOCK = 0xFFFF;
+	std::size_t offset = 0;
+	do
+	{
+		const auto length = std::min(BLOCK, data.size() - offset);
+		const bool b_final = (offset + length == data.size());
+		out.push_back(b_final ? 1 : 0);
+		put_le(out, static_cast<std::uint32_t>(length), 2);
+		put_le(out, static_cast<std::uint32_t>(~length), 2);
+		out.append(u8(data.substr(offset, length)));
+		offset += length;
+	}
+	while(offset < data.size());
+	put_le(out, crc32(data), 4);
+	put_le(out, static_cast<std::uint32_t>(data.size()), 4);
+	return out;
+}
+
+std::error_code
+count_items(adexml::Source & source, int & items, const adexml::SourceOptions & options = {})
+{
+	items = 0;
+	adexml::Parser parser([&](auto action, auto &, auto & stack) -> std::error_code
+		{
+			items += (action == adexml::Parser::ACTION_START_ELEMENT) && (stack.back().name == u8"item");
+			return {};
+		});
+	return adexml::parse_source(source, parser, options);
+}
+
+void
+test_memory_source()
+{
+	const auto document = make_document();
+	for(bool b_threaded : {false, true})
+	{
+		int items = 0;
+		adexml::MemorySource source(u8(document));
+		CHECK(!count_items(source, items, {.block_bytes = 100, .blocks = 3, .b_threaded = b_threaded}));
+		CHECK(items == 2000);
+	}
+
+	// An incomplete document is reported once the source runs dry.
+	int items = 0;
+	adexml::MemorySource truncated(u8(document).substr(0, document.size() / 2));
+	CHECK(count_items(truncated, items) == adexml::Error::INCOMPLETE_DOCUMENT);
+}
+
+void
+test_detect_codec()
+{
+	CHECK(adexml::detect_codec(u8("\x1F\x8B\x08\x00")) == adexml::Codec::GZIP);
+	CHECK(adexml::detect_codec(u8("\x78\x9C")) == adexml::Codec::GZIP);
+	CHECK(adexml::detect_codec(u8("\x28\xB5\x2F\xFD")) == adexml::Codec::ZSTD);
+	CHECK(adexml::detect_codec(u8("<?xml")) == adexml::Codec::STORED);
+	CHECK(adexml::detect_codec({}) == adexml::Codec::STORED);
+	CHECK(adexml::codec_available(adexml::Codec::STORED));
+}
+
+void
+test_gzip()
+{
+	const auto document = make_document();
+	const auto gzip			= make_gzip(document);
+
+	auto decoder = adexml::make_decoder(adexml::Codec::GZIP, std::make_unique<adexml::MemorySource>(gzip));
+	if(!adexml::codec_available(adexml::Codec::GZIP))
+	{
+		CHECK(decoder.error() == adexml::Error::CODEC_UNAVAILABLE);
+		return;
+	}
+
+	int items = 0;
+	CHECK(decoder && !count_items(**decoder, items, {.block_bytes = 1000}));
+	CHECK(items == 2000);
+
+	auto truncated = adexml::make_decoder(adexml::Codec::GZIP, std::make_unique<adexml::MemorySource>(std::u8string_view(gzip).substr(0, gzip.size() / 2)));
+	CHECK(truncated && (count_items(**truncated, items) == adexml::Error::DECOMPRESSION_ERROR));
+
+	// open_source() detects the codec from the file.
+	const auto path = std::filesystem::temp_directory_path() / "adexml_source_test.xml.gz";
+	std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(gzip.data()), gzip.size());
+	auto file = adexml::open_source(path);
+	CHECK(file && !count_items(**file, items));
+	CHECK(items == 2000);
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+}
+
+void
+test_file_errors()
+{
+	CHECK(!adexml::open_source(std::filesystem::temp_directory_path() / "adexml_source_test_missing.xml"));
+	CHECK(!adexml::FileSource::open(std::filesystem::temp_directory_path() / "adexml_source_test_missing.xml"));
+}
+
+} // namespace
+
+int
+main()
+{
+	test_memory_source();
+	test_detect_codec();
+	test_gzip();
+	test_file_errors();
+	return adexml::test::check_result();
+}
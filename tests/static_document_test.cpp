@@ -0,0 +1,82 @@
+//=============================================================================
+//	FILE:					static_document_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::parse_static()
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Well formed literals are checked with static_assert, so this file
+//		failing to compile is a test failure. Malformed literals cannot be
+//		passed to parse_static() without stopping the compile, so they are
+//		checked through measure_literal() at run time instead.
+//=============================================================================
+#include "adexml/static_document.h"
+#include "check.h"
+
+namespace
+{
+
+constexpr auto config = adexml::parse_static<u8R"(<?xml version="1.0"?>
+<!-- settings -->
+<config version="2">
+	<server host="localhost" port="8080"/>
+	<server host="backup" port="8081"/>
+	<name>  A &amp; B &#x41;&#66;</name>
+	<empty/>
+</config>)">();
+
+static_assert(config.element_count() == 5);
+static_assert(config.root().name() == u8"config");
+static_assert(config.root().attribute(u8"version") == u8"2");
+static_assert(!config.root().has_attribute(u8"missing"));
+static_assert(config.find(u8"config/server").attribute(u8"port") == u8"8080");
+static_assert(config.find(u8"config/server").next_sibling(u8"server").attribute(u8"host") == u8"backup");
+static_assert(config.find(u8"config/name").content() == u8"A & B AB");
+static_assert(config.find(u8"config/empty").content().empty());
+static_assert(config.find(u8"config/empty").parent().name() == u8"config");
+static_assert(!config.find(u8"config/missing"));
+static_assert(!config.find(u8"config/missing/child").parent());
+
+constexpr auto prefixed = adexml::parse_static<u8"<ns:a xmlns:ns='urn:x' b=\"'\"><ns:c/></ns:a>">();
+
+static_assert(prefixed.root().name() == u8"ns:a");
+static_assert(prefixed.root().attribute_count() == 2);
+static_assert(prefixed.root().attribute_name(1) == u8"b");
+static_assert(prefixed.root().attribute_value(1) == u8"'");
+static_assert(prefixed.root().child(u8"ns:c"));
+
+constexpr adexml::Error
+literal_error(std::u8string_view xml)
+{
+	return adexml::measure_literal(xml).error;
+}
+
+void
+test_malformed_literals()
+{
+	using adexml::Error;
+
+	CHECK(literal_error(u8"<a></b>") 									== Error::ELEMENT_TAG_MISMATCH);
+	CHECK(adexml::measure_literal(u8"<a></b>").error_offset 	== 6);
+	CHECK(literal_error(u8"<a>") 											== Error::INCOMPLETE_DOCUMENT);
+	CHECK(literal_error(u8"") 												== Error::INCOMPLETE_DOCUMENT);
+	CHECK(literal_error(u8"<a>&nope;</a>") 						== Error::UNKNOWN_ENTITY);
+	CHECK(literal_error(u8"<a x='1' x='2'/>") 				== Error::ATTRIBUTE_DUPLICATE_NAME);
+	CHECK(literal_error(u8"<a x='<'/>") 							!= Error::NONE);
+	CHECK(literal_error(u8"<1a/>") 										!= Error::NONE);
+	CHECK(literal_error(u8"<!DOCTYPE a><a/>") 				!= Error::NONE);
+	CHECK(literal_error(u8"<a/><b/>") 								== Error::NONE);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_malformed_literals();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,91 @@
+//=============================================================================
+//	FILE:					stats_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for Parser::stats() and the stats hook
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		The checks depend on ADEXML_ENABLE_STATS. Without it the parser must
+//		report nothing at all; with it the counters must match the document.
+//=============================================================================
+#include <string>
+#include "adexml/xml_parser.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+using Stats = adexml::Parser::Stats;
+
+std::string
+make_document()
+{
+	std::string document = "<root>";
+	for(int i = 0; i < 100; ++i)
+		document += "<item n=\"" + std::to_string(i) + "\"><leaf>text &amp; more</leaf></item>";
+	return document + "</root>";
+}
+
+void
+test_counters()
+{
+	const auto document = make_document();
+
+	int 						hook_calls = 0;
+	adexml::Parser	parser(adexml::Parser::Callback{});
+	parser.set_stats_hook([&](const Stats &) {++hook_calls;}, 1024);
+	CHECK(!parser.write(u8(document)));
+	CHECK(!parser.finish());
+
+	const auto stats = parser.stats();
+	if constexpr (adexml::Parser::STATS_ENABLED)
+	{
+		CHECK(stats.bytes == document.size());
+		CHECK(stats.code_points == document.size());
+		CHECK(stats.events[adexml::Parser::ACTION_START_ELEMENT] == 201);
+		CHECK(stats.events[adexml::Parser::ACTION_END_ELEMENT] == 201);
+		CHECK(stats.max_depth == 3);
+		CHECK(stats.max_content_bytes == 11);
+		CHECK(stats.max_attribute_value_bytes == 2);
+		CHECK(stats.allocations > 0);
+		CHECK(hook_calls >= static_cast<int>(document.size() / 1024) - 1);
+
+		// Counters accumulate across reset() until reset_stats().
+		parser.reset();
+		CHECK(!parser.write(u8(document)));
+		CHECK(parser.stats().bytes == 2 * document.size());
+		parser.reset_stats();
+		CHECK(parser.stats().bytes == 0);
+	}
+	else
+	{
+		CHECK(stats.bytes == 0 && stats.code_points == 0);
+		CHECK(stats.events[adexml::Parser::ACTION_START_ELEMENT] == 0);
+		CHECK(stats.allocations == 0 && stats.max_depth == 0);
+		CHECK(stats.parser_ns() == 0 && stats.callback_ns() == 0);
+		CHECK(hook_calls == 0);
+	}
+}
+
+void
+test_group_names()
+{
+	CHECK(Stats::group_name(Stats::GROUP_CONTENT) == "content");
+	CHECK(Stats::group_name(Stats::GROUP_CALLBACK) == "callback");
+	CHECK(Stats::group_name(Stats::GROUP_COUNT) == "unknown");
+}
+
+} // namespace
+
+int
+main()
+{
+	test_counters();
+	test_group_names();
+	return adexml::test::check_result();
+}
@@ -0,0 +1,177 @@
+//=============================================================================
+//	FILE:					tape_test.cpp
+//	SYSTEM:
+//	DESCRIPTION:	Tests for adexml::TapeRecorder, Tape and TapePlayer
+//-----------------------------------------------------------------------------
+//  COPYRIGHT:		(C) Copyright 2024 Adrian Purser. All Rights Reserved.
+//	LICENCE:			MIT - See LICENSE file for details
+//	MAINTAINER:		Adrian Purser <ade@adrianpurser.co.uk>
+//	CREATED:			18-OCT-2026 Adrian Purser <ade@adrianpurser.co.uk>
+//=============================================================================
+//	NOTES:
+//		Replay is compared with the live parse through a log of everything a
+//		callback can see, except ancestors' content, which a tape only has at
+//		each element's END event.
+//=============================================================================
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "adexml/tape.h"
+#include "check.h"
+
+namespace
+{
+
+using adexml::test::u8;
+
+constexpr std::string_view DOCUMENT =
+	"<?xml version=\"1.0\"?>"
+	"<catalog xmlns:x=\"urn:x\">"
+		"<x:item id=\"1\" kind=\"a\">first</x:item>"
+		"<?target key=\"value\"?>"
+		"<item id=\"2\"><part/><part n=\"2\">p</part></item>"
+		"<item id=\"3\" kind=\"a\">third</item>"
+	"</catalog>";
+
+struct Log
+{
+	std::u8string		text;
+
+	adexml::Parser::Callback
+	callback()
+	{
+		return [this](auto action, auto & path, auto & stack) -> std::error_code
+			{
+				const auto & element = stack.back();
+				text.push_back(static_cast<char8_t>(u8'0' + action));
+				text.append(path).append(u8" ").append(element.name_space).append(u8":").append(element.name);
+				text.push_back(element.b_closed ? u8'/' : u8' ');
+				text.push_back(static_cast<char8_t>(u8'0' + stack.size()));
+
+				std::vector<std::u8string> attributes;
+				for(auto & [name, value] : element.attributes)
+					attributes.push_back(std::u8string(name) + u8"=" + std::u8string(value));
+				std::ranges::sort(attributes);
+				for(auto & attribute : attributes)
+					text.append(u8" ").append(attribute);
+
+				if(action == adexml::Parser::ACTION_END_ELEMENT)
+					text.append(u8" [").append(element.content).append(u8"]");
+				text.push_back(u8'\n');
+				return {};
+			};
+	}
+};
+
+std::u8string
+live_log()
+{
+	Log							log;
+	adexml::Parser	parser(log.callback());
+	CHECK(!parser.write(u8(DOCUMENT)));
+	CHECK(!parser.finish());
+	return log.text;
+}
+
+adexml::Tape
+record()
+{
+	adexml::TapeRecorder	recorder;
+	adexml::Parser				parser(recorder.callback());
+	CHECK(!parser.write(u8(DOCUMENT)));
+	CHECK(!parser.finish());
+	return recorder.take();
+}
+
+void
+test_replay_matches_parse()
+{
+	const auto expected = live_log();
+	const auto tape 		= record();
+	CHECK(!tape.empty());
+	CHECK(tape.event_count() == static_cast<std::uint64_t>(std::ranges::count(expected, u8'\n')));
+
+	// Repeated names and values are pooled once.
+	CHECK(tape.string_count() < 20);
+
+	Log replayed;
+	CHECK(!tape.replay(replayed.callback()));
+	CHECK(replayed.text == expected);
+
+	adexml::TapePlayer	player;
+	Log 								first, second;
+	CHECK(!player.play(tape, first.callback()));
+	CHECK(!player.play(tape, second.callback()));
+	CHECK(first.text == expected && second.text == expected);
+}
+
+void
+test_split_tapes()
+{
+	const auto input = u8(DOCUMENT);
+	const auto split = input.find(u8"<part n");
+
+	adexml::TapeRecorder	recorder;
+	adexml::Parser				parser(recorder.callback());
+	CHECK(!parser.write(input.substr(0, split)));
+	auto head = recorder.take();
+	CHECK(recorder.event_count() == 0);
+	CHECK(!parser.write(input.substr(split)));
+	auto tail = recorder.take();
+
+	// The tail starts inside <catalog><item>, which it records as context.
+	Log log;
+	CHECK(!head.replay(log.callback()));
+	CHECK(!tail.replay(log.callback()));
+	CHECK(log.text == live_log());
+}
+
+void
+test_save_and_open()
+{
+	const auto path = std::filesystem::temp_directory_path() / "adexml_tape_test.tape";
+	const auto tape = record();
+	CHECK(!tape.save(path));
+
+	auto opened = adexml::Tape::open(path);
+	CHECK(opened.has_value());
+	if(opened)
+	{
+		CHECK(opened->event_count() == tape.event_count());
+		CHECK(opened->size_bytes() == tape.size_bytes());
+		Log log;
+		CHECK(!opened->replay(log.callback()));
+		CHECK(log.text == live_log());
+	}
+
+	std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a tape";
+	CHECK(adexml::Tape::open(path).error() == adexml::Error::INVALID_TAPE);
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+}
+
+void
+test_callback_error_stops_replay()
+{
+	int events = 0;
+	const auto ec = record().replay([&](auto, auto &, auto &) -> std::error_code
+		{
+			return (++events == 3) ? adexml::Error::FAILED : std::error_code{};
+		});
+	CHECK(ec == adexml::Error::FAILED);
+	CHECK(events == 3);
+}
+
+} // namespace
+
+int
+main()
+{
+	test_replay_matches_parse();
+	test_split_tapes();
+	test_save_and_open();
+	test_callback_error_stops_replay();
+	return adexml::test::check_result();
+}